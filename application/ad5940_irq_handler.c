@@ -2,7 +2,113 @@
 
 #include "ad5940_utils.h"
 
-AD5940Err AD5940_irq_handler(
+#include <string.h>
+
+#define WUPT_TIME_MAX 0xFFFFF     // 20-bit wakeup timer periods.
+
+/**
+ * @brief Selects the device of a monitor, NULL keeps the selected one.
+ */
+static AD5940Err _select_device(
+    AD5940_DEVICE *const device
+)
+{
+    if(device == NULL) return AD5940ERR_OK;
+    return AD5940_DEVICE_select(device);
+}
+
+/* Wakeup timer periods of each sequence: wakeup low and high, sleep low and high */
+static const uint32_t _wupt_registers[4][4] = {
+    {REG_WUPTMR_SEQ0WUPL, REG_WUPTMR_SEQ0WUPH, REG_WUPTMR_SEQ0SLEEPL, REG_WUPTMR_SEQ0SLEEPH},
+    {REG_WUPTMR_SEQ1WUPL, REG_WUPTMR_SEQ1WUPH, REG_WUPTMR_SEQ1SLEEPL, REG_WUPTMR_SEQ1SLEEPH},
+    {REG_WUPTMR_SEQ2WUPL, REG_WUPTMR_SEQ2WUPH, REG_WUPTMR_SEQ2SLEEPL, REG_WUPTMR_SEQ2SLEEPH},
+    {REG_WUPTMR_SEQ3WUPL, REG_WUPTMR_SEQ3WUPH, REG_WUPTMR_SEQ3SLEEPL, REG_WUPTMR_SEQ3SLEEPH},
+};
+
+static uint32_t _read_wupt_time(
+    const uint32_t register_low,
+    const uint32_t register_high
+)
+{
+    return (AD5940_ReadReg(register_low) & 0xFFFF) | ((AD5940_ReadReg(register_high) & 0xF) << 16);
+}
+
+static uint32_t _double_wupt_time(
+    const uint32_t time
+)
+{
+    // The timer counts time + 1 LFOSC periods.
+    const uint32_t doubled = 2 * (time + 1) - 1;
+    return (doubled < WUPT_TIME_MAX) ? doubled : WUPT_TIME_MAX;
+}
+
+static void _slow_wakeup_timer(void)
+{
+    for(uint8_t i=0; i<4; i++)
+    {
+        const uint32_t wakeup_time = _read_wupt_time(_wupt_registers[i][0], _wupt_registers[i][1]);
+        const uint32_t sleep_time = _read_wupt_time(_wupt_registers[i][2], _wupt_registers[i][3]);
+        AD5940_WUPTTime(SEQID_0 + i, _double_wupt_time(sleep_time), _double_wupt_time(wakeup_time));
+    }
+}
+
+static void _update_expected_sample_count(
+    AD5940_IRQ_MONITOR *const monitor
+)
+{
+    const AD5940_IRQ_MONITOR_CONFIG *const config = &monitor->config;
+    if((config->sample_rate <= 0) || (config->get_time_us == NULL)) return;
+
+    const uint32_t time = config->get_time_us();
+    if(monitor->paused == bFALSE)
+    {
+        /* Unsigned, right across one wrap around. Each slowdown halves the data rate */
+        const float elapsed = (float)(time - monitor->time) * 1e-6f;
+        monitor->expected_sample_count += elapsed * config->sample_rate / (float)(1u << monitor->slowdown);
+    }
+    monitor->time = time;
+}
+
+static void _apply_backpressure(
+    AD5940_IRQ_MONITOR *const monitor
+)
+{
+    const AD5940_IRQ_MONITOR_CONFIG *const config = &monitor->config;
+
+    switch (config->backpressure)
+    {
+    case AD5940_IRQ_BACKPRESSURE_RAISE_THRESHOLD:
+    {
+        const uint32_t doubled = 2 * (uint32_t) monitor->fifo_thresh;
+        const uint16_t fifo_thresh = (doubled < config->fifo_thresh_max) ? (uint16_t) doubled : config->fifo_thresh_max;
+        if(fifo_thresh <= monitor->fifo_thresh) return;
+        monitor->fifo_thresh = fifo_thresh;
+        AD5940_FIFOThrshSet(fifo_thresh);
+        break;
+    }
+
+    case AD5940_IRQ_BACKPRESSURE_SLOW_WAKEUP:
+        if(monitor->slowdown >= config->slowdown_max) return;
+        _update_expected_sample_count(monitor);    /* Account for the time at the former rate */
+        _slow_wakeup_timer();
+        monitor->slowdown++;
+        break;
+
+    case AD5940_IRQ_BACKPRESSURE_PAUSE:
+        if(monitor->paused == bTRUE) return;
+        _update_expected_sample_count(monitor);
+        AD5940_WUPTCtrl(bFALSE);
+        monitor->paused = bTRUE;
+        break;
+
+    default:
+        return;
+    }
+
+    monitor->report.backpressure_count++;
+}
+
+static AD5940Err _irq_handler(
     const int32_t new_fifo_thresh,
     const uint16_t buffer_max_length,
     uint32_t* buffer, 
@@ -10,19 +116,28 @@ AD5940Err AD5940_irq_handler(
 )
 {
     /* Wakeup AFE by read register, read 10 times at most */
-    if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
+    AD5940_METRICS_BEGIN(wakeup_begin);
+    const uint32_t wakeup_try_number = AD5940_WakeUp(10);
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_IRQ_WAKEUP, wakeup_begin);
+    AD5940_METRICS_WAKEUP(wakeup_try_number, 10);
+    if(wakeup_try_number > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
 
     AD5940_SleepKeyCtrlS(SLPKEY_LOCK);  /* We need time to read data from FIFO, so, do not let AD5940 goes to hibernate automatically */
 
+    AD5940_METRICS_BEGIN(fifo_count_begin);
     *buffer_length = AD5940_FIFOGetCnt();
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_IRQ_FIFO_COUNT, fifo_count_begin);
     if(*buffer_length > buffer_max_length) return AD5940ERR_BUFF;
+    AD5940_METRICS_BEGIN(fifo_read_begin);
     AD5940_FIFORd(buffer, *buffer_length);
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_IRQ_FIFO_READ, fifo_read_begin);
 
     // Refer to page 107 of the datasheet
     // Enable AFE to enter sleep mode.
+    AD5940_METRICS_BEGIN(epilogue_begin);
     AD5940_SleepKeyCtrlS(SLPKEY_UNLOCK); /* Unlock so sequencer can put AD5940 to sleep */
 
-    AD5940_INTCClrFlag(AFEINTSRC_DATAFIFOTHRESH);
+    AD5940_INTCClrFlag(AFEINTSRC_DATAFIFOTHRESH | AD5940_FIFO_ERROR_INTSRC);
     if(new_fifo_thresh == 0)
     {
         AD5940_shutdown_afe_lploop_hsloop_dsp();
@@ -35,6 +150,200 @@ AD5940Err AD5940_irq_handler(
             AD5940_FIFOThrshSet(new_fifo_thresh);
         }
     }
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_IRQ_EPILOGUE, epilogue_begin);
 
     return AD5940ERR_OK;
 }
+
+AD5940Err AD5940_irq_handler(
+    const int32_t new_fifo_thresh,
+    const uint16_t buffer_max_length,
+    uint32_t* buffer, 
+    uint16_t* buffer_length
+)
+{
+    AD5940_METRICS_BEGIN(begin);
+    const AD5940Err error = _irq_handler(
+        new_fifo_thresh,
+        buffer_max_length,
+        buffer,
+        buffer_length
+    );
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_IRQ, begin);
+    AD5940_METRICS_IRQ((error == AD5940ERR_OK) ? *buffer_length : 0, error);
+
+    return error;
+}
+
+AD5940Err AD5940_irq_handler_device(
+    AD5940_DEVICE *const device,
+    const int32_t new_fifo_thresh,
+    const uint16_t buffer_max_length,
+    uint32_t* buffer, 
+    uint16_t* buffer_length
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_DEVICE_select(device);
+    if(error) return error;
+
+    return AD5940_irq_handler(
+        new_fifo_thresh,
+        buffer_max_length,
+        buffer,
+        buffer_length
+    );
+}
+
+AD5940Err AD5940_IRQ_MONITOR_init(
+    AD5940_IRQ_MONITOR *const monitor,
+    AD5940_DEVICE *const device,
+    const AD5940_IRQ_MONITOR_CONFIG *const config,
+    const uint16_t fifo_thresh
+)
+{
+    if(config->backpressure > AD5940_IRQ_BACKPRESSURE_PAUSE) return AD5940ERR_PARA;
+    if(config->sample_rate < 0) return AD5940ERR_PARA;
+    if((config->sample_rate > 0) && (config->get_time_us == NULL)) return AD5940ERR_PARA;
+    if((config->backpressure == AD5940_IRQ_BACKPRESSURE_RAISE_THRESHOLD) && (config->fifo_thresh_max < fifo_thresh)) return AD5940ERR_PARA;
+    if(config->slowdown_max > 8) return AD5940ERR_PARA;    /* 256 times slower, beyond the 20-bit periods */
+
+    memset(monitor, 0, sizeof(AD5940_IRQ_MONITOR));
+    monitor->device = device;
+    memcpy(&monitor->config, config, sizeof(AD5940_IRQ_MONITOR_CONFIG));
+    monitor->fifo_thresh = fifo_thresh;
+    monitor->paused = bFALSE;
+    if(config->get_time_us != NULL) monitor->time = config->get_time_us();
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_IRQ_MONITOR_resume(
+    AD5940_IRQ_MONITOR *const monitor
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    if(monitor->paused == bFALSE) return AD5940ERR_OK;
+
+    error = _select_device(monitor->device);
+    if(error) return error;
+
+    if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
+    AD5940_WUPTCtrl(bTRUE);
+    monitor->paused = bFALSE;
+    _update_expected_sample_count(monitor);    /* Restart the expected count from now */
+
+    return AD5940ERR_OK;
+}
+
+static AD5940Err _irq_handler_monitor(
+    AD5940_IRQ_MONITOR *const monitor,
+    const int32_t new_fifo_thresh,
+    const uint16_t buffer_max_length,
+    uint32_t* buffer,
+    uint16_t* buffer_length
+)
+{
+    AD5940_IRQ_LOSS_REPORT *const report = &monitor->report;
+
+    *buffer_length = 0;
+    monitor->lost_sample_number = 0;
+
+    /* Wakeup AFE by read register, read 10 times at most */
+    const uint32_t wakeup_try_number = AD5940_WakeUp(10);
+    AD5940_METRICS_WAKEUP(wakeup_try_number, 10);
+    if(wakeup_try_number > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
+
+    AD5940_SleepKeyCtrlS(SLPKEY_LOCK);  /* We need time to read data from FIFO, so, do not let AD5940 goes to hibernate automatically */
+
+    /* The error flags latch on the controllers of the interrupt GPIO, refer to AD5940_FIFO_ERROR_INTSRC */
+    const uint32_t flags = AD5940_INTCGetFlag(AFEINTC_0) | AD5940_INTCGetFlag(AFEINTC_1);
+    const uint16_t fifo_count = (uint16_t) AD5940_FIFOGetCnt();
+
+    /* Read what fits, the rest stays in the FIFO for the next call */
+    *buffer_length = (fifo_count < buffer_max_length) ? fifo_count : buffer_max_length;
+    AD5940_FIFORd(buffer, *buffer_length);
+    monitor->pending = fifo_count - *buffer_length;
+
+    report->irq_count++;
+    report->sample_count += *buffer_length;
+    if(fifo_count > report->fifo_count_max) report->fifo_count_max = fifo_count;
+    if(flags & AFEINTSRC_DATAFIFOOF) report->overflow_count++;
+    if(flags & AFEINTSRC_DATAFIFOUF) report->underflow_count++;
+    if(monitor->pending > 0) report->partial_read_count++;
+
+    _update_expected_sample_count(monitor);
+    if((flags & AFEINTSRC_DATAFIFOOF) && (monitor->config.sample_rate > 0))
+    {
+        /* Everything the run produced so far is read, in the FIFO or already lost */
+        const float produced = (float)(report->sample_count + monitor->pending + report->lost_sample_count);
+        if(monitor->expected_sample_count > produced)
+        {
+            monitor->lost_sample_number = (uint32_t)(monitor->expected_sample_count - produced);
+            report->lost_sample_count += monitor->lost_sample_number;
+        }
+    }
+
+    const uint16_t high_water = monitor->config.high_water;
+    if(
+        (flags & AFEINTSRC_DATAFIFOOF)
+        || (monitor->pending > 0)
+        || ((high_water > 0) && (fifo_count >= high_water))
+    ) _apply_backpressure(monitor);
+
+    // Refer to page 107 of the datasheet
+    // Enable AFE to enter sleep mode.
+    AD5940_SleepKeyCtrlS(SLPKEY_UNLOCK); /* Unlock so sequencer can put AD5940 to sleep */
+
+    AD5940_INTCClrFlag(AFEINTSRC_DATAFIFOTHRESH | AD5940_FIFO_ERROR_INTSRC);
+
+    /* Resetting the FIFO would drop the pending data, it waits for the call that empties it */
+    if(monitor->pending > 0) return AD5940ERR_OK;
+
+    if(new_fifo_thresh == 0)
+    {
+        AD5940_shutdown_afe_lploop_hsloop_dsp();
+    }
+    else
+    {
+        AD5940_reset_fifocon();
+        if(new_fifo_thresh > 0)
+        {
+            /* Keep a threshold raised by the backpressure */
+            if((uint32_t) new_fifo_thresh > monitor->fifo_thresh) monitor->fifo_thresh = (uint16_t) new_fifo_thresh;
+            AD5940_FIFOThrshSet(monitor->fifo_thresh);
+        }
+    }
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_irq_handler_monitor(
+    AD5940_IRQ_MONITOR *const monitor,
+    const int32_t new_fifo_thresh,
+    const uint16_t buffer_max_length,
+    uint32_t* buffer,
+    uint16_t* buffer_length
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    *buffer_length = 0;
+    error = _select_device(monitor->device);
+    if(error) return error;
+
+    AD5940_METRICS_BEGIN(begin);
+    error = _irq_handler_monitor(
+        monitor,
+        new_fifo_thresh,
+        buffer_max_length,
+        buffer,
+        buffer_length
+    );
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_IRQ, begin);
+    AD5940_METRICS_IRQ(*buffer_length, error);
+
+    return error;
+}
@@ -1,4 +1,5 @@
 #include "ad5940.h"
+#include "ad5940_device.h"
 
 /**
  * @brief Handles interrupts during measurement on the AD5940.
@@ -17,6 +18,10 @@
  * 
  * @return AD5940Err Returns an error code of type `AD5940Err`. A value of 0 indicates success, 
  *                   while any other value represents an error encountered during interrupt handling.
+ *
+ * @note
+ * It returns AD5940ERR_BUFF without reading when the FIFO holds more than the MCU buffer,
+ * and does not tell FIFO overflows. Use @ref AD5940_irq_handler_monitor to account for them.
  */
 AD5940Err AD5940_irq_handler(
     const int32_t new_fifo_thresh,
@@ -24,3 +29,149 @@ AD5940Err AD5940_irq_handler(
     uint32_t* buffer, 
     uint16_t* buffer_length
 );
+
+/**
+ * @brief Selects a device and handles its interrupt, see @ref AD5940_irq_handler.
+ *
+ * Call it from the interrupt flag of each device, the other devices keep running their
+ * sequences meanwhile.
+ *
+ * @param device                Device context that raised the interrupt.
+ * @param new_fifo_thresh       See @ref AD5940_irq_handler.
+ * @param buffer_max_length     See @ref AD5940_irq_handler.
+ * @param buffer                See @ref AD5940_irq_handler.
+ * @param buffer_length         See @ref AD5940_irq_handler.
+ * 
+ * @return AD5940Err Returns an error code of type `AD5940Err`. A value of 0 indicates success, 
+ *                   while any other value represents an error encountered during interrupt handling.
+ */
+AD5940Err AD5940_irq_handler_device(
+    AD5940_DEVICE *const device,
+    const int32_t new_fifo_thresh,
+    const uint16_t buffer_max_length,
+    uint32_t* buffer, 
+    uint16_t* buffer_length
+);
+
+/**
+ * @brief Action taken by @ref AD5940_irq_handler_monitor when the MCU falls behind the FIFO.
+ */
+typedef enum
+{
+    AD5940_IRQ_BACKPRESSURE_NONE = 0,           /**< Only account for the losses. */
+    AD5940_IRQ_BACKPRESSURE_RAISE_THRESHOLD,    /**< Double the FIFO threshold, up to `fifo_thresh_max`: fewer and longer interrupts for the same data. */
+    AD5940_IRQ_BACKPRESSURE_SLOW_WAKEUP,        /**< Double the wakeup timer periods, up to `slowdown_max` times: half the data rate. */
+    AD5940_IRQ_BACKPRESSURE_PAUSE,              /**< Stop the wakeup timer until @ref AD5940_IRQ_MONITOR_resume. */
+}
+AD5940_IRQ_BACKPRESSURE;
+
+/**
+ * @brief Configuration of an interrupt monitor.
+ *
+ * @warning
+ * AD5940_IRQ_BACKPRESSURE_SLOW_WAKEUP and AD5940_IRQ_BACKPRESSURE_PAUSE change the timing of the
+ * measurement: the interval of CA, the scan rate of the waveform techniques. Keep them for runs
+ * where the data matter more than their timing, the lost samples are then avoided instead of counted.
+ */
+typedef struct
+{
+    AD5940_IRQ_BACKPRESSURE backpressure;   /**< Action on a late interrupt. */
+    uint16_t high_water;                    /**< FIFO count telling a late interrupt, e.g. twice the FIFO threshold. 0 to react on overflows and full buffers only. */
+    uint16_t fifo_thresh_max;               /**< Largest FIFO threshold set by AD5940_IRQ_BACKPRESSURE_RAISE_THRESHOLD, at most the FIFO size and the MCU buffer, and below the FIFO data left at the end of the run. */
+    uint8_t slowdown_max;                   /**< Most doublings of the wakeup timer periods by AD5940_IRQ_BACKPRESSURE_SLOW_WAKEUP. */
+    float sample_rate;                      /**< FIFO data per second, e.g. the `sample_rate` of the plan. 0 when unknown, the lost samples are then not estimated. */
+    uint32_t (*get_time_us)(void);          /**< Free running microsecond counter, needed with `sample_rate`. */
+}
+AD5940_IRQ_MONITOR_CONFIG;
+
+/**
+ * @brief Losses of a run, accounted by @ref AD5940_irq_handler_monitor.
+ */
+typedef struct
+{
+    uint32_t irq_count;                     /**< Interrupts served. */
+    uint32_t sample_count;                  /**< FIFO data read. */
+    uint32_t overflow_count;                /**< Interrupts that found the FIFO overflowed, the sequencer stopped until the FIFO was read. */
+    uint32_t underflow_count;               /**< Interrupts that found the FIFO underflowed, some FIFO data read were not valid. */
+    uint32_t partial_read_count;            /**< Interrupts that found more FIFO data than the MCU buffer. */
+    uint32_t lost_sample_count;             /**< Estimated FIFO data lost to the overflows, 0 without `sample_rate`. */
+    uint16_t fifo_count_max;                /**< Largest FIFO count found, the margin left before an overflow. */
+    uint32_t backpressure_count;            /**< Backpressure actions taken. */
+}
+AD5940_IRQ_LOSS_REPORT;
+
+/**
+ * @brief Interrupt monitor of a run.
+ */
+typedef struct
+{
+    AD5940_DEVICE *device;                  /**< Device of the run, or NULL for the selected one. */
+    AD5940_IRQ_MONITOR_CONFIG config;       /**< Configuration. */
+    AD5940_IRQ_LOSS_REPORT report;          /**< Losses since @ref AD5940_IRQ_MONITOR_init. */
+    uint16_t pending;                       /**< FIFO data left on the AD5940 by the last interrupt, read them with another call. */
+    uint32_t lost_sample_number;            /**< Estimated FIFO data lost after the data read by the last interrupt. */
+    uint16_t fifo_thresh;                   /**< Current FIFO threshold. */
+    uint8_t slowdown;                       /**< Doublings of the wakeup timer periods applied. */
+    BoolFlag paused;                        /**< bTRUE while the wakeup timer is stopped by AD5940_IRQ_BACKPRESSURE_PAUSE. */
+    float expected_sample_count;            /**< FIFO data the run should have produced so far. */
+    uint32_t time;                          /**< Time of the last update of `expected_sample_count`, in microseconds. */
+}
+AD5940_IRQ_MONITOR;
+
+/**
+ * @brief Starts monitoring a run. Call it right before the `*_start` function of the technique.
+ *
+ * @param monitor               Interrupt monitor.
+ * @param device                Device of the run, selected by every call on the monitor,
+ *                              or NULL for the selected device (single AD5940).
+ * @param config                Configuration, copied.
+ * @param fifo_thresh           FIFO threshold of the run configuration.
+ *
+ * @return AD5940Err Returns AD5940ERR_PARA if the configuration is not valid.
+ */
+AD5940Err AD5940_IRQ_MONITOR_init(
+    AD5940_IRQ_MONITOR *const monitor,
+    AD5940_DEVICE *const device,
+    const AD5940_IRQ_MONITOR_CONFIG *const config,
+    const uint16_t fifo_thresh
+);
+
+/**
+ * @brief Restarts the wakeup timer stopped by AD5940_IRQ_BACKPRESSURE_PAUSE, once the MCU caught up.
+ *
+ * @param monitor               Interrupt monitor.
+ *
+ * @return AD5940Err Returns an error code of type `AD5940Err`. A value of 0 indicates success.
+ */
+AD5940Err AD5940_IRQ_MONITOR_resume(
+    AD5940_IRQ_MONITOR *const monitor
+);
+
+/**
+ * @brief Handles an interrupt like @ref AD5940_irq_handler, and accounts for the losses.
+ *
+ * The FIFO overflow and underflow flags, enabled by the techniques, are read and cleared.
+ * When the FIFO holds more than the MCU buffer, the buffer is filled and the rest stays on
+ * the AD5940: `monitor->pending` tells how many, call it again to read them before anything
+ * else. The FIFO is only reset, and the new threshold or the shutdown only applied, once empty.
+ * After an overflow, `monitor->lost_sample_number` estimates the FIFO data the stopped sequencer
+ * did not produce. They follow the data read by this call, refer to @ref AD5940_STREAM_skip_samples,
+ * and to @ref AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_resynchronize for an electrode scan.
+ * A late interrupt (overflow, full buffer or `high_water` reached) triggers the backpressure action.
+ *
+ * @param monitor               Interrupt monitor.
+ * @param new_fifo_thresh       See @ref AD5940_irq_handler. A threshold raised by the backpressure is kept if larger.
+ * @param buffer_max_length     See @ref AD5940_irq_handler.
+ * @param buffer                See @ref AD5940_irq_handler.
+ * @param buffer_length         Pointer to store the number of FIFO data read.
+ *
+ * @return AD5940Err Returns an error code of type `AD5940Err`. A value of 0 indicates success,
+ *                   while any other value represents an error encountered during interrupt handling.
+ */
+AD5940Err AD5940_irq_handler_monitor(
+    AD5940_IRQ_MONITOR *const monitor,
+    const int32_t new_fifo_thresh,
+    const uint16_t buffer_max_length,
+    uint32_t* buffer,
+    uint16_t* buffer_length
+);
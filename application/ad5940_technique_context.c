@@ -0,0 +1,57 @@
+#include "ad5940_technique_context.h"
+
+#include <string.h>
+
+#include "ad5940_electrochemical_utils_temperature.h"
+
+static AD5940_TECHNIQUE_CONTEXT _default_context;
+static BoolFlag _default_context_ready = bFALSE;
+
+static void _clear(
+    AD5940_TECHNIQUE_CONTEXT *const context
+)
+{
+    memset(context, 0, sizeof(AD5940_TECHNIQUE_CONTEXT));
+    context->sop.ADC_seq_info.SeqId = SEQID_0;
+    context->sop.ADC_seq_info.WriteSRAM = bTRUE;
+    context->electrochemical_temperature_seq_info.SeqId = AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID;
+    context->electrochemical_temperature_seq_info.WriteSRAM = bTRUE;
+    context->temperature_seq_info.SeqId = SEQID_0;          // use SEQ0 to run this sequence
+    context->temperature_seq_info.WriteSRAM = bTRUE;        // we need to write this sequence to AD5940 SRAM.
+}
+
+AD5940Err AD5940_TECHNIQUE_CONTEXT_init(
+    AD5940_TECHNIQUE_CONTEXT *const context,
+    AD5940_DEVICE *const device
+)
+{
+    if(context == NULL) return AD5940ERR_PARA;
+
+    _clear(context);
+    if(device != NULL) device->technique = context;
+
+    return AD5940ERR_OK;
+}
+
+AD5940_TECHNIQUE_CONTEXT *AD5940_TECHNIQUE_CONTEXT_get(void)
+{
+    AD5940_DEVICE *const device = AD5940_DEVICE_get_selected();
+    if((device != NULL) && (device->technique != NULL)) return device->technique;
+
+    if(_default_context_ready == bFALSE)
+    {
+        _clear(&_default_context);
+        _default_context_ready = bTRUE;
+    }
+    return &_default_context;
+}
+
+AD5940Err AD5940_TECHNIQUE_CONTEXT_select(
+    AD5940_DEVICE *const device
+)
+{
+    if(device == NULL) return AD5940ERR_OK;
+    if(device->technique == NULL) return AD5940ERR_PARA;
+
+    return AD5940_DEVICE_select(device);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_device.h"
+#include "ad5940_electrochemical_utils_sop.h"
+#include "ad5940_electrochemical_utils_reconfigure.h"
+
+/**
+ * @brief Technique state of one AD5940.
+ *
+ * The sequences written by a `*_start` stay in the SRAM of the device and keep running after
+ * the start returns, so their sequence information, the SRAM layout and the recorded
+ * configuration of the reconfiguration belong to the device. Attach one context per device
+ * with @ref AD5940_TECHNIQUE_CONTEXT_init, the techniques then use the context of the
+ * selected device. Without any device selected, they use a default context, as for a single AD5940.
+ */
+typedef struct AD5940_TECHNIQUE_CONTEXT
+{
+    AD5940_ELECTROCHEMICAL_SOP_STATE sop;                       // ADC sequence and SRAM layout.
+    SEQInfo_Type electrochemical_temperature_seq_info;          // Interleaved temperature sequence.
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE reconfigure;       // Configuration and sequences known to be written.
+    SEQInfo_Type temperature_seq_info;                          // Sequence of the temperature application.
+}
+AD5940_TECHNIQUE_CONTEXT;
+
+/**
+ * @brief Clears a technique context and attaches it to a device.
+ *
+ * @param context   Technique context, it must live as long as the device.
+ * @param device    Device context, or NULL to only clear the context.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_TECHNIQUE_CONTEXT_init(
+    AD5940_TECHNIQUE_CONTEXT *const context,
+    AD5940_DEVICE *const device
+);
+
+/**
+ * @brief Gets the technique context of the selected device.
+ *
+ * @return AD5940_TECHNIQUE_CONTEXT* Context of the selected device, or the default context
+ *                                   when no device is selected or it has none.
+ */
+AD5940_TECHNIQUE_CONTEXT *AD5940_TECHNIQUE_CONTEXT_get(void);
+
+/**
+ * @brief Selects the device of a `*_start`, see @ref AD5940_DEVICE_select.
+ *
+ * @param device    Device context with a technique context, or NULL to keep the current selection
+ *                  (single AD5940, or device selected by the caller).
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ *                   AD5940ERR_PARA when the device has no technique context.
+ */
+AD5940Err AD5940_TECHNIQUE_CONTEXT_select(
+    AD5940_DEVICE *const device
+);
+
+#ifdef __cplusplus
+}
+#endif
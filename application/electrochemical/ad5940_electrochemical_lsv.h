@@ -0,0 +1,12 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940_electrochemical_lsv_function.h"
+
+#ifdef __cplusplus
+}
+#endif
@@ -2,6 +2,7 @@
 
 #include "ad5940_utils.h"
 #include "ad5940_electrochemical_utils.h"
+#include "ad5940_technique_context.h"
 
 static AD5940Err _write_sequence_commands(
     const AD5940_ClockConfig *const clock_cfg,
@@ -10,7 +11,9 @@ static AD5940Err _write_sequence_commands(
     const uint32_t ADCSinc2Osr,
     const uint32_t ADCSinc3Osr,
     const BoolFlag BpNotch,
-    const uint32_t DataType
+    const uint32_t DataType,
+    const AD5940_ELECTROCHEMICAL_ENERGY_MODE energy_mode,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan
 )
 {
     AD5940Err error = AD5940ERR_OK;
@@ -26,6 +29,9 @@ static AD5940Err _write_sequence_commands(
         BpNotch,
         1,
         DataType,
+        NULL,
+        energy_mode,
+        electrode_scan,
         &sequence_address
     );
     if(error != AD5940ERR_OK) return AD5940ERR_PARA;
@@ -33,13 +39,95 @@ static AD5940Err _write_sequence_commands(
     return AD5940ERR_OK;
 }
 
+/**
+ * @brief Writes the temperature sequence after the ADC sequence.
+ * @details SEQID_1 executes the same ADC sequence as SEQID_0, it marks the first ADC wakeup
+ *          after a temperature capture so that the wakeup timer can place the temperature slot
+ *          halfway between two ADC wakeups.
+ */
+static AD5940Err _write_temperature_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    const AD5940_ClockConfig *const clock_cfg,
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg,
+    const uint32_t ADCMuxP,
+    const uint32_t ADCMuxN,
+    const uint32_t DataType
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    uint32_t sequence_commands_length = 0;
+
+    if(temperature->interval == 0) return AD5940ERR_PARA;
+    if(temperature->interval > AD5940_ELECTROCHEMICAL_TEMPERATURE_INTERVAL_MAX) return AD5940ERR_PARA;
+
+    SEQInfo_Type *ADC_seq_info;
+    AD5940_ELECTROCHEMICAL_UTILITY_get_ADC_seq_info(
+        &ADC_seq_info
+    );
+
+    error = AD5940_ELECTROCHEMICAL_TEMPERATURE_write_sequence_commands(
+        temperature,
+        clock_cfg,
+        dsp_cfg,
+        ADCMuxP,
+        ADCMuxN,
+        DataType,
+        ADC_seq_info->SeqRamAddr + ADC_seq_info->SeqLen,
+        &sequence_commands_length
+    );
+    if(error != AD5940ERR_OK) return AD5940ERR_PARA;
+
+    AD5940_write_change_sequence_info_command(
+        SEQID_1,
+        ADC_seq_info->SeqRamAddr,
+        ADC_seq_info->SeqLen
+    );
+
+    return AD5940ERR_OK;
+}
+
+/**
+ * @brief Gets the end of the last sequence in SRAM, the temperature sequence follows the ADC sequence.
+ */
+static uint32_t _get_sequence_end(
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature
+)
+{
+    SEQInfo_Type *seq_info;
+
+    if(temperature != NULL)
+    {
+        AD5940_ELECTROCHEMICAL_TEMPERATURE_get_seq_info(
+            &seq_info
+        );
+    }
+    else
+    {
+        AD5940_ELECTROCHEMICAL_UTILITY_get_ADC_seq_info(
+            &seq_info
+        );
+    }
+
+    return seq_info->SeqRamAddr + seq_info->SeqLen;
+}
+
 static AD5940Err _start_wakeup_timer_sequence(
     const AD5940_ELECTROCHEMICAL_CA_PARAMETERS *parameters,
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
     const uint32_t FifoSrc,
     const uint16_t FifoThresh,
     const float LFOSCClkFreq
 )
 {
+    float t_temperature = 0;
+    if(temperature != NULL)
+    {
+        t_temperature = parameters->t_interval / 2;
+        if((LFOSCClkFreq * t_temperature) < 3) return AD5940ERR_PARA;
+        if((LFOSCClkFreq * (parameters->t_interval - t_temperature)) < 3) return AD5940ERR_PARA;
+    }
+
     /* Configure FIFO and Sequencer for normal Amperometric Measurement */
     AD5940_FIFOThrshSet((uint32_t) FifoThresh);
     AD5940_FIFOCtrlS(FifoSrc, bTRUE);
@@ -54,10 +142,36 @@ static AD5940Err _start_wakeup_timer_sequence(
     /* Configure Wakeup Timer*/
     WUPTCfg_Type wupt_cfg;
     wupt_cfg.WuptEn = bTRUE;
-    wupt_cfg.WuptEndSeq = WUPTENDSEQ_A;
-    wupt_cfg.WuptOrder[0] = ADC_seq_info->SeqId;
-    wupt_cfg.SeqxSleepTime[ADC_seq_info->SeqId] = 1; /* The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock. */
-    wupt_cfg.SeqxWakeupTime[ADC_seq_info->SeqId] = (uint32_t)(LFOSCClkFreq * parameters->t_interval) - 1;
+    if(temperature == NULL)
+    {
+        wupt_cfg.WuptEndSeq = WUPTENDSEQ_A;
+        wupt_cfg.WuptOrder[0] = ADC_seq_info->SeqId;
+        wupt_cfg.SeqxSleepTime[ADC_seq_info->SeqId] = 1; /* The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock. */
+        wupt_cfg.SeqxWakeupTime[ADC_seq_info->SeqId] = (uint32_t)(LFOSCClkFreq * parameters->t_interval) - 1;
+    }
+    else
+    {
+        /**
+         * Slots: SEQID_1, SEQID_0 x (interval - 1), temperature.
+         * SEQID_1 and SEQID_0 run the same ADC sequence. The temperature slot takes half of
+         * the interval after the last ADC wakeup and SEQID_1 the other half,
+         * so the ADC wakeups stay evenly spaced.
+         */
+        wupt_cfg.WuptEndSeq = WUPTENDSEQ_A + temperature->interval;
+        wupt_cfg.WuptOrder[0] = SEQID_1;
+        for(uint8_t i=1; i<temperature->interval; i++)
+        {
+            wupt_cfg.WuptOrder[i] = ADC_seq_info->SeqId;
+        }
+        wupt_cfg.WuptOrder[temperature->interval] = AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID;
+
+        wupt_cfg.SeqxSleepTime[SEQID_1] = 1;
+        wupt_cfg.SeqxWakeupTime[SEQID_1] = (uint32_t)(LFOSCClkFreq * (parameters->t_interval - t_temperature)) - 1;
+        wupt_cfg.SeqxSleepTime[ADC_seq_info->SeqId] = 1;
+        wupt_cfg.SeqxWakeupTime[ADC_seq_info->SeqId] = (uint32_t)(LFOSCClkFreq * parameters->t_interval) - 1;
+        wupt_cfg.SeqxSleepTime[AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID] = 1;
+        wupt_cfg.SeqxWakeupTime[AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID] = (uint32_t)(LFOSCClkFreq * t_temperature) - 1;
+    }
     AD5940_WUPTCfg(&wupt_cfg);
 
     return AD5940ERR_OK;
@@ -67,7 +181,7 @@ static AD5940Err _start_wakeup_timer_sequence(
  * This function is based on the example in the AppCHRONOAMPInit() function found in
  * ad5940-examples/examples/AD5940_ChronoAmperometric/ChronoAmperometric.c.
  */
-AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
+static AD5940Err _start(
     const AD5940_ELECTROCHEMICAL_CA_CONFIG *const config
 )
 {
@@ -76,6 +190,9 @@ AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
     error = AD5940_ELECTROCHEMICAL_CA_PARAMETERS_check(config->parameters);
     if(error != AD5940ERR_OK) return error;
 
+    error = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_check(config->run->electrode_scan, config->path_type);
+    if(error != AD5940ERR_OK) return error;
+
     /* Wakeup AFE by read register, read 10 times at most */
     if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
 
@@ -101,10 +218,25 @@ AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
             config->path.lpdac_to_lptia->dsp_cfg->ADCFilterCfg.ADCSinc2Osr,
             config->path.lpdac_to_lptia->dsp_cfg->ADCFilterCfg.ADCSinc3Osr,
             config->path.lpdac_to_lptia->dsp_cfg->ADCFilterCfg.BpNotch,
-            config->run->DataType
+            config->run->DataType,
+            config->run->energy_mode,
+            config->run->electrode_scan
         );
         if(error != AD5940ERR_OK) return error;
 
+        if(config->run->temperature != NULL)
+        {
+            error = _write_temperature_sequence_commands(
+                config->run->temperature,
+                config->run->clock_cfg,
+                config->path.lpdac_to_lptia->dsp_cfg,
+                ADCMUXP_LPTIA0_P,
+                ADCMUXN_LPTIA0_N,
+                config->run->DataType
+            );
+            if(error != AD5940ERR_OK) return error;
+        }
+
         error = AD5940_ELECTROCHEMICAL_config_lpdac_lptia_adc(
             config->path.lpdac_to_lptia->lpdac_cfg,
             config->path.lpdac_to_lptia->lptia_cfg,
@@ -129,15 +261,33 @@ AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
             config->path.lpdac_to_hstia->dsp_cfg->ADCFilterCfg.ADCSinc2Osr,
             config->path.lpdac_to_hstia->dsp_cfg->ADCFilterCfg.ADCSinc3Osr,
             config->path.lpdac_to_hstia->dsp_cfg->ADCFilterCfg.BpNotch,
-            config->run->DataType
+            config->run->DataType,
+            config->run->energy_mode,
+            config->run->electrode_scan
         );
         if(error != AD5940ERR_OK) return error;
 
+        if(config->run->temperature != NULL)
+        {
+            error = _write_temperature_sequence_commands(
+                config->run->temperature,
+                config->run->clock_cfg,
+                config->path.lpdac_to_hstia->dsp_cfg,
+                ADCMUXP_HSTIA_P,
+                ADCMUXN_HSTIA_N,
+                config->run->DataType
+            );
+            if(error != AD5940ERR_OK) return error;
+        }
+
         error = AD5940_ELECTROCHEMICAL_config_lpdac_hstia_adc(
             config->path.lpdac_to_hstia->lpdac_cfg,
             config->path.lpdac_to_hstia->hstia_cfg,
             config->path.lpdac_to_hstia->dsp_cfg,
-            config->path.lpdac_to_hstia->electrode_routing,
+            AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_routing(
+                config->run->electrode_scan,
+                config->path.lpdac_to_hstia->electrode_routing
+            ),
             config->run->clock_cfg->ADCRate,
             bFALSE
         );
@@ -152,16 +302,24 @@ AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
         return AD5940ERR_PARA;
     }
 
+    error = AD5940_ELECTROCHEMICAL_configure_sram(
+        config->run->sram_partition,
+        _get_sequence_end(config->run->temperature),
+        config->run->FifoThresh
+    );
+    if(error != AD5940ERR_OK) return error;
+
     // Ensure it is cleared as ad5940.c relies on the INTC flag as well.
     AD5940_INTCClrFlag(AFEINTSRC_ALLINT);
 
     AGPIOCfg_Type agpio_cfg;
     memcpy(&agpio_cfg, config->run->agpio_cfg, sizeof(AGPIOCfg_Type));
-    AD5940_set_INTCCfg_by_AGPIOCfg_Type(&agpio_cfg, AFEINTSRC_DATAFIFOTHRESH);
+    AD5940_set_INTCCfg_by_AGPIOCfg_Type(&agpio_cfg, AFEINTSRC_DATAFIFOTHRESH | AD5940_FIFO_ERROR_INTSRC);
     AD5940_AGPIOCfg(&agpio_cfg);
 
     error = _start_wakeup_timer_sequence(
         config->parameters,
+        config->run->temperature,
         config->run->FifoSrc,
         config->run->FifoThresh,
         config->run->LFOSCClkFreq
@@ -170,3 +328,72 @@ AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
 
     return error;
 }
+
+AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_CA_CONFIG *const config
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_TECHNIQUE_CONTEXT_select(device);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_METRICS_BEGIN(begin);
+    error = _start(config);
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_START, begin);
+
+    return error;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_CA_reconfigure(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_CA_CONFIG *const config
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    /* The reconfiguration works on the technique context of the device */
+    error = AD5940_TECHNIQUE_CONTEXT_select(device);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_begin();
+    error = AD5940_ELECTROCHEMICAL_CA_start(NULL, config);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_end();
+
+    return error;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_CA_get_plan(
+    const AD5940_ELECTROCHEMICAL_CA_CONFIG *const config,
+    const float duration,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_CA_PARAMETERS_check(config->parameters);
+    if(error != AD5940ERR_OK) return error;
+    if(config->path_type > 1) return AD5940ERR_PARA;    /* As for the start, hsdac_to_hstia is not supported */
+    if(duration <= 0) return AD5940ERR_PARA;
+
+    memset(plan, 0, sizeof(AD5940_ELECTROCHEMICAL_PLAN));
+    plan->duration = duration;
+
+    /* One ADC wakeup per interval, the temperature wakeups are added in between */
+    error = AD5940_ELECTROCHEMICAL_PLAN_add_captures(
+        plan,
+        config->run,
+        config->path_type,
+        &config->path,
+        NULL,
+        (uint32_t)(duration / config->parameters->t_interval)
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940_ELECTROCHEMICAL_PLAN_complete(
+        plan,
+        config->run,
+        AFEINTSRC_DATAFIFOTHRESH
+    );
+}
@@ -9,6 +9,8 @@ extern "C"
 
 #include "ad5940_electrochemical_utils_loop.h"
 #include "ad5940_electrochemical_utils_run.h"
+#include "ad5940_electrochemical_utils_plan.h"
+#include "ad5940_device.h"
 
 /**
  * @brief Configuration structure for Chronoamperometry (CA).
@@ -28,25 +30,61 @@ typedef struct
     const AD5940_ELECTROCHEMICAL_CA_PARAMETERS *parameters;                         /**< CA parameter settings */
     const AD5940_ELECTROCHEMICAL_RUN_CONFIG *run;                                   /**< Execution and timing configuration */
     uint8_t path_type;                                                              /**< Choose which type of path to use */
-    union {
-        const AD5940_ELECTROCHEMICAL_LPDAC_TO_LPTIA_CONFIG *lpdac_to_lptia;         /**< Configuration for LPDAC to LPTIA path */
-        const AD5940_ELECTROCHEMICAL_LPDAC_TO_HSTIA_CONFIG *lpdac_to_hstia;         /**< Configuration for LPDAC to HSTIA path */
-        const AD5940_ELECTROCHEMICAL_HSDAC_TO_HSTIA_CONFIG *hsdac_to_hstia; /**< Configuration for HSDAC via MMR to HSTIA path */
-    } path;
+    AD5940_ELECTROCHEMICAL_PATH path;                                               /**< Configuration of the selected path */
 } 
 AD5940_ELECTROCHEMICAL_CA_CONFIG;
 
 /**
  * @brief Starts the Chronoamperometry (CA) operation.
  * 
+ * @param device Device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
  * @param config Pointer to the CA configuration structure.
  * 
  * @return AD5940Err Error code indicating success (0) or failure.
  */
 AD5940Err AD5940_ELECTROCHEMICAL_CA_start(
+    AD5940_DEVICE *const device,
     const AD5940_ELECTROCHEMICAL_CA_CONFIG *const config
 );
 
+/**
+ * @brief Starts the CA operation after another technique, writing only what changed.
+ *
+ * Same as @ref AD5940_ELECTROCHEMICAL_CA_start, except that the AFE stays powered and only
+ * the blocks that differ from the previous technique are written.
+ * Refer to @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_begin.
+ *
+ * @param device Device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
+ * @param config Pointer to the CA configuration structure.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_CA_reconfigure(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_CA_CONFIG *const config
+);
+
+/**
+ * @brief Predicts the SRAM footprint, wakeups, FIFO data rate and interrupt rate
+ *        of the CA operation, without any SPI access.
+ *
+ * CA runs until it is stopped, so the duration is given by the caller.
+ *
+ * @param config    Pointer to the CA configuration structure.
+ * @param duration  Intended duration of the operation, in seconds (s).
+ * @param plan      Pointer to store the plan.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_SEQLEN if the sequences don't fit in SRAM, the plan is still filled.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_CA_get_plan(
+    const AD5940_ELECTROCHEMICAL_CA_CONFIG *const config,
+    const float duration,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+);
+
 #ifdef __cplusplus
 }
 #endif
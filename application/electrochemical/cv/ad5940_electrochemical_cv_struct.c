@@ -8,7 +8,10 @@ AD5940Err AD5940_ELECTROCHEMICAL_CV_PARAMETERS_check(
     if(parameters->e_begin < parameters->e_vertex1 && parameters->e_begin < parameters->e_vertex2) return AD5940ERR_PARA;
     if(parameters->e_step <= 0) return AD5940ERR_PARA;
     if(parameters->scan_rate <= 0) return AD5940ERR_PARA;
-    return AD5940ERR_OK;
+    return AD5940_ELECTROCHEMICAL_SAMPLING_check(
+        &parameters->sampling,
+        parameters->e_step / parameters->scan_rate
+    );
 }
 
 AD5940Err AD5940_ELECTROCHEMICAL_CV_get_t_interval(
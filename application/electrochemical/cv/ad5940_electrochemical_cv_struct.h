@@ -19,6 +19,7 @@ typedef struct
     float e_vertex2;           /**< Second vertex potential of the scan, in volts (V). */
     float e_step;              /**< Step potential between measurements, in volts (V). */
     float scan_rate;           /**< Rate of potential change during the scan, in volts per second (V/s). */
+    AD5940_ELECTROCHEMICAL_SAMPLING sampling;  /**< ADC capture points within each step. */
 }
 AD5940_ELECTROCHEMICAL_CV_PARAMETERS;
 
@@ -2,20 +2,10 @@
 
 #include "ad5940_utils.h"
 #include "ad5940_electrochemical_utils.h"
+#include "ad5940_electrochemical_utils_waveform.h"
 
 #include <stdlib.h>
-
-#define DAC_STEP_SEQID SEQID_1
-#define DAC_PULSE_SEQID SEQID_2
-
-static inline float _get_e_step_real(
-    const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *const parameters
-)
-{
-    return (parameters->e_end > parameters->e_begin) 
-        ? parameters->e_step 
-        : -parameters->e_step;
-}
+#include <string.h>
 
 static inline float _get_e_pulse_real(
     const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *const parameters
@@ -38,302 +28,118 @@ static inline float _get_e_pulse_real(
     return 0.0;
 }
 
-#define T_INTERVAL(e_step, scan_rate) (e_step / scan_rate)
-static inline uint16_t STEP_NUMBER(
-    const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *const parameters
-) {
-    float total = fabsf((parameters->e_end - parameters->e_begin) / parameters->e_step);
-    float intpart;
-    modff(total, &intpart);
-    return (uint16_t)(intpart + 1.0f) * 2;
-}
-
-static inline float _get_voltage_at_index(
+static void _get_waveform_segment(
     const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *const parameters,
-    const uint16_t index,
-    const float e_step_real,
-    const float e_pulse_real
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment
 )
 {
-    if(index % 2 == 0) return parameters->e_begin + (e_step_real * floor(((float) index) / 2.0));
-    else return parameters->e_begin + e_pulse_real + (e_step_real * floor(((float) index) / 2.0));
+    memset(segment, 0, sizeof(AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT));
+
+    segment->type = AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE;
+    segment->e_begin = parameters->e_begin;
+    segment->e_end = parameters->e_end;
+    segment->e_step = parameters->e_step;
+    segment->e_offset[0] = 0;
+    segment->e_offset[1] = _get_e_pulse_real(parameters);
 }
 
-/* Geneate sequence(s) to update DAC step by step */
-/* Note: this function doesn't need sequencer generator */
-
-/**
-* @brief Update DAC sequence in SRAM in real time.  
-* @details This function generates sequences to update DAC code step by step. It's also called in interrupt
-*          function when half commands in SRAM has been completed. We don't use sequence generator to save memory.
-*          Check more details from documentation of this example. @ref Ramp_Test_Example
-* @return return error code
-* 
-* */
-static AD5940Err _write_DAC_sequence_commands(
-	const uint32_t start_address, 
-    uint32_t *const sequence_length,
-    const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *const parameters
+AD5940Err AD5940_ELECTROCHEMICAL_DPV_start_begin(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
 )
 {
     AD5940Err error = AD5940ERR_OK;
 
-    error = AD5940_ELECTROCHEMICAL_DPV_PARAMETERS_check(parameters);
+    error = AD5940_ELECTROCHEMICAL_DPV_PARAMETERS_check(config->parameters);
     if(error != AD5940ERR_OK) return error;
 
-    uint16_t step_number = STEP_NUMBER(parameters);
-
-	#define SEQLEN_ONESTEP 3L  /* How many sequence commands are needed to update LPDAC. */
-	uint32_t SeqCmdBuff[SEQLEN_ONESTEP];
-
-	uint32_t current_address = start_address;
-
-    uint32_t lpdac_dat_bit;
-	BoolFlag next_is_step = bFALSE;
-
-    float e_current;
-
-    float e_step_real;
-    float e_pulse_real;
-    
-    e_step_real = _get_e_step_real(
-        parameters
-    );
-
-    e_pulse_real = _get_e_pulse_real(
-        parameters
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segment;
+    _get_waveform_segment(
+        config->parameters,
+        &segment
     );
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform = {
+        .segments = &segment,
+        .segment_number = 1,
+    };
 
-	for(size_t i=0; i<step_number; i++)
-	{
-        e_current = _get_voltage_at_index(
-            parameters,
-            i,
-            e_step_real,
-            e_pulse_real
-        );
-        error = AD5940_ELECTROCHEMICAL_calculate_lpdac_dat_bits_by_potential(
-            e_current,
-            &lpdac_dat_bit
-        );
-        if(error != AD5940ERR_OK) return error;
-		SeqCmdBuff[0] = SEQ_WR(REG_AFE_LPDACDAT0, lpdac_dat_bit);
-		SeqCmdBuff[1] = SEQ_WAIT(10); /* !!!NOTE LPDAC need 10 clocks to update data. Before send AFE to sleep state, wait 10 extra clocks */
-        AD5940_get_change_sequence_info_command(
-            (next_is_step) ? DAC_STEP_SEQID : DAC_PULSE_SEQID,
-            (i == (step_number - 1)) ? start_address : (current_address + SEQLEN_ONESTEP),
-            SEQLEN_ONESTEP,
-            SeqCmdBuff + 2
-        );
-		AD5940_SEQCmdWrite(current_address, SeqCmdBuff, SEQLEN_ONESTEP);
-        next_is_step = (next_is_step == bTRUE) ? bFALSE : bTRUE;
-        current_address += SEQLEN_ONESTEP;
-	}
-    *sequence_length = current_address - start_address;
-
-    AD5940_write_change_sequence_info_command(
-        DAC_STEP_SEQID,
-        start_address,
-        SEQLEN_ONESTEP
+    float t_interval;
+    AD5940_ELECTROCHEMICAL_DPV_get_t_interval(
+        config->parameters,
+        &t_interval
     );
-
-    AD5940_write_change_sequence_info_command(
-        DAC_PULSE_SEQID,
-        start_address + SEQLEN_ONESTEP,
-        SEQLEN_ONESTEP
+    const float t_level[2] = {t_interval - config->parameters->t_pulse, config->parameters->t_pulse};
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin(
+        context,
+        device,
+        &waveform,
+        t_level,
+        &config->parameters->sampling,
+        config->run,
+        config->path_type,
+        &config->path,
+        AFEINTSRC_DATAFIFOTHRESH | AFEINTSRC_ENDSEQ
     );
-
-	return AD5940ERR_OK;
 }
 
-static AD5940Err _write_sequence_commands(
-    const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *const parameters,
-    const AD5940_ClockConfig *const clock_cfg,
-    const DFTCfg_Type *const dft,
-    const uint32_t ADCAvgNum,
-    const uint32_t ADCSinc2Osr,
-    const uint32_t ADCSinc3Osr,
-    const BoolFlag BpNotch,
-    const uint32_t DataType
+AD5940Err AD5940_ELECTROCHEMICAL_DPV_start(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config
 )
 {
     AD5940Err error = AD5940ERR_OK;
 
-    uint32_t sequence_address = 0x00;
-    uint32_t sequence_commands_length = 0;
-
-    error = AD5940_ELECTROCHEMICAL_write_sequence_commands_config(
-        clock_cfg,
-        dft,
-        ADCAvgNum,
-        ADCSinc2Osr,
-        ADCSinc3Osr,
-        BpNotch,
-        1,
-        DataType,
-        &sequence_address
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_DPV_start_begin(
+        device,
+        config,
+        &context
     );
-    if(error != AD5940ERR_OK) return AD5940ERR_PARA;
-
-    error = _write_DAC_sequence_commands(
-        sequence_address,
-        &sequence_commands_length,
-        parameters
-    );
-    if(error != AD5940ERR_OK) return AD5940ERR_PARA;
-    sequence_address += sequence_commands_length;
+    if(error != AD5940ERR_OK) return error;
 
-    return AD5940ERR_OK;
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
 }
 
-static AD5940Err _start_wakeup_timer_sequence(
-    const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *const parameters,
-    const uint32_t FifoSrc,
-    const uint16_t FifoThresh,
-    const float LFOSCClkFreq
+AD5940Err AD5940_ELECTROCHEMICAL_DPV_reconfigure(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config
 )
 {
-    /* Configure FIFO and Sequencer for normal Amperometric Measurement */
-    AD5940_FIFOThrshSet((uint32_t) FifoThresh);
-    AD5940_FIFOCtrlS(FifoSrc, bTRUE);
-
-    AD5940_SEQCtrlS(bTRUE);
-
-    const float t_interval = T_INTERVAL(
-        parameters->e_step, 
-        parameters->scan_rate
-    );
-
-    #define SAMPLE_DELAY 0.001
+    AD5940Err error = AD5940ERR_OK;
 
-    SEQInfo_Type *ADC_seq_info;
-    AD5940_ELECTROCHEMICAL_UTILITY_get_ADC_seq_info(
-        &ADC_seq_info
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_DPV_start_begin(
+        device,
+        config,
+        &context
     );
+    if(error != AD5940ERR_OK) return error;
+    context.reconfigure = bTRUE;
 
-    /* Configure Wakeup Timer*/
-	WUPTCfg_Type wupt_cfg;
-	wupt_cfg.WuptEn = bTRUE;
-	wupt_cfg.WuptEndSeq = WUPTENDSEQ_D;
-	wupt_cfg.WuptOrder[0] = DAC_STEP_SEQID;
-	wupt_cfg.WuptOrder[1] = ADC_seq_info->SeqId;
-	wupt_cfg.WuptOrder[2] = DAC_PULSE_SEQID;
-	wupt_cfg.WuptOrder[3] = ADC_seq_info->SeqId;
-	wupt_cfg.SeqxSleepTime[ADC_seq_info->SeqId] = 1;        // The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock.
-	wupt_cfg.SeqxWakeupTime[ADC_seq_info->SeqId] = (uint32_t)(LFOSCClkFreq * SAMPLE_DELAY) - 1;
-	wupt_cfg.SeqxSleepTime[DAC_STEP_SEQID] = 1;        // The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock.
-	wupt_cfg.SeqxWakeupTime[DAC_STEP_SEQID] = (uint32_t)(LFOSCClkFreq * (parameters->t_pulse - SAMPLE_DELAY)) - 1;
-	wupt_cfg.SeqxSleepTime[DAC_PULSE_SEQID] = 1;  // The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock.
-	wupt_cfg.SeqxWakeupTime[DAC_PULSE_SEQID] = (uint32_t)(LFOSCClkFreq * (t_interval - parameters->t_pulse - SAMPLE_DELAY)) - 1;
-    AD5940_WUPTCfg(&wupt_cfg);
-
-    return AD5940ERR_OK;
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
 }
 
-AD5940Err AD5940_ELECTROCHEMICAL_DPV_start(
-    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config
+AD5940Err AD5940_ELECTROCHEMICAL_DPV_get_plan(
+    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
 )
 {
     AD5940Err error = AD5940ERR_OK;
 
-    error = AD5940_ELECTROCHEMICAL_DPV_PARAMETERS_check(config->parameters);
-    if(error != AD5940ERR_OK) return error;
-
-    /* Wakeup AFE by read register, read 10 times at most */
-    if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
-
-    /**
-     * Before the application begins, INT are used for configuring parameters.
-     * Therefore, they should not be used during the configuration process itself.
-     */
-    AD5940_clear_GPIO_and_INT_flag();
-
-    switch (config->path_type)
-    {
-    case 0:
-        error = AD5940_ELECTROCHEMICAL_config_afe_lpdac_lptia(
-            config->path.lpdac_to_lptia->afe_ref_cfg,
-            0
-        );
-        if(error != AD5940ERR_OK) return error;
-
-        error = _write_sequence_commands(
-            config->parameters,
-            config->run->clock_cfg,
-            &(config->path.lpdac_to_lptia->dsp_cfg->DftCfg),
-            config->path.lpdac_to_lptia->dsp_cfg->ADCFilterCfg.ADCAvgNum,
-            config->path.lpdac_to_lptia->dsp_cfg->ADCFilterCfg.ADCSinc2Osr,
-            config->path.lpdac_to_lptia->dsp_cfg->ADCFilterCfg.ADCSinc3Osr,
-            config->path.lpdac_to_lptia->dsp_cfg->ADCFilterCfg.BpNotch,
-            config->run->DataType
-        );
-        if(error != AD5940ERR_OK) return error;
-
-        error = AD5940_ELECTROCHEMICAL_config_lpdac_lptia_adc(
-            config->path.lpdac_to_lptia->lpdac_cfg,
-            config->path.lpdac_to_lptia->lptia_cfg,
-            config->path.lpdac_to_lptia->dsp_cfg,
-            config->run->clock_cfg->ADCRate,
-            bFALSE
-        );
-        if(error != AD5940ERR_OK) return error;
-        break;
-    
-    case 1:
-        error = AD5940_ELECTROCHEMICAL_config_afe_lpdac_hstia(
-            config->path.lpdac_to_hstia->afe_ref_cfg,
-            0
-        );
-        if(error != AD5940ERR_OK) return error;
-
-        error = _write_sequence_commands(
-            config->parameters,
-            config->run->clock_cfg,
-            &(config->path.lpdac_to_hstia->dsp_cfg->DftCfg),
-            config->path.lpdac_to_hstia->dsp_cfg->ADCFilterCfg.ADCAvgNum,
-            config->path.lpdac_to_hstia->dsp_cfg->ADCFilterCfg.ADCSinc2Osr,
-            config->path.lpdac_to_hstia->dsp_cfg->ADCFilterCfg.ADCSinc3Osr,
-            config->path.lpdac_to_hstia->dsp_cfg->ADCFilterCfg.BpNotch,
-            config->run->DataType
-        );
-        if(error != AD5940ERR_OK) return error;
-
-        error = AD5940_ELECTROCHEMICAL_config_lpdac_hstia_adc(
-            config->path.lpdac_to_hstia->lpdac_cfg,
-            config->path.lpdac_to_hstia->hstia_cfg,
-            config->path.lpdac_to_hstia->dsp_cfg,
-            config->path.lpdac_to_hstia->electrode_routing,
-            config->run->clock_cfg->ADCRate,
-            bFALSE
-        );
-        if(error != AD5940ERR_OK) return error;
-        break;
-    
-    case 2:
-        // TODO
-        return AD5940ERR_PARA;
-    
-    default:
-        return AD5940ERR_PARA;
-    }
-
-    // Ensure it is cleared as ad5940.c relies on the INTC flag as well.
-    AD5940_INTCClrFlag(AFEINTSRC_ALLINT);
-
-    AGPIOCfg_Type agpio_cfg;
-    memcpy(&agpio_cfg, config->run->agpio_cfg, sizeof(AGPIOCfg_Type));
-    AD5940_set_INTCCfg_by_AGPIOCfg_Type(&agpio_cfg, AFEINTSRC_DATAFIFOTHRESH | AFEINTSRC_ENDSEQ);
-    AD5940_AGPIOCfg(&agpio_cfg);
-
-    error = _start_wakeup_timer_sequence(
-        config->parameters,
-        config->run->FifoSrc,
-        config->run->FifoThresh,
-        config->run->LFOSCClkFreq
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_DPV_start_begin(
+        NULL,
+        config,
+        &context
     );
     if(error != AD5940ERR_OK) return error;
 
-    return error;
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_get_plan(
+        &context,
+        plan
+    );
 }
 
 AD5940Err AD5940_ELECTROCHEMICAL_DPV_get_fifo_count(
@@ -346,7 +152,24 @@ AD5940Err AD5940_ELECTROCHEMICAL_DPV_get_fifo_count(
     error = AD5940_ELECTROCHEMICAL_DPV_PARAMETERS_check(parameters);
     if(error != AD5940ERR_OK) return error;
 
-    *FIFO_count = STEP_NUMBER(parameters);
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segment;
+    _get_waveform_segment(
+        parameters,
+        &segment
+    );
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform = {
+        .segments = &segment,
+        .segment_number = 1,
+    };
+
+    uint16_t level_number;
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_get_level_number(
+        &waveform,
+        &level_number
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    *FIFO_count = level_number * AD5940_ELECTROCHEMICAL_SAMPLING_get_number(&parameters->sampling);
 
     return error;
 }
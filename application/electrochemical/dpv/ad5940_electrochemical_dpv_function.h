@@ -9,6 +9,7 @@ extern "C"
 
 #include "ad5940_electrochemical_utils_loop.h"
 #include "ad5940_electrochemical_utils_run.h"
+#include "ad5940_electrochemical_utils_waveform.h"
 
 /**
  * @brief Configuration structure for Differential Pulse Voltammetry (DPV).
@@ -28,25 +29,76 @@ typedef struct
     const AD5940_ELECTROCHEMICAL_DPV_PARAMETERS *parameters;                        /**< DPV parameter settings */
     const AD5940_ELECTROCHEMICAL_RUN_CONFIG *run;                                   /**< Execution and timing configuration */
     uint8_t path_type;                                                              /**< Choose which type of path to use */
-    union {
-        const AD5940_ELECTROCHEMICAL_LPDAC_TO_LPTIA_CONFIG *lpdac_to_lptia;         /**< Configuration for LPDAC to LPTIA path */
-        const AD5940_ELECTROCHEMICAL_LPDAC_TO_HSTIA_CONFIG *lpdac_to_hstia;         /**< Configuration for LPDAC to HSTIA path */
-        const AD5940_ELECTROCHEMICAL_HSDAC_TO_HSTIA_CONFIG *hsdac_to_hstia; /**< Configuration for HSDAC via MMR to HSTIA path */
-    } path;
+    AD5940_ELECTROCHEMICAL_PATH path;                                               /**< Configuration of the selected path */
 } 
 AD5940_ELECTROCHEMICAL_DPV_CONFIG;
 
 /**
  * @brief Starts the Differential Pulse Voltammetry (DPV) operation.
  * 
+ * @param device Device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
  * @param config Pointer to the DPV configuration structure.
  * 
  * @return AD5940Err Error code indicating success (0) or failure.
  */
 AD5940Err AD5940_ELECTROCHEMICAL_DPV_start(
+    AD5940_DEVICE *const device,
     const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config
 );
 
+/**
+ * @brief Starts the DPV operation after another technique, writing only what changed.
+ *
+ * Same as @ref AD5940_ELECTROCHEMICAL_DPV_start, except that the AFE stays powered and only
+ * the blocks that differ from the previous technique are written.
+ * Refer to @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_begin.
+ *
+ * @param device Device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
+ * @param config Pointer to the DPV configuration structure.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_DPV_reconfigure(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config
+);
+
+/**
+ * @brief Prepares an incremental start of the DPV operation, without any SPI access.
+ *
+ * Advance it with @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_step until done.
+ * The configuration must stay valid until the start is done.
+ *
+ * @param device    Device to start, or NULL for the selected device (single AD5940).
+ *                  Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
+ * @param config    Pointer to the DPV configuration structure.
+ * @param context   Context of the incremental start.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_DPV_start_begin(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+);
+
+/**
+ * @brief Predicts the duration, SRAM footprint, wakeups, FIFO data rate and interrupt rate
+ *        of the DPV operation, without any SPI access.
+ *
+ * @param config    Pointer to the DPV configuration structure.
+ * @param plan      Pointer to store the plan.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_SEQLEN if the sequences don't fit in SRAM, the plan is still filled.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_DPV_get_plan(
+    const AD5940_ELECTROCHEMICAL_DPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+);
+
 #ifdef __cplusplus
 }
 #endif
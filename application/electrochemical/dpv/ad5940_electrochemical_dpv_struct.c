@@ -17,6 +17,12 @@ AD5940Err AD5940_ELECTROCHEMICAL_DPV_PARAMETERS_check(
     if(err) return err;
     if(parameters->t_pulse >= t_interval) return AD5940ERR_PARA;
     if(!AD5940_ELECTROCHEMICAL_DPV_is_INVERSION_OPTION(parameters->inversion_option)) return AD5940ERR_PARA;
+    // Both the pulse and the base level are sampled at the same offsets.
+    err = AD5940_ELECTROCHEMICAL_SAMPLING_check(
+        &parameters->sampling,
+        (parameters->t_pulse < (t_interval - parameters->t_pulse)) ? parameters->t_pulse : (t_interval - parameters->t_pulse)
+    );
+    if(err) return err;
     return AD5940ERR_OK;
 }
 
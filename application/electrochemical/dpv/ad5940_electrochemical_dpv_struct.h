@@ -49,6 +49,7 @@ typedef struct
     float t_pulse;   /**< Pulse duration, in milliseconds (ms). */
     float scan_rate; /**< Rate of potential change during the scan, in millivolts per second (mV/s). */
     AD5940_ELECTROCHEMICAL_DPV_INVERSION_OPTION inversion_option; /**< Option to invert the signal during measurement. */
+    AD5940_ELECTROCHEMICAL_SAMPLING sampling;  /**< ADC capture points within both the step and the pulse levels. */
 }
 AD5940_ELECTROCHEMICAL_DPV_PARAMETERS;
 
@@ -2,13 +2,20 @@
 
 #include "ad5940_utils.h"
 #include "ad5940_electrochemical_utils.h"
+#include "ad5940_technique_context.h"
 
 #include <stdlib.h>
 
 AD5940Err AD5940_ELECTROCHEMICAL_EIS_start(
+    AD5940_DEVICE *const device,
     const AD5940_ELECTROCHEMICAL_EIS_CONFIG *const config
 )
 {
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_TECHNIQUE_CONTEXT_select(device);
+    if(error != AD5940ERR_OK) return error;
+
     // TODO
     return AD5940ERR_OK;
 }
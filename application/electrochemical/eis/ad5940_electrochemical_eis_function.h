@@ -9,6 +9,7 @@ extern "C"
 
 #include "ad5940_electrochemical_utils_loop.h"
 #include "ad5940_electrochemical_utils_run.h"
+#include "ad5940_device.h"
 
 /**
  * @brief Configuration structure for Electrochemical impedance spectroscopy (EIS).
@@ -29,11 +30,14 @@ AD5940_ELECTROCHEMICAL_EIS_CONFIG;
 /**
  * @brief Starts the Electrochemical impedance spectroscopy (EIS) operation.
  * 
+ * @param device Device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
  * @param config Pointer to the EIS configuration structure.
  * 
  * @return AD5940Err Error code indicating success (0) or failure.
  */
 AD5940Err AD5940_ELECTROCHEMICAL_EIS_start(
+    AD5940_DEVICE *const device,
     const AD5940_ELECTROCHEMICAL_EIS_CONFIG *const config
 );
 
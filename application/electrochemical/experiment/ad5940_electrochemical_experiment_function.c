@@ -0,0 +1,370 @@
+#include "ad5940_electrochemical_experiment_function.h"
+
+#include "ad5940_irq_handler.h"
+#include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils.h"
+#include "ad5940_electrochemical_utils_sop.h"
+#include "ad5940_electrochemical_utils_waveform.h"
+#include "ad5940_technique_context.h"
+
+static const AD5940_ELECTROCHEMICAL_RUN_CONFIG *_get_run(
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *const step
+)
+{
+    switch (step->technique)
+    {
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CA:
+        return step->config.ca->run;
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CV:
+        return step->config.cv->run;
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_DPV:
+        return step->config.dpv->run;
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_LSV:
+        return step->config.lsv->run;
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_NPV:
+        return step->config.npv->run;
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_SWV:
+        return step->config.swv->run;
+    }
+    return NULL;
+}
+
+static AD5940Err _get_plan(
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *const step,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+)
+{
+    switch (step->technique)
+    {
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CA:
+        return AD5940_ELECTROCHEMICAL_CA_get_plan(step->config.ca, step->duration, plan);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CV:
+        return AD5940_ELECTROCHEMICAL_CV_get_plan(step->config.cv, plan);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_DPV:
+        return AD5940_ELECTROCHEMICAL_DPV_get_plan(step->config.dpv, plan);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_LSV:
+        return AD5940_ELECTROCHEMICAL_LSV_get_plan(step->config.lsv, plan);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_NPV:
+        return AD5940_ELECTROCHEMICAL_NPV_get_plan(step->config.npv, plan);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_SWV:
+        return AD5940_ELECTROCHEMICAL_SWV_get_plan(step->config.swv, plan);
+    }
+    return AD5940ERR_PARA;
+}
+
+/**
+ * @brief Prepares the incremental start of a waveform step. CA has no incremental start.
+ */
+static AD5940Err _start_begin(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *const step,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    switch (step->technique)
+    {
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CV:
+        return AD5940_ELECTROCHEMICAL_CV_start_begin(device, step->config.cv, context);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_DPV:
+        return AD5940_ELECTROCHEMICAL_DPV_start_begin(device, step->config.dpv, context);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_LSV:
+        return AD5940_ELECTROCHEMICAL_LSV_start_begin(device, step->config.lsv, context);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_NPV:
+        return AD5940_ELECTROCHEMICAL_NPV_start_begin(device, step->config.npv, context);
+    case AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_SWV:
+        return AD5940_ELECTROCHEMICAL_SWV_start_begin(device, step->config.swv, context);
+    default:
+        break;
+    }
+    return AD5940ERR_PARA;
+}
+
+/**
+ * @brief Places the sequences of a step in SRAM for the following start or upload.
+ *
+ * The staged steps keep the whole staged region, the later steps are written at the start
+ * of SRAM once the staged steps are done.
+ */
+static void _set_sequence_region(
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment,
+    const uint8_t index
+)
+{
+    if(index < experiment->staged_number)
+    {
+        AD5940_ELECTROCHEMICAL_set_sequence_region(experiment->base[index], experiment->staged_end);
+    }
+    else
+    {
+        AD5940_ELECTROCHEMICAL_set_sequence_region(0, 0);
+    }
+}
+
+/**
+ * @brief Writes the sequences of a staged waveform step, without starting it.
+ */
+static AD5940Err _stage(
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment,
+    const uint8_t index
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+    BoolFlag done;
+
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *const step = &experiment->steps[index];
+    if(step->technique == AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CA) return AD5940ERR_OK;  /* Short sequences, written at the transition */
+
+    _set_sequence_region(experiment, index);
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = _start_begin(experiment->device, step, &context);
+    if(error != AD5940ERR_OK) return error;
+
+    while(context.phase != AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_RUN)
+    {
+        error = AD5940_ELECTROCHEMICAL_WAVEFORM_start_step(&context, &done);
+        if(error != AD5940ERR_OK) return error;
+    }
+
+    return AD5940ERR_OK;
+}
+
+/**
+ * @brief Starts a step, with a full configuration or reconfiguring the previous step in place.
+ */
+static AD5940Err _start(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment,
+    const uint8_t index,
+    const BoolFlag reconfigure
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *const step = &experiment->steps[index];
+
+    _set_sequence_region(experiment, index);
+
+    /* A step shorter than the FIFO threshold interrupts once, with all its data */
+    uint16_t FifoThresh = _get_run(step)->FifoThresh;
+    if(experiment->sample_number[index] < FifoThresh)
+    {
+        FifoThresh = (uint16_t) experiment->sample_number[index];
+    }
+
+    if(step->technique == AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CA)
+    {
+        error = (reconfigure == bTRUE)
+            ? AD5940_ELECTROCHEMICAL_CA_reconfigure(experiment->device, step->config.ca)
+            : AD5940_ELECTROCHEMICAL_CA_start(experiment->device, step->config.ca);
+        if(error != AD5940ERR_OK) return error;
+
+        /* The wakeup timer is already running, the AFE may be asleep between two samples */
+        if(FifoThresh != _get_run(step)->FifoThresh)
+        {
+            if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
+            AD5940_FIFOThrshSet(FifoThresh);
+        }
+    }
+    else
+    {
+        AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+        error = _start_begin(experiment->device, step, &context);
+        if(error != AD5940ERR_OK) return error;
+        context.reconfigure = reconfigure;
+        context.FifoThresh = FifoThresh;
+
+        error = AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
+        if(error != AD5940ERR_OK) return error;
+    }
+
+    experiment->index = index;
+    experiment->sample_count = 0;
+    experiment->FifoThresh = FifoThresh;
+
+    return AD5940ERR_OK;
+}
+
+/**
+ * @brief Stops the wakeup timer and the sequencer of the running step, the AFE stays powered.
+ */
+static AD5940Err _stop_sequencer(void)
+{
+    /* Wakeup AFE by read register, read 10 times at most */
+    if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
+
+    /* Twice, the wakeup timer may restart a sequence while the first write is in flight */
+    AD5940_WUPTCtrl(bFALSE);
+    AD5940_WUPTCtrl(bFALSE);
+    AD5940_SEQCtrlS(bFALSE);
+
+    return AD5940ERR_OK;
+}
+
+static void _stop(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment
+)
+{
+    AD5940_shutdown_afe_lploop_hsloop_dsp();
+    AD5940_ELECTROCHEMICAL_set_sequence_region(0, 0);
+    experiment->running = bFALSE;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_EXPERIMENT_init(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment,
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *const steps,
+    const uint8_t step_number
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    uint32_t sram_words[AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP_NUMBER_MAX];
+    AD5940_ELECTROCHEMICAL_PLAN plan;
+    uint32_t SeqMemSize;
+    uint32_t FIFOSize;
+
+    experiment->device = device;
+    experiment->steps = steps;
+    experiment->step_number = step_number;
+    experiment->index = 0;
+    experiment->sample_count = 0;
+    experiment->running = bFALSE;
+
+    if((step_number == 0) || (step_number > AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP_NUMBER_MAX)) return AD5940ERR_PARA;
+
+    /* Every step must be valid and fit in SRAM on its own */
+    for(uint8_t i=0; i<step_number; i++)
+    {
+        if(_get_run(&steps[i]) == NULL) return AD5940ERR_PARA;
+
+        error = _get_plan(&steps[i], &plan);
+        if(error != AD5940ERR_OK) return error;
+        if(plan.sample_number == 0) return AD5940ERR_PARA;
+
+        experiment->sample_number[i] = plan.sample_number;
+        sram_words[i] = plan.sram_words;
+        experiment->base[i] = 0;
+    }
+
+    /* Stage the following steps after the first one while every staged run keeps its FIFO threshold */
+    experiment->staged_number = 1;
+    experiment->staged_end = sram_words[0];
+    for(uint8_t i=1; i<step_number; i++)
+    {
+        const uint32_t staged_end = experiment->staged_end + sram_words[i];
+        BoolFlag fit = bTRUE;
+        for(uint8_t j=0; j<=i; j++)
+        {
+            const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run = _get_run(&steps[j]);
+            if(AD5940_get_sram_partition(run->sram_partition, staged_end, run->FifoThresh, &SeqMemSize, &FIFOSize) != AD5940ERR_OK)
+            {
+                fit = bFALSE;
+                break;
+            }
+        }
+        if(fit == bFALSE) break;
+
+        experiment->base[i] = experiment->staged_end;
+        experiment->staged_end = staged_end;
+        experiment->staged_number++;
+    }
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_EXPERIMENT_start(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    /* The sequence region and the staged sequences belong to the technique context of the device */
+    error = AD5940_TECHNIQUE_CONTEXT_select(experiment->device);
+    if(error != AD5940ERR_OK) return error;
+
+    /* The first step is configured last, the staging leaves the AFE configured for another step */
+    for(uint8_t i=experiment->staged_number-1; i>0; i--)
+    {
+        error = _stage(experiment, i);
+        if(error != AD5940ERR_OK) break;
+    }
+    if(error == AD5940ERR_OK)
+    {
+        error = _start(experiment, 0, bFALSE);
+    }
+    if(error != AD5940ERR_OK)
+    {
+        _stop(experiment);
+        return error;
+    }
+
+    experiment->running = bTRUE;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_EXPERIMENT_irq_handler(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment,
+    const uint16_t buffer_max_length,
+    uint32_t *const buffer,
+    uint16_t *const buffer_length,
+    uint8_t *const step_index,
+    BoolFlag *const done
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    *step_index = experiment->index;
+    *done = bFALSE;
+    *buffer_length = 0;
+    if(experiment->running == bFALSE) return AD5940ERR_PARA;
+
+    error = AD5940_TECHNIQUE_CONTEXT_select(experiment->device);
+    if(error != AD5940ERR_OK) return error;
+
+    error = AD5940_irq_handler(
+        -1,
+        buffer_max_length,
+        buffer,
+        buffer_length
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    const uint32_t remaining = experiment->sample_number[experiment->index] - experiment->sample_count;
+    if(*buffer_length < remaining)
+    {
+        experiment->sample_count += *buffer_length;
+
+        /* The last interrupt of the step comes with its last data */
+        if((remaining - *buffer_length) < experiment->FifoThresh)
+        {
+            experiment->FifoThresh = remaining - *buffer_length;
+            if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
+            AD5940_FIFOThrshSet(experiment->FifoThresh);
+        }
+        return AD5940ERR_OK;
+    }
+
+    /* The sequences loop over the waveform, the data past the end of the step are dropped */
+    *buffer_length = (uint16_t) remaining;
+
+    if(experiment->index + 1 >= experiment->step_number)
+    {
+        _stop(experiment);
+        *done = bTRUE;
+        return AD5940ERR_OK;
+    }
+
+    error = _stop_sequencer();
+    if(error == AD5940ERR_OK)
+    {
+        error = _start(experiment, experiment->index + 1, bTRUE);
+    }
+    if(error != AD5940ERR_OK)
+    {
+        _stop(experiment);
+        return error;
+    }
+
+    return AD5940ERR_OK;
+}
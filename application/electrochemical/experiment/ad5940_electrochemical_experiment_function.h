@@ -0,0 +1,153 @@
+/**
+ * @file ad5940_electrochemical_experiment_function.h
+ * @brief Runs an ordered list of techniques back to back, e.g. a conditioning CA, then CV, then DPV.
+ *
+ * All the steps are validated before the first one starts. The sequences of as many steps as fit
+ * are placed one after the other in SRAM and the DAC sequences of the waveform steps are uploaded
+ * before the first step starts. When a step has produced all its samples, the interrupt handler
+ * stops the wakeup timer and reconfigures the next step in place: the AFE stays powered,
+ * only the blocks that differ are written, and the staged sequences are not uploaded again.
+ * The steps that do not fit are written at their transition at the start of SRAM.
+ *
+ * The temperature is captured by the steps themselves, refer to `temperature` in
+ * @ref AD5940_ELECTROCHEMICAL_RUN_CONFIG.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_electrochemical_ca_function.h"
+#include "ad5940_electrochemical_cv_function.h"
+#include "ad5940_electrochemical_dpv_function.h"
+#include "ad5940_electrochemical_lsv_function.h"
+#include "ad5940_electrochemical_npv_function.h"
+#include "ad5940_electrochemical_swv_function.h"
+
+/**
+ * @brief Maximum number of steps of an experiment.
+ */
+#define AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP_NUMBER_MAX 8
+
+/**
+ * @brief Techniques of the experiment steps.
+ */
+typedef enum {
+    AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CA,
+    AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_CV,
+    AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_DPV,
+    AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_LSV,
+    AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_NPV,
+    AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE_SWV,
+} AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE;
+
+/**
+ * @brief Step of an experiment, one technique configuration.
+ *
+ * The configurations must stay valid until the experiment is done.
+ */
+typedef struct
+{
+    AD5940_ELECTROCHEMICAL_EXPERIMENT_TECHNIQUE technique;      /**< Technique of the step, selects the configuration. */
+    union
+    {
+        const AD5940_ELECTROCHEMICAL_CA_CONFIG *ca;
+        const AD5940_ELECTROCHEMICAL_CV_CONFIG *cv;
+        const AD5940_ELECTROCHEMICAL_DPV_CONFIG *dpv;
+        const AD5940_ELECTROCHEMICAL_LSV_CONFIG *lsv;
+        const AD5940_ELECTROCHEMICAL_NPV_CONFIG *npv;
+        const AD5940_ELECTROCHEMICAL_SWV_CONFIG *swv;
+    }
+    config;                                                     /**< Configuration of the technique. */
+    float duration;                                             /**< Duration of a CA step, in seconds (s).
+                                                                     The other techniques end after one pass of their waveform. */
+}
+AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP;
+
+/**
+ * @brief State of an experiment.
+ */
+typedef struct
+{
+    AD5940_DEVICE *device;                                                  /**< Device running the experiment, or NULL for the selected one. */
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *steps;                    /**< Steps, executed in order. */
+    uint8_t step_number;                                                    /**< Number of steps. */
+
+    uint32_t sample_number[AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP_NUMBER_MAX];  /**< FIFO data of each step, from its plan. */
+    uint32_t base[AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP_NUMBER_MAX];           /**< SRAM address of the sequences of each step. */
+    uint8_t staged_number;                                                  /**< Number of steps placed in SRAM from the start. */
+    uint32_t staged_end;                                                    /**< End of their sequences in SRAM (in sequence commands). */
+
+    uint8_t index;                                                          /**< Running step, or the invalid step after an init error. */
+    uint32_t sample_count;                                                  /**< FIFO data of the running step read so far. */
+    uint16_t FifoThresh;                                                    /**< FIFO threshold set for the running step. */
+    BoolFlag running;                                                       /**< bTRUE from the start until the last step is done or an error. */
+}
+AD5940_ELECTROCHEMICAL_EXPERIMENT;
+
+/**
+ * @brief Validates the steps and places their sequences in SRAM, without any SPI access.
+ *
+ * @param experiment    Experiment to prepare.
+ * @param device        Device running the experiment, or NULL for the selected device (single AD5940).
+ *                      It is selected by the start and by every interrupt of the experiment.
+ * @param steps         Steps, executed in order.
+ * @param step_number   Number of steps, up to @ref AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP_NUMBER_MAX.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ *                   On failure, `experiment->index` is the invalid step.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_EXPERIMENT_init(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment,
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_EXPERIMENT_STEP *const steps,
+    const uint8_t step_number
+);
+
+/**
+ * @brief Uploads the staged sequences and starts the first step.
+ *
+ * The staged waveform steps are configured and uploaded from the last to the second one,
+ * then the first step is started with a full configuration.
+ *
+ * @param experiment    Experiment prepared by @ref AD5940_ELECTROCHEMICAL_EXPERIMENT_init.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_EXPERIMENT_start(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment
+);
+
+/**
+ * @brief Handles the interrupt of a running experiment, in place of @ref AD5940_irq_handler.
+ *
+ * Reads the FIFO, lowers the FIFO threshold so that the last interrupt of a step comes with
+ * its last sample, and starts the next step once the step is complete. The FIFO data read
+ * past the end of a step are dropped. After the last step, the AFE is shut down.
+ *
+ * @param experiment            Running experiment.
+ * @param buffer_max_length     Maximum allowable length of the MCU buffer.
+ * @param buffer                Pointer to the MCU buffer to store FIFO data from the AD5940.
+ * @param buffer_length         Pointer to store the number of FIFO data of the step.
+ * @param step_index            Pointer to store the step of the FIFO data.
+ * @param done                  Pointer to store bTRUE once the last step is complete.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ *                   If the next step fails to start, the AFE is shut down and the experiment stops.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_EXPERIMENT_irq_handler(
+    AD5940_ELECTROCHEMICAL_EXPERIMENT *const experiment,
+    const uint16_t buffer_max_length,
+    uint32_t *const buffer,
+    uint16_t *const buffer_length,
+    uint8_t *const step_index,
+    BoolFlag *const done
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,159 @@
+#include "ad5940_electrochemical_lsv_function.h"
+
+#include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils.h"
+#include "ad5940_electrochemical_utils_waveform.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SEGMENT_NUMBER 2
+
+static void _get_waveform_segments(
+    const AD5940_ELECTROCHEMICAL_LSV_PARAMETERS *const parameters,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segments
+)
+{
+    memset(segments, 0, sizeof(AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT) * SEGMENT_NUMBER);
+
+    segments[0].type = AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_RAMP;
+    segments[0].e_begin = parameters->e_begin;
+    segments[0].e_end = parameters->e_end;
+    segments[0].e_step = parameters->e_step;
+
+    // The ramp excludes its end, so the end potential is applied as the last step.
+    segments[1].type = AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_HOLD;
+    segments[1].e_begin = parameters->e_end;
+    segments[1].number = 1;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_LSV_start_begin(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_LSV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_LSV_PARAMETERS_check(config->parameters);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segments[SEGMENT_NUMBER];
+    _get_waveform_segments(
+        config->parameters,
+        segments
+    );
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform = {
+        .segments = segments,
+        .segment_number = SEGMENT_NUMBER,
+    };
+
+    float t_interval;
+    AD5940_ELECTROCHEMICAL_LSV_get_t_interval(
+        config->parameters,
+        &t_interval
+    );
+    const float t_level[2] = {t_interval, t_interval};
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin(
+        context,
+        device,
+        &waveform,
+        t_level,
+        &config->parameters->sampling,
+        config->run,
+        config->path_type,
+        &config->path,
+        AFEINTSRC_DATAFIFOTHRESH
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_LSV_start(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_LSV_CONFIG *const config
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_LSV_start_begin(
+        device,
+        config,
+        &context
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_LSV_reconfigure(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_LSV_CONFIG *const config
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_LSV_start_begin(
+        device,
+        config,
+        &context
+    );
+    if(error != AD5940ERR_OK) return error;
+    context.reconfigure = bTRUE;
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_LSV_get_plan(
+    const AD5940_ELECTROCHEMICAL_LSV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_LSV_start_begin(
+        NULL,
+        config,
+        &context
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_get_plan(
+        &context,
+        plan
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_LSV_get_fifo_count(
+    const AD5940_ELECTROCHEMICAL_LSV_PARAMETERS *parameters,
+    uint16_t *const FIFO_count
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_LSV_PARAMETERS_check(parameters);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segments[SEGMENT_NUMBER];
+    _get_waveform_segments(
+        parameters,
+        segments
+    );
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform = {
+        .segments = segments,
+        .segment_number = SEGMENT_NUMBER,
+    };
+
+    uint16_t level_number;
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_get_level_number(
+        &waveform,
+        &level_number
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    *FIFO_count = level_number * AD5940_ELECTROCHEMICAL_SAMPLING_get_number(&parameters->sampling);
+
+    return error;
+}
@@ -0,0 +1,24 @@
+#include "ad5940_electrochemical_lsv_struct.h"
+
+AD5940Err AD5940_ELECTROCHEMICAL_LSV_PARAMETERS_check(
+    const AD5940_ELECTROCHEMICAL_LSV_PARAMETERS *const parameters
+)
+{
+    if(parameters->e_step <= 0) return AD5940ERR_PARA;
+    if(parameters->scan_rate <= 0) return AD5940ERR_PARA;
+    return AD5940_ELECTROCHEMICAL_SAMPLING_check(
+        &parameters->sampling,
+        parameters->e_step / parameters->scan_rate
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_LSV_get_t_interval(
+    const AD5940_ELECTROCHEMICAL_LSV_PARAMETERS *const parameters,
+    float *const t_interval
+)
+{
+    if(parameters->e_step <= 0) return AD5940ERR_PARA;
+    if(parameters->scan_rate <= 0) return AD5940ERR_PARA;
+    *t_interval = parameters->e_step / parameters->scan_rate;
+    return AD5940ERR_OK;
+}
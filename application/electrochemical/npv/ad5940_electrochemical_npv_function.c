@@ -0,0 +1,182 @@
+#include "ad5940_electrochemical_npv_function.h"
+
+#include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils.h"
+#include "ad5940_electrochemical_utils_waveform.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static inline float _get_e_step_real(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *const parameters
+)
+{
+    return (parameters->e_end > parameters->e_begin) 
+        ? parameters->e_step 
+        : -parameters->e_step;
+}
+
+static void _get_waveform_segment(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *const parameters,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment
+)
+{
+    memset(segment, 0, sizeof(AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT));
+
+    segment->type = AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE;
+    // The staircase starts from the first pulse, the base level is held at e_begin.
+    segment->e_begin = parameters->e_begin + _get_e_step_real(parameters);
+    segment->e_end = parameters->e_end;
+    segment->e_step = parameters->e_step;
+    segment->e_offset[0] = -_get_e_step_real(parameters);
+    segment->e_offset[1] = 0;
+    segment->hold_first = bTRUE;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_start_begin(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_NPV_PARAMETERS_check(config->parameters);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segment;
+    _get_waveform_segment(
+        config->parameters,
+        &segment
+    );
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform = {
+        .segments = &segment,
+        .segment_number = 1,
+    };
+
+    float t_interval;
+    AD5940_ELECTROCHEMICAL_NPV_get_t_interval(
+        config->parameters,
+        &t_interval
+    );
+    const float t_level[2] = {t_interval - config->parameters->t_pulse, config->parameters->t_pulse};
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin(
+        context,
+        device,
+        &waveform,
+        t_level,
+        &config->parameters->sampling,
+        config->run,
+        config->path_type,
+        &config->path,
+        AFEINTSRC_DATAFIFOTHRESH | AFEINTSRC_ENDSEQ
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_start(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_NPV_start_begin(
+        device,
+        config,
+        &context
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_reconfigure(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_NPV_start_begin(
+        device,
+        config,
+        &context
+    );
+    if(error != AD5940ERR_OK) return error;
+    context.reconfigure = bTRUE;
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_get_plan(
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_NPV_start_begin(
+        NULL,
+        config,
+        &context
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_get_plan(
+        &context,
+        plan
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_get_fifo_count(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *parameters,
+    uint16_t *const FIFO_count
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_NPV_PARAMETERS_check(parameters);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segment;
+    _get_waveform_segment(
+        parameters,
+        &segment
+    );
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform = {
+        .segments = &segment,
+        .segment_number = 1,
+    };
+
+    uint16_t level_number;
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_get_level_number(
+        &waveform,
+        &level_number
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    *FIFO_count = level_number * AD5940_ELECTROCHEMICAL_SAMPLING_get_number(&parameters->sampling);
+
+    return error;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_convert_ADC_to_current(
+    const uint32_t adc_data_pulse,
+    const fImpPol_Type *const RtiaCalValue,
+    const uint32_t ADC_PGA_gain,
+    const float ADC_reference_volt,
+    float *const current
+)
+{
+    return AD5940_convert_adc_to_current(
+        adc_data_pulse, 
+        RtiaCalValue, 
+        ADC_PGA_gain, 
+        ADC_reference_volt,
+        current
+    );
+}
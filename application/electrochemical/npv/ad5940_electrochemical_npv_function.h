@@ -0,0 +1,104 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940_electrochemical_npv_struct.h"
+
+#include "ad5940_electrochemical_utils_loop.h"
+#include "ad5940_electrochemical_utils_run.h"
+#include "ad5940_electrochemical_utils_waveform.h"
+
+/**
+ * @brief Configuration structure for Normal Pulse Voltammetry (NPV).
+ * 
+ * This structure allows the user to configure the parameters and signal paths 
+ * required for performing electrochemical NPV measurements.
+ * 
+ * Specifies the signal path based on the selected path_type:
+ * - 0: lpdac_to_lptia
+ * - 1: lpdac_to_hstia
+ * - 2: hsdac_to_hstia
+ * 
+ * The selected path determines the loop used to perform the electrochemical operation.
+ */
+typedef struct 
+{
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *parameters;                        /**< NPV parameter settings */
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *run;                                   /**< Execution and timing configuration */
+    uint8_t path_type;                                                              /**< Choose which type of path to use */
+    AD5940_ELECTROCHEMICAL_PATH path;                                               /**< Configuration of the selected path */
+} 
+AD5940_ELECTROCHEMICAL_NPV_CONFIG;
+
+/**
+ * @brief Starts the Normal Pulse Voltammetry (NPV) operation.
+ * 
+ * @param device Device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
+ * @param config Pointer to the NPV configuration structure.
+ * 
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_start(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config
+);
+
+/**
+ * @brief Starts the NPV operation after another technique, writing only what changed.
+ *
+ * Same as @ref AD5940_ELECTROCHEMICAL_NPV_start, except that the AFE stays powered and only
+ * the blocks that differ from the previous technique are written.
+ * Refer to @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_begin.
+ *
+ * @param device Device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
+ * @param config Pointer to the NPV configuration structure.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_reconfigure(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config
+);
+
+/**
+ * @brief Prepares an incremental start of the NPV operation, without any SPI access.
+ *
+ * Advance it with @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_step until done.
+ * The configuration must stay valid until the start is done.
+ *
+ * @param device    Device to start, or NULL for the selected device (single AD5940).
+ *                  Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
+ * @param config    Pointer to the NPV configuration structure.
+ * @param context   Context of the incremental start.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_start_begin(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+);
+
+/**
+ * @brief Predicts the duration, SRAM footprint, wakeups, FIFO data rate and interrupt rate
+ *        of the NPV operation, without any SPI access.
+ *
+ * @param config    Pointer to the NPV configuration structure.
+ * @param plan      Pointer to store the plan.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_SEQLEN if the sequences don't fit in SRAM, the plan is still filled.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_get_plan(
+    const AD5940_ELECTROCHEMICAL_NPV_CONFIG *const config,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+);
+
+#ifdef __cplusplus
+}
+#endif
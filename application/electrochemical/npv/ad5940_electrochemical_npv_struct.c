@@ -0,0 +1,40 @@
+#include "ad5940_electrochemical_npv_struct.h"
+
+#include <math.h>
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_PARAMETERS_check(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *const parameters
+)
+{
+    AD5940Err err;
+    float t_interval;
+    if(parameters->e_step <= 0) return AD5940ERR_PARA;
+    if(parameters->t_pulse <= 0) return AD5940ERR_PARA;
+    if(parameters->scan_rate <= 0) return AD5940ERR_PARA;
+    // At least one pulse is applied.
+    if(fabsf(parameters->e_end - parameters->e_begin) < parameters->e_step) return AD5940ERR_PARA;
+    err = AD5940_ELECTROCHEMICAL_NPV_get_t_interval(
+        parameters,
+        &t_interval
+    );
+    if(err) return err;
+    if(parameters->t_pulse >= t_interval) return AD5940ERR_PARA;
+    // Both the pulse and the base level are sampled at the same offsets.
+    err = AD5940_ELECTROCHEMICAL_SAMPLING_check(
+        &parameters->sampling,
+        (parameters->t_pulse < (t_interval - parameters->t_pulse)) ? parameters->t_pulse : (t_interval - parameters->t_pulse)
+    );
+    if(err) return err;
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_get_t_interval(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *const parameters,
+    float *const t_interval
+)
+{
+    if(parameters->e_step <= 0) return AD5940ERR_PARA;
+    if(parameters->scan_rate <= 0) return AD5940ERR_PARA;
+    *t_interval = parameters->e_step / parameters->scan_rate;
+    return AD5940ERR_OK;
+}
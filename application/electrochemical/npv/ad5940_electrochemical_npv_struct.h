@@ -0,0 +1,81 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_utils_struct.h"
+#include "ad5940_electrochemical_utils_struct.h"
+
+/**
+ * @brief Parameters for the AD5940 Electrochemical Normal Pulse Voltammetry (NPV) operation.
+ *
+ * The potential rests at `e_begin` between pulses. The k-th pulse steps to
+ * `e_begin + k * e_step` (k starting from 1) towards `e_end` for `t_pulse`.
+ */
+typedef struct
+{
+    float e_begin;    /**< Base potential, in volts (V). */
+    float e_end;      /**< Potential of the last pulse, in volts (V). */
+    float e_step;     /**< Step potential between pulses, in volts (V). */
+    float t_pulse;    /**< Pulse duration, in seconds (s). */
+    float scan_rate;  /**< Rate of potential change during the scan, in volts per second (V/s). */
+    AD5940_ELECTROCHEMICAL_SAMPLING sampling;  /**< ADC capture points within both the base and the pulse levels. */
+}
+AD5940_ELECTROCHEMICAL_NPV_PARAMETERS;
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_PARAMETERS_check(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *const parameters
+);
+
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_get_t_interval(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *const parameters,
+    float *const t_interval
+);
+
+/**
+ * @brief Calculates the number of remaining FIFO data points required to complete the
+ *        Normal Pulse Voltammetry (NPV) operation.
+ *
+ * The FIFO receives the base data and then the pulse data of each step.
+ *
+ * @param parameters    NPV parameter settings.
+ * @param FIFO_count    Pointer to a variable where the calculated remaining FIFO count
+ *                      will be stored.
+ *
+ * @return AD5940Err                 Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_get_fifo_count(
+    const AD5940_ELECTROCHEMICAL_NPV_PARAMETERS *parameters,
+    uint16_t *const FIFO_count
+);
+
+/**
+ * @brief Converts ADC data to current values for Normal Pulse Voltammetry (NPV).
+ *
+ * The current of a step is the current sampled on the pulse.
+ * The base data is only kept in the FIFO to preserve the pairing of the data, skip it.
+ *
+ * @param adc_data_pulse        The ADC data of the pulse level retrieved from the FIFO.
+ * @param RtiaCalValue          Pointer to the RTIA calibration value. This parameter is obtained from RTIA calibration functions
+ *                              like @ref AD5940_HSRtiaCal or @ref AD5940_LPRtiaCal.
+ * @param ADC_PGA_gain          ADC Programmable Gain Amplifier (PGA) gain value. Refer to @ref ADCPGA_Const.
+ * @param ADC_reference_volt    Reference voltage used for the ADC (in volts). Refer to the AD5940 datasheet for details.
+ * @param current               Pointer to store the calculated current value (in microamperes).
+ *
+ * @return AD5940Err            Returns an error code of type `AD5940Err`. A value of 0 indicates success, while other values
+ *                              indicate specific errors encountered during the conversion process.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_NPV_convert_ADC_to_current(
+    const uint32_t adc_data_pulse,
+    const fImpPol_Type *const RtiaCalValue,
+    const uint32_t ADC_PGA_gain,
+    const float ADC_reference_volt,
+    float *const current
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#include "ad5940_electrochemical_swv_struct.h"
+
+AD5940Err AD5940_ELECTROCHEMICAL_SWV_PARAMETERS_check(
+    const AD5940_ELECTROCHEMICAL_SWV_PARAMETERS *const parameters
+)
+{
+    AD5940Err err;
+    float t_interval;
+    if(parameters->e_step <= 0) return AD5940ERR_PARA;
+    if(parameters->e_amplitude <= 0) return AD5940ERR_PARA;
+    if(parameters->frequency <= 0) return AD5940ERR_PARA;
+    err = AD5940_ELECTROCHEMICAL_SWV_get_t_interval(
+        parameters,
+        &t_interval
+    );
+    if(err) return err;
+    // Both the forward and the reverse half periods are sampled at the same offsets.
+    err = AD5940_ELECTROCHEMICAL_SAMPLING_check(
+        &parameters->sampling,
+        t_interval / 2
+    );
+    if(err) return err;
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_SWV_get_t_interval(
+    const AD5940_ELECTROCHEMICAL_SWV_PARAMETERS *const parameters,
+    float *const t_interval
+)
+{
+    if(parameters->frequency <= 0) return AD5940ERR_PARA;
+    *t_interval = 1.0f / parameters->frequency;
+    return AD5940ERR_OK;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_utils_struct.h"
+#include "ad5940_electrochemical_utils_struct.h"
+
+/**
+ * @brief Parameters for the AD5940 Electrochemical Square Wave Voltammetry (SWV) operation.
+ *
+ * Each staircase step lasts one square wave period. The first half period applies the forward
+ * level `E + e_amplitude` and the second half period applies the reverse level `E - e_amplitude`,
+ * where the sign of `e_amplitude` follows the scan direction.
+ *
+ * @note
+ * The default sampling point is 1 ms after each DAC update, which limits the frequency to below 500 Hz.
+ * Set `sampling` to sample closer to the start of each half period for higher frequencies.
+ * The sampling point must still leave time for the 250 us ADC power up and the conversion
+ * before the next half period begins.
+ */
+typedef struct
+{
+    float e_begin;      /**< Starting potential of the scan, in volts (V). */
+    float e_end;        /**< Ending potential of the scan, in volts (V). */
+    float e_step;       /**< Step potential of the staircase, in volts (V). */
+    float e_amplitude;  /**< Square wave amplitude (half of peak to peak), in volts (V). */
+    float frequency;    /**< Square wave frequency, in hertz (Hz). */
+    AD5940_ELECTROCHEMICAL_SAMPLING sampling;  /**< ADC capture points within both the forward and the reverse half periods. */
+}
+AD5940_ELECTROCHEMICAL_SWV_PARAMETERS;
+
+AD5940Err AD5940_ELECTROCHEMICAL_SWV_PARAMETERS_check(
+    const AD5940_ELECTROCHEMICAL_SWV_PARAMETERS *const parameters
+);
+
+/**
+ * @brief Gets the duration of one staircase step, which is one square wave period.
+ *
+ * @param parameters    SWV parameter settings.
+ * @param t_interval    Pointer to store the step duration, in seconds (s).
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_SWV_get_t_interval(
+    const AD5940_ELECTROCHEMICAL_SWV_PARAMETERS *const parameters,
+    float *const t_interval
+);
+
+/**
+ * @brief Calculates the number of remaining FIFO data points required to complete the
+ *        Square Wave Voltammetry (SWV) operation.
+ *
+ * The FIFO receives the forward data and then the reverse data of each step.
+ *
+ * @param parameters    SWV parameter settings.
+ * @param FIFO_count    Pointer to a variable where the calculated remaining FIFO count
+ *                      will be stored.
+ *
+ * @return AD5940Err                 Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_SWV_get_fifo_count(
+    const AD5940_ELECTROCHEMICAL_SWV_PARAMETERS *parameters,
+    uint16_t *const FIFO_count
+);
+
+/**
+ * @brief Converts the ADC data of one step to the forward, reverse and difference currents
+ *        for Square Wave Voltammetry (SWV).
+ *
+ * @param adc_data_forward      The ADC data of the forward half period retrieved from the FIFO.
+ * @param adc_data_reverse      The ADC data of the reverse half period retrieved from the FIFO.
+ * @param RtiaCalValue          Pointer to the RTIA calibration value. This parameter is obtained from RTIA calibration functions
+ *                              like @ref AD5940_HSRtiaCal or @ref AD5940_LPRtiaCal.
+ * @param ADC_PGA_gain          ADC Programmable Gain Amplifier (PGA) gain value. Refer to @ref ADCPGA_Const.
+ * @param ADC_reference_volt    Reference voltage used for the ADC (in volts). Refer to the AD5940 datasheet for details.
+ * @param current               Pointer to an array of 3 elements where the forward, reverse and difference
+ *                              (forward - reverse) currents (in microamperes) will be stored.
+ *
+ * @return AD5940Err            Returns an error code of type `AD5940Err`. A value of 0 indicates success, while other values
+ *                              indicate specific errors encountered during the conversion process.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_SWV_convert_ADC_to_current(
+    const uint32_t adc_data_forward,
+    const uint32_t adc_data_reverse,
+    const fImpPol_Type *const RtiaCalValue,
+    const uint32_t ADC_PGA_gain,
+    const float ADC_reference_volt,
+    float *const current
+);
+
+/**
+ * @brief Converts a stream of SWV ADC data read from the FIFO to currents.
+ *
+ * The ADC data must start at the forward data of a step. Every forward/reverse pair
+ * is expanded to forward, reverse and difference currents, so `current` receives
+ * 3 elements for every 2 ADC data. A trailing unpaired ADC data is left unconverted.
+ *
+ * With multiple captures per half period, pass the k-th capture of each half period
+ * as a separate stream.
+ *
+ * @param adc_data              The ADC data retrieved from the FIFO.
+ * @param adc_data_length       Number of ADC data.
+ * @param RtiaCalValue          Pointer to the RTIA calibration value.
+ * @param ADC_PGA_gain          ADC Programmable Gain Amplifier (PGA) gain value. Refer to @ref ADCPGA_Const.
+ * @param ADC_reference_volt    Reference voltage used for the ADC (in volts).
+ * @param current               Pointer to an array where the currents (in microamperes) will be stored.
+ * @param current_length        Pointer to store the number of currents written.
+ *
+ * @return AD5940Err            Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_SWV_convert_ADC_array_to_current(
+    const uint32_t *const adc_data,
+    const uint16_t adc_data_length,
+    const fImpPol_Type *const RtiaCalValue,
+    const uint32_t ADC_PGA_gain,
+    const float ADC_reference_volt,
+    float *const current,
+    uint16_t *const current_length
+);
+
+#ifdef __cplusplus
+}
+#endif
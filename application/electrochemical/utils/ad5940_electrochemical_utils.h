@@ -7,10 +7,15 @@ extern "C"
 
 #include "ad5940_utils_struct.h"
 #include "ad5940_electrochemical_utils_electrode_routing.h"
+#include "ad5940_electrochemical_utils_electrode_scan.h"
 #include "ad5940_electrochemical_utils_afe_dac_tia.h"
 #include "ad5940_electrochemical_utils_dac_tia_adc.h"
+#include "ad5940_electrochemical_utils_energy.h"
 #include "ad5940_electrochemical_utils_sop.h"
 #include "ad5940_electrochemical_utils_potential.h"
+#include "ad5940_electrochemical_utils_sampling.h"
+#include "ad5940_electrochemical_utils_temperature.h"
+#include "ad5940_electrochemical_utils_reconfigure.h"
 #include "ad5940_electrochemical_utils_loop.h"
 #include "ad5940_electrochemical_utils_run.h"
 
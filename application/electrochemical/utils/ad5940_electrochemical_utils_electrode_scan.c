@@ -0,0 +1,123 @@
+#include "ad5940_electrochemical_utils_electrode_scan.h"
+
+#include "ad5940_electrochemical_utils_temperature.h"
+
+#include <string.h>
+
+static void _write_switch_matrix(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *const electrode_routing
+)
+{
+    SWMatrixCfg_Type sw_matrix_cfg;
+    memcpy(&sw_matrix_cfg, electrode_routing, sizeof(SWMatrixCfg_Type));
+    AD5940_SWMatrixCfgS(&sw_matrix_cfg);
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_check(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint8_t path_type
+)
+{
+    if(electrode_scan == NULL) return AD5940ERR_OK;
+
+    if(electrode_scan->routings == NULL) return AD5940ERR_PARA;
+    if(electrode_scan->electrode_number == 0) return AD5940ERR_PARA;
+    if(electrode_scan->electrode_number > AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_NUMBER_MAX) return AD5940ERR_PARA;
+    if(electrode_scan->t_settle < 0) return AD5940ERR_PARA;
+
+    /* The LPTIA is fixed to CE0, RE0 and SE0 */
+    if((path_type != 1) && (path_type != 2)) return AD5940ERR_PARA;
+
+    return AD5940ERR_OK;
+}
+
+uint8_t AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_number(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan
+)
+{
+    if(electrode_scan == NULL) return 1;
+    if(electrode_scan->electrode_number == 0) return 1;
+    return electrode_scan->electrode_number;
+}
+
+const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_routing(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *const electrode_routing
+)
+{
+    if(electrode_scan == NULL) return electrode_routing;
+    return &electrode_scan->routings[0];
+}
+
+void AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_write_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint32_t WaitClks,
+    const float SysClkFreq
+)
+{
+    const uint8_t electrode_number = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_number(electrode_scan);
+    if(electrode_number <= 1) return;
+
+    const uint32_t settle_clocks = (uint32_t)(electrode_scan->t_settle * SysClkFreq);
+
+    for(uint8_t i=1; i<electrode_number; i++)
+    {
+        _write_switch_matrix(&electrode_scan->routings[i]);
+        AD5940_SEQGenInsert(SEQ_WAIT(settle_clocks));  /* wait for the TIA to settle on the electrode */
+        AD5940_AFECtrlS(AFECTRL_ADCCNV, bTRUE);
+        AD5940_SEQGenInsert(SEQ_WAIT(WaitClks));
+        AD5940_AFECtrlS(AFECTRL_ADCCNV, bFALSE);
+    }
+    /* Rest on the first electrode, as configured for the technique */
+    _write_switch_matrix(&electrode_scan->routings[0]);
+}
+
+uint32_t AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_clocks(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint32_t WaitClks,
+    const float SysClkFreq
+)
+{
+    const uint8_t electrode_number = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_number(electrode_scan);
+    if(electrode_number <= 1) return 0;
+
+    const uint32_t settle_clocks = (uint32_t)(electrode_scan->t_settle * SysClkFreq);
+
+    return (uint32_t)(electrode_number - 1) * (settle_clocks + WaitClks);
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_electrodes(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint32_t *const fifo,
+    const uint16_t length,
+    uint32_t *const current_count,
+    uint8_t *const electrodes
+)
+{
+    const uint8_t electrode_number = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_number(electrode_scan);
+
+    for(uint16_t i=0; i<length; i++)
+    {
+        if(AD5940_ELECTROCHEMICAL_TEMPERATURE_is_temperature_data(fifo[i]) == bTRUE)
+        {
+            electrodes[i] = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_TEMPERATURE;
+            continue;
+        }
+        electrodes[i] = (uint8_t)(*current_count % electrode_number);
+        (*current_count)++;
+    }
+
+    return AD5940ERR_OK;
+}
+
+void AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_resynchronize(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    uint32_t *const current_count
+)
+{
+    const uint8_t electrode_number = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_number(electrode_scan);
+
+    /* The sequencer restarts the ADC sequence at the first electrode */
+    const uint32_t position = *current_count % electrode_number;
+    if(position != 0) *current_count += electrode_number - position;
+}
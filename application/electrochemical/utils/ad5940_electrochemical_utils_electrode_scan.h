@@ -0,0 +1,178 @@
+/**
+ * @file ad5940_electrochemical_utils_electrode_scan.h
+ * @brief Scans several working electrodes through the switch matrix within each ADC wakeup.
+ *
+ * The ADC sequence captures every electrode in turn at each capture point: it converts the
+ * first electrode, then for each following electrode rewrites the switch matrix, waits for
+ * the TIA to settle and converts. After the last electrode, the switch matrix is set back to
+ * the first electrode, which is the routing configured for the technique between two wakeups.
+ * One run then replaces one run per electrode, every electrode seeing the same potential.
+ *
+ * The FIFO receives `electrode_number` data per capture point, in the order of the electrodes.
+ * The FIFO data don't carry the electrode, @ref AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_electrodes
+ * recovers it from the order of the current data. A FIFO overflow stops the sequencer, possibly
+ * between two electrodes of a capture point, and the next wakeup restarts the ADC sequence at the
+ * first electrode: @ref AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_resynchronize realigns the order on it.
+ * The techniques' `get_fifo_count` functions count one electrode, multiply them by the number
+ * of electrodes. The plans count all the electrodes.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_electrochemical_utils_electrode_routing.h"
+
+/**
+ * @brief Maximum number of scanned electrodes.
+ */
+#define AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_NUMBER_MAX 8
+
+/**
+ * @brief Electrode index given to the temperature data.
+ */
+#define AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_TEMPERATURE 0xFF
+
+/**
+ * @brief Number of sequence commands the scan adds to each capture point of the ADC sequence:
+ *        per electrode after the first, the switch matrix (5 registers, refer to `AD5940_SWMatrixCfgS`),
+ *        the settling wait and the conversion; then the switch matrix back to the first electrode.
+ */
+#define AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_SEQUENCE_LENGTH(electrode_number) \
+    (((electrode_number) > 1) ? (9 * ((uint32_t)(electrode_number) - 1) + 5) : 0)
+
+/**
+ * @brief Electrodes scanned by the ADC sequence.
+ *
+ * @warning
+ * The switch matrix only routes the HSTIA, so the scan needs a path to the HSTIA
+ * (`path_type` 1 or 2). The routings replace the `electrode_routing` of the path.
+ */
+typedef struct
+{
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *routings;   /**< Routing of each electrode, e.g. the same CE and RE with WE on AIN0 to AIN7. */
+    uint8_t electrode_number;                                   /**< Number of electrodes, 1 to @ref AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_NUMBER_MAX. */
+    float t_settle;                                             /**< Wait after switching to an electrode before its conversion, in seconds (s). */
+}
+AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN;
+
+/**
+ * @brief Checks an electrode scan against the path of the technique.
+ *
+ * @param electrode_scan    Electrode scan, or NULL when the scan is disabled.
+ * @param path_type         Type of path. See @ref AD5940_ELECTROCHEMICAL_PATH.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_check(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint8_t path_type
+);
+
+/**
+ * @brief Gets the number of scanned electrodes.
+ *
+ * @param electrode_scan    Electrode scan, or NULL when the scan is disabled.
+ *
+ * @return uint8_t Number of electrodes (at least 1).
+ */
+uint8_t AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_number(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan
+);
+
+/**
+ * @brief Gets the routing configured for the technique, the first electrode of the scan.
+ *
+ * @param electrode_scan    Electrode scan, or NULL when the scan is disabled.
+ * @param electrode_routing Routing of the path.
+ *
+ * @return const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING* Routing of the first electrode,
+ *         or the routing of the path when the scan is disabled.
+ */
+const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_routing(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *const electrode_routing
+);
+
+/**
+ * @brief Writes the scan of the following electrodes after the conversion of the first one.
+ *
+ * Called by the ADC sequence generation at each capture point, refer to
+ * @ref AD5940_ELECTROCHEMICAL_write_sequence_commands_config. Does nothing without a scan.
+ *
+ * @param electrode_scan    Electrode scan, or NULL when the scan is disabled.
+ * @param WaitClks          System clocks of one conversion.
+ * @param SysClkFreq        System clock frequency, in hertz (Hz).
+ */
+void AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_write_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint32_t WaitClks,
+    const float SysClkFreq
+);
+
+/**
+ * @brief Gets the system clocks the scan adds to each capture point.
+ *
+ * @param electrode_scan    Electrode scan, or NULL when the scan is disabled.
+ * @param WaitClks          System clocks of one conversion.
+ * @param SysClkFreq        System clock frequency, in hertz (Hz).
+ *
+ * @return uint32_t System clocks of the settling waits and the conversions of the following electrodes.
+ */
+uint32_t AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_clocks(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint32_t WaitClks,
+    const float SysClkFreq
+);
+
+/**
+ * @brief Gets the electrode of each FIFO data of a scanning run.
+ *
+ * The temperature data are skipped and get @ref AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_TEMPERATURE.
+ * Call it for each FIFO block in order, `current_count` keeps the position across blocks.
+ * The position is only right while no FIFO data is lost, after a loss call
+ * @ref AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_resynchronize before the next block.
+ *
+ * @param electrode_scan    Electrode scan, or NULL when the scan is disabled.
+ * @param fifo              Data read from the FIFO.
+ * @param length            Number of FIFO data.
+ * @param current_count     Number of current data before the block, zero at the start of the run. Updated.
+ * @param electrodes        Pointer to store the electrode of each FIFO data.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_electrodes(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    const uint32_t *const fifo,
+    const uint16_t length,
+    uint32_t *const current_count,
+    uint8_t *const electrodes
+);
+
+/**
+ * @brief Realigns the electrode order after a FIFO overflow.
+ *
+ * The data read before the overflow keep their electrodes, the capture point cut by the
+ * overflow misses its last electrodes. The data that follow the loss start at the first
+ * electrode of a capture point, whatever the number of lost data, so the estimate of the
+ * loss (`lost_sample_number` of @ref AD5940_irq_handler_monitor) is not needed here.
+ *
+ * With @ref AD5940_irq_handler_monitor, call it when `report.overflow_count` increased, once
+ * `monitor->pending` is 0: the FIFO data left on the AD5940 by the overflowing interrupt
+ * precede the loss.
+ *
+ * @param electrode_scan    Electrode scan, or NULL when the scan is disabled.
+ * @param current_count     Number of current data before the loss, rounded up to the next capture point. Updated.
+ */
+void AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_resynchronize(
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
+    uint32_t *const current_count
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,86 @@
+/**
+ * @file ad5940_electrochemical_utils_energy.h
+ * @brief Energy modes of the ADC wakeups, and energy model of a technique.
+ *
+ * Between two wakeups the AD5940 hibernates with the low power loop biasing the cell.
+ * A wakeup runs the sequencer on the high frequency oscillator, and an ADC wakeup also
+ * powers the ADC and its reference. The energy of a technique is estimated from the times
+ * of its plan, refer to @ref AD5940_ELECTROCHEMICAL_PLAN_get_energy.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+
+/**
+ * @brief Wait after powering the ADC in the default mode, 250us for the reference to power up.
+ */
+#define AD5940_ELECTROCHEMICAL_ENERGY_SETTLE_CLOCKS_DEFAULT (16*250)
+
+/**
+ * @brief Wait after powering the ADC in the low energy mode, 50us for the ADC to settle
+ *        as in the temperature application.
+ */
+#define AD5940_ELECTROCHEMICAL_ENERGY_SETTLE_CLOCKS_LOW (16*50)
+
+/**
+ * @brief Energy modes of the ADC wakeups, trading settling margin for active time.
+ */
+typedef enum {
+    AD5940_ELECTROCHEMICAL_ENERGY_MODE_DEFAULT = 0, /**< Waits for the reference at every ADC wakeup,
+                                                         the ADC stays powered between the captures of a wakeup. */
+    AD5940_ELECTROCHEMICAL_ENERGY_MODE_LOW,         /**< Waits only for the ADC to settle, and powers the ADC down
+                                                         between two captures further apart than the settling wait. */
+} AD5940_ELECTROCHEMICAL_ENERGY_MODE;
+
+/**
+ * @brief Supply currents of the AD5940 and energy of the host per interrupt.
+ */
+typedef struct
+{
+    float supply_voltage;   /**< Supply voltage of the AD5940, in volts (V). */
+    float i_hibernate;      /**< Current in hibernate, low power loop biasing the cell, in amperes (A). */
+    float i_active;         /**< Current while the sequencer runs with the ADC off, in amperes (A). */
+    float i_adc;            /**< Current added while the ADC and its reference are powered, in amperes (A). */
+    float e_irq;            /**< Energy of the host per interrupt, wakeup and FIFO read, in joules (J). */
+}
+AD5940_ELECTROCHEMICAL_ENERGY_MODEL;
+
+/**
+ * @brief Typical figures of the datasheet at 3.3V and a 16MHz system clock, host excluded.
+ *
+ * Replace them with measurements of the board for absolute numbers,
+ * the typical figures are good enough to compare two configurations.
+ */
+#define AD5940_ELECTROCHEMICAL_ENERGY_MODEL_TYPICAL {   \
+    .supply_voltage = 3.3f,                             \
+    .i_hibernate = 6.5e-6f,                             \
+    .i_active = 1.0e-3f,                                \
+    .i_adc = 1.5e-3f,                                   \
+    .e_irq = 0.0f,                                      \
+}
+
+/**
+ * @brief Energy of a technique, split by where it is spent.
+ */
+typedef struct
+{
+    float e_hibernate;          /**< Energy between wakeups, in joules (J). */
+    float e_active;             /**< Energy of the sequencer while awake, in joules (J). */
+    float e_adc;                /**< Energy of the ADC and its reference, in joules (J). */
+    float e_settle;             /**< Part of `e_adc` spent waiting for the reference or the ADC to settle, in joules (J). */
+    float e_irq;                /**< Energy of the host serving the interrupts, in joules (J). */
+    float energy;               /**< Total energy, in joules (J). */
+    float energy_per_sample;    /**< Total energy per FIFO data, in joules (J). */
+    float i_average;            /**< Average supply current, in amperes (A). */
+}
+AD5940_ELECTROCHEMICAL_ENERGY;
+
+#ifdef __cplusplus
+}
+#endif
@@ -39,11 +39,25 @@ typedef struct
 {
     const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *electrode_routing;
     const AD5940_ELECTROCHEMICAL_AFERefCfg_Type *afe_ref_cfg;           /**< Pointer to AFE reference configuration. */
-    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *hsdac_cfg;              /**< Pointer to LPPA configuration. */
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *hsdac_cfg;              /**< Pointer to HSDAC configuration. */
     const AD5940_ELECTROCHEMICAL_HSTIACfg_Type *hstia_cfg;              /**< Pointer to HSTIA configuration. */
     const AD5940_ELECTROCHEMICAL_DSPCfg_Type *dsp_cfg;                  /**< Pointer to DSP configuration. */
 }
 AD5940_ELECTROCHEMICAL_HSDAC_TO_HSTIA_CONFIG;
+
+/**
+ * @brief Signal path of a technique, selected by the `path_type` of the technique configuration:
+ * - 0: lpdac_to_lptia
+ * - 1: lpdac_to_hstia
+ * - 2: hsdac_to_hstia
+ */
+typedef union
+{
+    const AD5940_ELECTROCHEMICAL_LPDAC_TO_LPTIA_CONFIG *lpdac_to_lptia;         /**< Configuration for LPDAC to LPTIA path */
+    const AD5940_ELECTROCHEMICAL_LPDAC_TO_HSTIA_CONFIG *lpdac_to_hstia;         /**< Configuration for LPDAC to HSTIA path */
+    const AD5940_ELECTROCHEMICAL_HSDAC_TO_HSTIA_CONFIG *hsdac_to_hstia;         /**< Configuration for HSDAC via MMR to HSTIA path */
+}
+AD5940_ELECTROCHEMICAL_PATH;
  
  #ifdef __cplusplus
  }
@@ -0,0 +1,205 @@
+#include "ad5940_electrochemical_utils_plan.h"
+
+#include "ad5940_electrochemical_utils_electrode_scan.h"
+#include "ad5940_electrochemical_utils_temperature.h"
+
+/**
+ * Wait of the temperature sequence for the reference and the sensor power up, in system clocks.
+ */
+#define TEMPERATURE_SETTLE_CLOCKS (16*250)
+
+/**
+ * Number of sequence commands of the ADC sequence: power up and wait, then per capture start,
+ * wait and stop, and power down. Every capture but the first waits for its offset, with
+ * 3 more commands to power the ADC down and up over the wait when it is split.
+ * Refer to `_write_ADC_sequence_commands` in ad5940_electrochemical_utils_sop.c.
+ */
+#define ADC_SEQUENCE_LENGTH(sampling_number, split_number) (4 * (uint32_t)(sampling_number) + 2 + 3 * (uint32_t)(split_number))
+
+/**
+ * Number of sequence commands of the temperature sequence: mux switch, power up and wait,
+ * convert and wait, power down and mux switch back.
+ * Refer to @ref AD5940_ELECTROCHEMICAL_TEMPERATURE_write_sequence_commands.
+ */
+#define TEMPERATURE_SEQUENCE_LENGTH 7
+
+static const AD5940_ELECTROCHEMICAL_DSPCfg_Type *_get_dsp_cfg(
+    const uint8_t path_type,
+    const AD5940_ELECTROCHEMICAL_PATH *const path
+)
+{
+    switch (path_type)
+    {
+    case 0: return path->lpdac_to_lptia->dsp_cfg;
+    case 1: return path->lpdac_to_hstia->dsp_cfg;
+    case 2: return path->hsdac_to_hstia->dsp_cfg;
+    default: return NULL;
+    }
+}
+
+/**
+ * @brief Gets the system clocks of one conversion, as waited by the ADC and temperature sequences.
+ */
+static uint32_t _get_conversion_clocks(
+    const AD5940_ClockConfig *const clock_cfg,
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg,
+    const uint32_t DataType
+)
+{
+    uint32_t WaitClks;
+    ClksCalInfo_Type clks_cal;
+
+    clks_cal.DataType = DataType;
+    clks_cal.DataCount = 1;             /* Sample one data when wakeup */
+    clks_cal.ADCSinc2Osr = dsp_cfg->ADCFilterCfg.ADCSinc2Osr;
+    clks_cal.ADCSinc3Osr = dsp_cfg->ADCFilterCfg.ADCSinc3Osr;
+    clks_cal.ADCAvgNum = dsp_cfg->ADCFilterCfg.ADCAvgNum;
+    clks_cal.ADCRate = clock_cfg->ADCRate;
+    clks_cal.RatioSys2AdcClk = clock_cfg->RatioSys2AdcClk;
+    clks_cal.BpNotch = dsp_cfg->ADCFilterCfg.BpNotch;
+    clks_cal.DftSrc = dsp_cfg->DftCfg.DftSrc;
+    AD5940_ClksCalculate(&clks_cal, &WaitClks);
+
+    return WaitClks;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_PLAN_add_captures(
+    AD5940_ELECTROCHEMICAL_PLAN *const plan,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint8_t path_type,
+    const AD5940_ELECTROCHEMICAL_PATH *const path,
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const uint32_t wakeup_number
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg = _get_dsp_cfg(path_type, path);
+    if(dsp_cfg == NULL) return AD5940ERR_PARA;
+
+    error = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_check(run->electrode_scan, path_type);
+    if(error != AD5940ERR_OK) return error;
+
+    const float SysClkFreq = run->clock_cfg->SysClkFreq;
+    const uint32_t WaitClks = _get_conversion_clocks(run->clock_cfg, dsp_cfg, run->DataType);
+    const uint8_t sampling_number = AD5940_ELECTROCHEMICAL_SAMPLING_get_number(sampling);
+    const uint8_t electrode_number = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_number(run->electrode_scan);
+    const uint32_t scan_clocks = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_clocks(run->electrode_scan, WaitClks, SysClkFreq);
+    const uint32_t scan_settle_clocks = (scan_clocks > 0) ? (uint32_t)(run->electrode_scan->t_settle * SysClkFreq) : 0;
+    const uint32_t settle_clocks = (run->energy_mode == AD5940_ELECTROCHEMICAL_ENERGY_MODE_LOW)
+        ? AD5940_ELECTROCHEMICAL_ENERGY_SETTLE_CLOCKS_LOW
+        : AD5940_ELECTROCHEMICAL_ENERGY_SETTLE_CLOCKS_DEFAULT;
+
+    /* Waits of one ADC wakeup, as generated by the ADC sequence */
+    float awake_clocks = settle_clocks + WaitClks + scan_clocks;
+    float adc_on_clocks = settle_clocks + WaitClks + scan_clocks;
+    float settle_total_clocks = settle_clocks;
+    uint8_t split_number = 0;
+
+    float t_offset;
+    float t_offset_previous;
+    float gap_clocks;
+    error = AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(sampling, 0, &t_offset);
+    if(error != AD5940ERR_OK) return error;
+    for(uint8_t i=1; i<sampling_number; i++)
+    {
+        t_offset_previous = t_offset;
+        error = AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(sampling, i, &t_offset);
+        if(error != AD5940ERR_OK) return error;
+
+        /* Same check as the ADC sequence generation, each capture must start after the previous conversion */
+        gap_clocks = (t_offset - t_offset_previous) * SysClkFreq - WaitClks - scan_clocks;
+        if(gap_clocks < scan_settle_clocks) return AD5940ERR_PARA;
+
+        awake_clocks += gap_clocks + WaitClks + scan_clocks;
+        if((run->energy_mode == AD5940_ELECTROCHEMICAL_ENERGY_MODE_LOW) && (gap_clocks > settle_clocks))
+        {
+            adc_on_clocks += settle_clocks + WaitClks + scan_clocks;
+            settle_total_clocks += settle_clocks;
+            split_number++;
+        }
+        else
+        {
+            adc_on_clocks += gap_clocks + WaitClks + scan_clocks;
+        }
+    }
+
+    plan->sram_words += ADC_SEQUENCE_LENGTH(sampling_number, split_number)
+        + sampling_number * AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_SEQUENCE_LENGTH(electrode_number);
+    plan->wakeup_number += wakeup_number;
+    plan->sample_number += wakeup_number * sampling_number * electrode_number;
+    plan->t_awake += (awake_clocks / SysClkFreq) * (float) wakeup_number;
+    plan->t_adc_on += (adc_on_clocks / SysClkFreq) * (float) wakeup_number;
+    plan->t_settle += (settle_total_clocks / SysClkFreq) * (float) wakeup_number;
+
+    if(run->temperature != NULL)
+    {
+        if(run->temperature->interval == 0) return AD5940ERR_PARA;
+
+        const uint32_t temperature_number = wakeup_number / run->temperature->interval;
+        plan->sram_words += TEMPERATURE_SEQUENCE_LENGTH;
+        plan->wakeup_number += temperature_number;
+        plan->sample_number += temperature_number;
+        const float t_temperature = (TEMPERATURE_SETTLE_CLOCKS + WaitClks) / SysClkFreq;
+        plan->t_awake += t_temperature * (float) temperature_number;
+        plan->t_adc_on += t_temperature * (float) temperature_number;
+        plan->t_settle += (TEMPERATURE_SETTLE_CLOCKS / SysClkFreq) * (float) temperature_number;
+    }
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_PLAN_complete(
+    AD5940_ELECTROCHEMICAL_PLAN *const plan,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint32_t IntSrc
+)
+{
+    if(plan->duration <= 0) return AD5940ERR_PARA;
+
+    plan->sample_rate = (float) plan->sample_number / plan->duration;
+
+    /* One threshold interrupt per FifoThresh data, and one interrupt per sequence with ENDSEQ */
+    plan->irq_rate = 0;
+    if(IntSrc & AFEINTSRC_DATAFIFOTHRESH)
+    {
+        if(run->FifoThresh == 0) return AD5940ERR_PARA;
+        plan->irq_rate += plan->sample_rate / (float) run->FifoThresh;
+    }
+    if(IntSrc & AFEINTSRC_ENDSEQ)
+    {
+        plan->irq_rate += (float) plan->wakeup_number / plan->duration;
+    }
+
+    plan->SeqMemSize = 0;
+    plan->FIFOSize = 0;
+    return AD5940_get_sram_partition(
+        run->sram_partition,
+        plan->sram_words,
+        run->FifoThresh,
+        &plan->SeqMemSize,
+        &plan->FIFOSize
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_PLAN_get_energy(
+    const AD5940_ELECTROCHEMICAL_PLAN *const plan,
+    const AD5940_ELECTROCHEMICAL_ENERGY_MODEL *const model,
+    AD5940_ELECTROCHEMICAL_ENERGY *const energy
+)
+{
+    if(plan->duration <= 0) return AD5940ERR_PARA;
+
+    const float t_hibernate = (plan->duration > plan->t_awake) ? (plan->duration - plan->t_awake) : 0;
+
+    energy->e_hibernate = model->supply_voltage * model->i_hibernate * t_hibernate;
+    energy->e_active = model->supply_voltage * model->i_active * plan->t_awake;
+    energy->e_adc = model->supply_voltage * model->i_adc * plan->t_adc_on;
+    energy->e_settle = model->supply_voltage * model->i_adc * plan->t_settle;
+    energy->e_irq = model->e_irq * plan->irq_rate * plan->duration;
+    energy->energy = energy->e_hibernate + energy->e_active + energy->e_adc + energy->e_irq;
+    energy->energy_per_sample = (plan->sample_number > 0) ? (energy->energy / (float) plan->sample_number) : 0;
+    energy->i_average = energy->energy / (model->supply_voltage * plan->duration);
+
+    return AD5940ERR_OK;
+}
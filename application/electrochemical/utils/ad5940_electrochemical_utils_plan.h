@@ -0,0 +1,112 @@
+/**
+ * @file ad5940_electrochemical_utils_plan.h
+ * @brief Predicts the cost of an electrochemical technique without touching the AD5940.
+ *
+ * A plan is computed from the same configuration as the `*_start` functions: duration,
+ * SRAM footprint of the sequences, number of sequencer wakeups, FIFO data rate and
+ * interrupt rate for the FIFO threshold of the run configuration. The sequence lengths
+ * are counted from the sequences the start would generate, and the conversion times come
+ * from @ref AD5940_ClksCalculate, so no SPI access is made.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils_loop.h"
+#include "ad5940_electrochemical_utils_run.h"
+#include "ad5940_electrochemical_utils_sampling.h"
+
+/**
+ * @brief Predicted cost of a technique.
+ */
+typedef struct
+{
+    float duration;             /**< Duration of the technique, in seconds (s). */
+    uint32_t sram_words;        /**< Number of sequence commands in SRAM, the end of the last sequence. */
+    uint32_t SeqMemSize;        /**< Sequencer memory of the SRAM partition. Refer to @ref SEQMEMSIZE_Const. */
+    uint32_t FIFOSize;          /**< Data FIFO size of the SRAM partition. Refer to @ref FIFOSIZE_Const. */
+    uint32_t wakeup_number;     /**< Number of sequencer wakeups, DAC, ADC and temperature sequences. */
+    uint32_t sample_number;     /**< Number of FIFO data, the temperature data included. */
+    float sample_rate;          /**< FIFO data per second. */
+    float irq_rate;             /**< Interrupts per second on the interrupt GPIO. */
+    float t_awake;              /**< Time the sequencer runs over the technique, the waits of all sequences, in seconds (s). */
+    float t_adc_on;             /**< Part of `t_awake` with the ADC powered, in seconds (s). */
+    float t_settle;             /**< Part of `t_adc_on` waiting for the reference or the ADC to settle, in seconds (s). */
+}
+AD5940_ELECTROCHEMICAL_PLAN;
+
+/**
+ * @brief Adds the ADC wakeups of a technique, and the temperature wakeups interleaved with them, to a plan.
+ *
+ * The ADC sequence and the temperature sequence are counted once in `sram_words`,
+ * the DAC sequences of the technique are added by the caller.
+ * The ADC wakeups follow the energy mode and the electrode scan of the run configuration.
+ *
+ * @param plan              Plan to update.
+ * @param run               Execution and timing configuration.
+ * @param path_type         Type of path. See @ref AD5940_ELECTROCHEMICAL_PATH.
+ * @param path              Configuration of the selected path.
+ * @param sampling          ADC capture points within one wakeup, or NULL for a single capture.
+ * @param wakeup_number     Number of ADC wakeups.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_PARA if the path type is unknown, the electrode scan is invalid or
+ *                     the sampling points are closer than one conversion, as for the start.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_PLAN_add_captures(
+    AD5940_ELECTROCHEMICAL_PLAN *const plan,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint8_t path_type,
+    const AD5940_ELECTROCHEMICAL_PATH *const path,
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const uint32_t wakeup_number
+);
+
+/**
+ * @brief Derives the rates of a plan and the SRAM partition of the run.
+ *
+ * `duration`, `sram_words`, `wakeup_number` and `sample_number` must be set.
+ * The plan is complete even when the sequences don't fit, so the caller can see by how much.
+ *
+ * @param plan              Plan to complete.
+ * @param run               Execution and timing configuration, its FIFO threshold sets the interrupt rate.
+ * @param IntSrc            Interrupt sources enabled on the interrupt GPIO by the technique.
+ *                          Refer to @ref AFEINTC_SRC_Const.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_SEQLEN if the sequences don't fit in the sequencer memory.
+ *                   - AD5940ERR_PARA if the duration is not positive, or the FIFO threshold doesn't fit in the data FIFO.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_PLAN_complete(
+    AD5940_ELECTROCHEMICAL_PLAN *const plan,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint32_t IntSrc
+);
+
+/**
+ * @brief Estimates the energy of a technique from its plan.
+ *
+ * The AD5940 hibernates whenever no sequence runs. The sequence waits are counted,
+ * the execution of the other commands is neglected.
+ *
+ * @param plan              Completed plan.
+ * @param model             Supply currents, e.g. @ref AD5940_ELECTROCHEMICAL_ENERGY_MODEL_TYPICAL.
+ * @param energy            Pointer to store the energy.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_PLAN_get_energy(
+    const AD5940_ELECTROCHEMICAL_PLAN *const plan,
+    const AD5940_ELECTROCHEMICAL_ENERGY_MODEL *const model,
+    AD5940_ELECTROCHEMICAL_ENERGY *const energy
+);
+
+#ifdef __cplusplus
+}
+#endif
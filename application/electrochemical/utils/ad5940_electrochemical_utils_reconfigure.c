@@ -0,0 +1,381 @@
+#include "ad5940_electrochemical_utils_reconfigure.h"
+
+#include <string.h>
+
+#include "ad5940_technique_context.h"
+
+#define AFE_BLOCKS (0 \
+    | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_REFERENCE \
+    | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_LP_LOOP \
+    | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_HS_LOOP \
+    | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_SWITCH_MATRIX \
+    | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_DSP \
+    | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_POWER \
+)
+
+static AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *_get_state(void)
+{
+    return &AD5940_TECHNIQUE_CONTEXT_get()->reconfigure;
+}
+
+static uint32_t _get_checksum(
+    const uint32_t *const commands,
+    const uint32_t length
+)
+{
+    // FNV-1a, only used to tell whether SRAM already holds the commands.
+    uint32_t checksum = 2166136261UL;
+    for(uint32_t i=0; i<length; i++)
+    {
+        checksum = (checksum ^ commands[i]) * 16777619UL;
+    }
+    return checksum;
+}
+
+static BoolFlag _is_different(
+    const void *const staged,
+    const void *const written,
+    const uint32_t size
+)
+{
+    return (memcmp(staged, written, size) != 0) ? bTRUE : bFALSE;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_begin(void)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    memcpy(&state->staged, &state->written, sizeof(AD5940_ELECTROCHEMICAL_RECONFIGURE_AFE_CONFIG));
+    state->active = bTRUE;
+    state->written_blocks = 0;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_end(void)
+{
+    _get_state()->active = bFALSE;
+}
+
+BoolFlag AD5940_ELECTROCHEMICAL_RECONFIGURE_is_active(void)
+{
+    return _get_state()->active;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate(void)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    state->written_mask = 0;
+    memset(state->sequences, 0, sizeof(state->sequences));
+    state->sequence_next = 0;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate_sram(
+    const uint32_t address,
+    const uint32_t length
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    for(uint8_t i=0; i<AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_NUMBER; i++)
+    {
+        if(state->sequences[i].valid == bFALSE) continue;
+        if((state->sequences[i].address + state->sequences[i].length) <= address) continue;
+        if((address + length) <= state->sequences[i].address) continue;
+        state->sequences[i].valid = bFALSE;
+    }
+}
+
+uint32_t AD5940_ELECTROCHEMICAL_RECONFIGURE_get_written_blocks(void)
+{
+    return _get_state()->written_blocks;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_reference(
+    const AFERefCfg_Type *const aferef_cfg
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        memcpy(&state->staged.reference, aferef_cfg, sizeof(AFERefCfg_Type));
+        return;
+    }
+    memcpy(&state->written.reference, aferef_cfg, sizeof(AFERefCfg_Type));
+    AD5940_REFCfgS(&state->written.reference);
+    state->written_mask |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_REFERENCE;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_lp_loop(
+    const LPLoopCfg_Type *const lp_loop_cfg
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        memcpy(&state->staged.lp_loop, lp_loop_cfg, sizeof(LPLoopCfg_Type));
+        return;
+    }
+    memcpy(&state->written.lp_loop, lp_loop_cfg, sizeof(LPLoopCfg_Type));
+    AD5940_LPLoopCfgS(&state->written.lp_loop);
+    state->written_mask |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_LP_LOOP;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_lpamp(
+    const LPAmpCfg_Type *const lp_amp_cfg
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        memcpy(&state->staged.lp_loop.LpAmpCfg, lp_amp_cfg, sizeof(LPAmpCfg_Type));
+        return;
+    }
+    memcpy(&state->written.lp_loop.LpAmpCfg, lp_amp_cfg, sizeof(LPAmpCfg_Type));
+    AD5940_LPAMPCfgS(&state->written.lp_loop.LpAmpCfg);
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_hs_loop(
+    const HSLoopCfg_Type *const hs_loop_cfg
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        memcpy(&state->staged.hs_loop, hs_loop_cfg, sizeof(HSLoopCfg_Type));
+        return;
+    }
+    memcpy(&state->written.hs_loop, hs_loop_cfg, sizeof(HSLoopCfg_Type));
+    AD5940_HSLoopCfgS(&state->written.hs_loop);
+    state->written_mask |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_HS_LOOP | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_SWITCH_MATRIX;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_hstia(
+    const HSTIACfg_Type *const hstia_cfg
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        memcpy(&state->staged.hs_loop.HsTiaCfg, hstia_cfg, sizeof(HSTIACfg_Type));
+        return;
+    }
+    memcpy(&state->written.hs_loop.HsTiaCfg, hstia_cfg, sizeof(HSTIACfg_Type));
+    AD5940_HSTIACfgS(&state->written.hs_loop.HsTiaCfg);
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_switch_matrix(
+    const SWMatrixCfg_Type *const sw_matrix_cfg
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        memcpy(&state->staged.hs_loop.SWMatCfg, sw_matrix_cfg, sizeof(SWMatrixCfg_Type));
+        return;
+    }
+    memcpy(&state->written.hs_loop.SWMatCfg, sw_matrix_cfg, sizeof(SWMatrixCfg_Type));
+    AD5940_SWMatrixCfgS(&state->written.hs_loop.SWMatCfg);
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(
+    const DSPCfg_Type *const dsp_cfg
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        memcpy(&state->staged.dsp, dsp_cfg, sizeof(DSPCfg_Type));
+        return;
+    }
+    memcpy(&state->written.dsp, dsp_cfg, sizeof(DSPCfg_Type));
+    AD5940_DSPCfgS(&state->written.dsp);
+    state->written_mask |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_DSP;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_power(
+    const uint32_t AfeCtrlSet
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bTRUE)
+    {
+        state->staged.AfeCtrlSet = AfeCtrlSet;
+        return;
+    }
+    state->written.AfeCtrlSet = AfeCtrlSet;
+    AD5940_AFECtrlS(AfeCtrlSet, bTRUE);
+    state->written_mask |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_POWER;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_commit(void)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    if(state->active == bFALSE) return;
+
+    uint32_t blocks = 0;
+    uint32_t AfeCtrlOff = 0;
+
+    if(state->written_mask != AFE_BLOCKS)
+    {
+        // Nothing to compare with, same as a full configuration.
+        blocks = AFE_BLOCKS;
+        AfeCtrlOff = AFECTRL_ALL;
+    }
+    else
+    {
+        if(_is_different(&state->staged.reference, &state->written.reference, sizeof(AFERefCfg_Type)))
+        {
+            blocks |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_REFERENCE;
+        }
+        if(_is_different(&state->staged.lp_loop, &state->written.lp_loop, sizeof(LPLoopCfg_Type))
+            || (state->staged.lp_loop.LpDacCfg.PowerEn == bTRUE))
+        {
+            blocks |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_LP_LOOP;
+        }
+        if(_is_different(&state->staged.hs_loop.HsDacCfg, &state->written.hs_loop.HsDacCfg, sizeof(HSDACCfg_Type))
+            || _is_different(&state->staged.hs_loop.HsTiaCfg, &state->written.hs_loop.HsTiaCfg, sizeof(HSTIACfg_Type))
+            || _is_different(&state->staged.hs_loop.WgCfg, &state->written.hs_loop.WgCfg, sizeof(WGCfg_Type))
+            || (state->staged.AfeCtrlSet & AFECTRL_HSDACPWR))
+        {
+            blocks |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_HS_LOOP;
+        }
+        if(_is_different(&state->staged.hs_loop.SWMatCfg, &state->written.hs_loop.SWMatCfg, sizeof(SWMatrixCfg_Type)))
+        {
+            blocks |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_SWITCH_MATRIX;
+        }
+        if(_is_different(&state->staged.dsp, &state->written.dsp, sizeof(DSPCfg_Type)))
+        {
+            blocks |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_DSP;
+        }
+        if(state->staged.AfeCtrlSet != state->written.AfeCtrlSet)
+        {
+            blocks |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_POWER;
+            AfeCtrlOff = state->written.AfeCtrlSet & ~state->staged.AfeCtrlSet;
+        }
+    }
+
+    memcpy(&state->written, &state->staged, sizeof(AD5940_ELECTROCHEMICAL_RECONFIGURE_AFE_CONFIG));
+
+    /* Power down the blocks not used anymore before they are reconfigured */
+    if(AfeCtrlOff) AD5940_AFECtrlS(AfeCtrlOff, bFALSE);
+
+    if(blocks & AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_REFERENCE)
+    {
+        AD5940_REFCfgS(&state->written.reference);
+    }
+    if(blocks & AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_LP_LOOP)
+    {
+        AD5940_LPLoopCfgS(&state->written.lp_loop);
+    }
+    if(blocks & AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_HS_LOOP)
+    {
+        AD5940_HSDacCfgS(&state->written.hs_loop.HsDacCfg);
+        AD5940_HSTIACfgS(&state->written.hs_loop.HsTiaCfg);
+        AD5940_WGCfgS(&state->written.hs_loop.WgCfg);
+    }
+    if(blocks & AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_SWITCH_MATRIX)
+    {
+        AD5940_SWMatrixCfgS(&state->written.hs_loop.SWMatCfg);
+    }
+    if(blocks & AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_DSP)
+    {
+        AD5940_DSPCfgS(&state->written.dsp);
+    }
+    if(blocks & AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_POWER)
+    {
+        AD5940_AFECtrlS(state->written.AfeCtrlSet, bTRUE);
+    }
+
+    state->written_mask = AFE_BLOCKS;
+    state->written_blocks |= blocks;
+}
+
+BoolFlag AD5940_ELECTROCHEMICAL_RECONFIGURE_sram_holds(
+    const uint32_t address,
+    const uint32_t length,
+    const uint32_t checksum
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    for(uint8_t i=0; i<AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_NUMBER; i++)
+    {
+        if((state->sequences[i].valid == bTRUE)
+            && (state->sequences[i].address == address)
+            && (state->sequences[i].length == length)
+            && (state->sequences[i].checksum == checksum))
+        {
+            return bTRUE;
+        }
+    }
+    return bFALSE;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_record_sram(
+    const uint32_t address,
+    const uint32_t length,
+    const uint32_t checksum
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate_sram(address, length);
+
+    /* The overlapping records are gone, take a free one, or the oldest one */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_RECORD *record = NULL;
+    for(uint8_t i=0; i<AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_NUMBER; i++)
+    {
+        if(state->sequences[i].valid == bFALSE)
+        {
+            record = &state->sequences[i];
+            break;
+        }
+    }
+    if(record == NULL)
+    {
+        record = &state->sequences[state->sequence_next];
+        state->sequence_next = (state->sequence_next + 1) % AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_NUMBER;
+    }
+
+    record->valid = bTRUE;
+    record->address = address;
+    record->length = length;
+    record->checksum = checksum;
+}
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_sequence_info(
+    const SEQInfo_Type *const seq_info
+)
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE *const state = _get_state();
+
+    SEQInfo_Type info;
+    memcpy(&info, seq_info, sizeof(SEQInfo_Type));
+
+    if(info.WriteSRAM == bTRUE)
+    {
+        const uint32_t checksum = (info.pSeqCmd != NULL) ? _get_checksum(info.pSeqCmd, info.SeqLen) : 0;
+
+        if((state->active == bTRUE)
+            && (AD5940_ELECTROCHEMICAL_RECONFIGURE_sram_holds(info.SeqRamAddr, info.SeqLen, checksum) == bTRUE))
+        {
+            info.WriteSRAM = bFALSE;
+        }
+        else
+        {
+            AD5940_ELECTROCHEMICAL_RECONFIGURE_record_sram(info.SeqRamAddr, info.SeqLen, checksum);
+            state->written_blocks |= AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_SEQUENCE;
+        }
+    }
+
+    AD5940_SEQInfoCfg(&info);
+}
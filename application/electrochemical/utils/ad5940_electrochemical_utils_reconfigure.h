@@ -0,0 +1,229 @@
+/**
+ * @file ad5940_electrochemical_utils_reconfigure.h
+ * @brief Incremental reconfiguration of the AFE between electrochemical techniques.
+ *
+ * The path configuration functions (`AD5940_ELECTROCHEMICAL_config_afe_*` and
+ * `AD5940_ELECTROCHEMICAL_config_*_adc`) write their blocks through this module, which keeps
+ * the last configuration written to the AD5940.
+ *
+ * Outside of a reconfiguration, the blocks are written as before and recorded.
+ * Between @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_begin and @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_end,
+ * the blocks are staged instead, and @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_commit writes only
+ * the blocks that differ from the recorded ones. The AFE is not powered down in between, so the
+ * references stay powered and settled when they do not change.
+ * The sequences written through @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_sequence_info are not
+ * uploaded to SRAM again when SRAM already holds the same commands at the same address,
+ * so the sequences of several techniques staged at different addresses are all kept.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+
+/**
+ * @brief Blocks of the AFE configuration.
+ */
+typedef enum
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_REFERENCE      = (1 << 0),     /**< @ref AFERefCfg_Type */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_LP_LOOP        = (1 << 1),     /**< LPDAC and LP amplifiers, @ref LPLoopCfg_Type */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_HS_LOOP        = (1 << 2),     /**< HSDAC, waveform generator and HSTIA, @ref HSLoopCfg_Type */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_SWITCH_MATRIX  = (1 << 3),     /**< @ref SWMatrixCfg_Type */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_DSP            = (1 << 4),     /**< @ref DSPCfg_Type */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_POWER          = (1 << 5),     /**< Blocks powered in AFECON, refer to @ref AFECTRL_Const */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_SEQUENCE       = (1 << 6),     /**< Sequence commands uploaded to SRAM */
+}
+AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK;
+
+/**
+ * @brief Number of SRAM ranges recorded, enough for the sequences of a few staged techniques.
+ */
+#define AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_NUMBER 16
+
+/**
+ * @brief AFE configuration recorded or staged by the reconfiguration.
+ */
+typedef struct
+{
+    AFERefCfg_Type reference;
+    LPLoopCfg_Type lp_loop;
+    HSLoopCfg_Type hs_loop;         // SWMatCfg is the switch matrix block.
+    DSPCfg_Type dsp;
+    uint32_t AfeCtrlSet;
+}
+AD5940_ELECTROCHEMICAL_RECONFIGURE_AFE_CONFIG;
+
+/**
+ * @brief Sequence commands recorded in an SRAM range.
+ */
+typedef struct
+{
+    BoolFlag valid;
+    uint32_t address;
+    uint32_t length;
+    uint32_t checksum;
+}
+AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_RECORD;
+
+/**
+ * @brief What the reconfiguration knows about one AD5940, kept in its technique context
+ *        (see @ref AD5940_TECHNIQUE_CONTEXT). Zeroed, it knows nothing.
+ */
+typedef struct
+{
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_AFE_CONFIG written;      // Configuration last written to the AD5940.
+    uint32_t written_mask;                                      // Blocks of written that match the AD5940.
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_AFE_CONFIG staged;       // Configuration staged by the reconfiguration.
+    BoolFlag active;
+    uint32_t written_blocks;
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_RECORD sequences[AD5940_ELECTROCHEMICAL_RECONFIGURE_SEQUENCE_NUMBER];
+    uint8_t sequence_next;                                      // Record replaced when all are valid.
+}
+AD5940_ELECTROCHEMICAL_RECONFIGURE_STATE;
+
+/**
+ * @brief Starts a reconfiguration, the following blocks are staged until
+ *        @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_commit.
+ *
+ * Without a recorded configuration (first start, or after
+ * @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate), the commit writes every block.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_begin(void);
+
+/**
+ * @brief Ends the reconfiguration. Blocks staged but not committed, e.g. after an error, are dropped.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_end(void);
+
+/**
+ * @brief Tells whether a reconfiguration is in progress.
+ *
+ * @return BoolFlag bTRUE between @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_begin and
+ *                  @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_end.
+ */
+BoolFlag AD5940_ELECTROCHEMICAL_RECONFIGURE_is_active(void);
+
+/**
+ * @brief Forgets the recorded configuration, the next reconfiguration writes every block.
+ *
+ * Called by @ref AD5940_shutdown_afe_lploop_hsloop_dsp, by the init and resets of ad5940_main.h
+ * and by the temperature application. Call it after anything else configures the AFE or the SRAM.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate(void);
+
+/**
+ * @brief Forgets the recorded sequences that overlap an SRAM range written by other means.
+ *
+ * @param address   First SRAM address written.
+ * @param length    Number of sequence commands written.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate_sram(
+    const uint32_t address,
+    const uint32_t length
+);
+
+/**
+ * @brief Gets the blocks written to the AD5940 since the last @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_begin.
+ *
+ * @return uint32_t Combination of @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK.
+ */
+uint32_t AD5940_ELECTROCHEMICAL_RECONFIGURE_get_written_blocks(void);
+
+/**
+ * @brief Writes, or stages during a reconfiguration, one block of the AFE configuration.
+ *
+ * The partial blocks (`lpamp`, `hstia`) update their part of the LP and HS loop.
+ * `power` replaces the set of blocks powered in AFECON by `AfeCtrlSet`.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_reference(
+    const AFERefCfg_Type *const aferef_cfg
+);
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_lp_loop(
+    const LPLoopCfg_Type *const lp_loop_cfg
+);
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_lpamp(
+    const LPAmpCfg_Type *const lp_amp_cfg
+);
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_hs_loop(
+    const HSLoopCfg_Type *const hs_loop_cfg
+);
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_hstia(
+    const HSTIACfg_Type *const hstia_cfg
+);
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_switch_matrix(
+    const SWMatrixCfg_Type *const sw_matrix_cfg
+);
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(
+    const DSPCfg_Type *const dsp_cfg
+);
+
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_power(
+    const uint32_t AfeCtrlSet
+);
+
+/**
+ * @brief Writes the staged blocks that differ from the recorded configuration.
+ *
+ * Does nothing outside of a reconfiguration, the blocks are already written.
+ *
+ * @note
+ * The LPDAC and the waveform generator are written whenever they are powered,
+ * because the sequences of the previous technique step their data registers.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_commit(void);
+
+/**
+ * @brief Tells whether SRAM holds the recorded commands at an address.
+ *
+ * @param address   First SRAM address of the commands.
+ * @param length    Number of sequence commands.
+ * @param checksum  Checksum of the commands, computed by the writer.
+ *
+ * @return BoolFlag bTRUE if the same range was recorded with the same checksum, and not overwritten since.
+ */
+BoolFlag AD5940_ELECTROCHEMICAL_RECONFIGURE_sram_holds(
+    const uint32_t address,
+    const uint32_t length,
+    const uint32_t checksum
+);
+
+/**
+ * @brief Records commands written to SRAM by other means than @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_sequence_info,
+ *        e.g. the DAC sequences of a waveform. The overlapping records are forgotten.
+ *
+ * @param address   First SRAM address written.
+ * @param length    Number of sequence commands written.
+ * @param checksum  Checksum of the commands, computed by the writer.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_record_sram(
+    const uint32_t address,
+    const uint32_t length,
+    const uint32_t checksum
+);
+
+/**
+ * @brief Configures a sequence, like `AD5940_SEQInfoCfg`.
+ *
+ * During a reconfiguration, the SRAM upload is skipped when SRAM already holds the same
+ * commands at the same address. The sequence info register is always written.
+ *
+ * @param seq_info  Sequence to configure.
+ */
+void AD5940_ELECTROCHEMICAL_RECONFIGURE_sequence_info(
+    const SEQInfo_Type *const seq_info
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,6 +20,14 @@ typedef struct
     uint32_t DataType;                      /**< Data type configuration. @ref DATATYPE_Const. */
     uint32_t FifoSrc;                       /**< FIFO source configuration. @ref FIFOSRC_Const*/
     uint16_t FifoThresh;                    /**< FIFO threshold value. Interrupt is triggered when this threshold is reached. */
+    AD5940_SRAM_PARTITION sram_partition;   /**< Split of SRAM between sequences and data FIFO, zero for @ref AD5940_SRAM_PARTITION_AUTO.
+                                                 Refer to utils/ad5940_utils_fifo.h. */
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *temperature;   /**< Interleaved temperature capture, or NULL to disable it.
+                                                                         Refer to ad5940_electrochemical_utils_temperature.h. */
+    AD5940_ELECTROCHEMICAL_ENERGY_MODE energy_mode;                 /**< Energy mode of the ADC wakeups, zero for @ref AD5940_ELECTROCHEMICAL_ENERGY_MODE_DEFAULT.
+                                                                         Refer to ad5940_electrochemical_utils_energy.h. */
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *electrode_scan;    /**< Electrodes converted in turn at each capture, or NULL for the routed electrode.
+                                                                         Refer to ad5940_electrochemical_utils_electrode_scan.h. */
 }
 AD5940_ELECTROCHEMICAL_RUN_CONFIG;
 
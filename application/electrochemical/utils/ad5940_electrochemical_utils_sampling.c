@@ -0,0 +1,61 @@
+#include "ad5940_electrochemical_utils_sampling.h"
+
+AD5940Err AD5940_ELECTROCHEMICAL_SAMPLING_check(
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const float t_step
+)
+{
+    uint8_t number = AD5940_ELECTROCHEMICAL_SAMPLING_get_number(sampling);
+    float t_previous = 0;
+    float t_offset;
+
+    if(number > AD5940_ELECTROCHEMICAL_SAMPLING_NUMBER_MAX) return AD5940ERR_PARA;
+
+    for(uint8_t i=0; i<number; i++)
+    {
+        AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(
+            sampling,
+            i,
+            &t_offset
+        );
+        if(t_offset <= t_previous) return AD5940ERR_PARA;
+        t_previous = t_offset;
+    }
+    if(t_previous >= t_step) return AD5940ERR_PARA;
+
+    /* The wakeup timer counts LFOSCClkFreq * t - 1 clocks before the first capture and after it */
+    AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(
+        sampling,
+        0,
+        &t_offset
+    );
+    if(t_offset < AD5940_ELECTROCHEMICAL_SAMPLING_WAKEUP_T_MIN) return AD5940ERR_PARA;
+    if((t_step - t_offset) < AD5940_ELECTROCHEMICAL_SAMPLING_WAKEUP_T_MIN) return AD5940ERR_PARA;
+
+    return AD5940ERR_OK;
+}
+
+uint8_t AD5940_ELECTROCHEMICAL_SAMPLING_get_number(
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling
+)
+{
+    if(sampling == NULL) return 1;
+    if(sampling->number == 0) return 1;
+    return sampling->number;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const uint8_t index,
+    float *const t_offset
+)
+{
+    if(index >= AD5940_ELECTROCHEMICAL_SAMPLING_get_number(sampling)) return AD5940ERR_PARA;
+    if((sampling == NULL) || (sampling->number == 0))
+    {
+        *t_offset = AD5940_ELECTROCHEMICAL_SAMPLING_DEFAULT_OFFSET;
+        return AD5940ERR_OK;
+    }
+    *t_offset = sampling->t_offset[index];
+    return AD5940ERR_OK;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+
+/**
+ * @brief Maximum number of ADC captures per DAC step.
+ */
+#define AD5940_ELECTROCHEMICAL_SAMPLING_NUMBER_MAX 8
+
+/**
+ * @brief Offset of the ADC capture used when no sampling point is configured, in seconds (s).
+ */
+#define AD5940_ELECTROCHEMICAL_SAMPLING_DEFAULT_OFFSET 0.001f
+
+/**
+ * @brief Shortest wakeup timer period around a sampling point, in seconds (s):
+ *        3 periods of the nominal 32 kHz LFOSC. A shorter period would truncate
+ *        `LFOSCClkFreq * t - 1` below zero and wrap the wakeup timer count.
+ */
+#define AD5940_ELECTROCHEMICAL_SAMPLING_WAKEUP_T_MIN (3.0f / 32000.0f)
+
+/**
+ * @brief ADC capture points within one DAC step.
+ * 
+ * The sequencer wakes up once per DAC step at `t_offset[0]` and performs all captures 
+ * in the same wakeup, so the FIFO receives `number` data per DAC step.
+ * 
+ * @note
+ * The ADC reference is powered up for 250 us once per wakeup before the first capture, 
+ * so the conversion of capture k starts at `t_offset[k]` + 250 us.
+ * Keep the offsets of consecutive captures apart by at least the conversion time.
+ * 
+ * Leave the structure zeroed to keep the default single capture 
+ * @ref AD5940_ELECTROCHEMICAL_SAMPLING_DEFAULT_OFFSET after each DAC step.
+ */
+typedef struct
+{
+    uint8_t number;                                                 /**< Number of ADC captures per DAC step, up to @ref AD5940_ELECTROCHEMICAL_SAMPLING_NUMBER_MAX. 
+                                                                         0 selects the default single capture. */
+    float t_offset[AD5940_ELECTROCHEMICAL_SAMPLING_NUMBER_MAX];     /**< Offset of each capture from the DAC update, in seconds (s). Must be strictly ascending. */
+}
+AD5940_ELECTROCHEMICAL_SAMPLING;
+
+/**
+ * @brief Checks that the sampling points fit in a DAC step.
+ * 
+ * The first capture and the rest of the DAC step after it are each timed by the wakeup timer,
+ * both must last at least @ref AD5940_ELECTROCHEMICAL_SAMPLING_WAKEUP_T_MIN.
+ * 
+ * @param sampling  Sampling points to check.
+ * @param t_step    Shortest duration of a DAC step using these sampling points, in seconds (s).
+ * 
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_SAMPLING_check(
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const float t_step
+);
+
+/**
+ * @brief Gets the number of ADC captures per DAC step.
+ * 
+ * @param sampling  Sampling points, or NULL for the default single capture.
+ * 
+ * @return uint8_t  Number of ADC captures per DAC step (at least 1).
+ */
+uint8_t AD5940_ELECTROCHEMICAL_SAMPLING_get_number(
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling
+);
+
+/**
+ * @brief Gets the offset of an ADC capture from the DAC update.
+ * 
+ * @param sampling  Sampling points, or NULL for the default single capture.
+ * @param index     Index of the capture within the DAC step.
+ * @param t_offset  Pointer to store the offset, in seconds (s).
+ * 
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const uint8_t index,
+    float *const t_offset
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,26 +4,28 @@
 #include "ad5940_utils.h"
 
 #include "ad5940_electrochemical_utils.h"
+#include "ad5940_technique_context.h"
 
-static SEQInfo_Type _ADC_seq_info = {
-    .SeqId = SEQID_0,
-    .WriteSRAM = bTRUE,
-};
+static AD5940_ELECTROCHEMICAL_SOP_STATE *_get_state(void)
+{
+    return &AD5940_TECHNIQUE_CONTEXT_get()->sop;
+}
 
 void AD5940_ELECTROCHEMICAL_UTILITY_get_ADC_seq_info(
     SEQInfo_Type **ADC_seq_info
 )
 {
-    *ADC_seq_info = &_ADC_seq_info;
+    *ADC_seq_info = &_get_state()->ADC_seq_info;
     return;
 }
 
 static void _get_SEQCfg_Type(
     SEQCfg_Type *const type, 
-    BoolFlag enable
+    BoolFlag enable,
+    const uint32_t SeqMemSize
 )
 {
-    type->SeqMemSize = SEQMEMSIZE_2KB;  /* 2kB SRAM is used for sequencer, others for data FIFO */
+    type->SeqMemSize = SeqMemSize;      /* SRAM used for sequencer, others for data FIFO */
     type->SeqBreakEn = bFALSE;
     type->SeqIgnoreEn = bTRUE;
     type->SeqCntCRCClr = bTRUE;
@@ -34,12 +36,13 @@ static void _get_SEQCfg_Type(
 
 static void _get_FIFOCfg_Type(
     FIFOCfg_Type *const type, 
-    BoolFlag enable
+    BoolFlag enable,
+    const uint32_t FIFOSize
 )
 {
     type->FIFOEn = enable;
     type->FIFOMode = FIFOMODE_FIFO;
-    type->FIFOSize = FIFOSIZE_4KB;
+    type->FIFOSize = FIFOSize;
     return;
 }
 
@@ -81,7 +84,10 @@ static AD5940Err _write_ADC_sequence_commands(
     const uint32_t ADCSinc3Osr,
     const BoolFlag BpNotch,
     const uint32_t DataCount,
-    const uint32_t DataType
+    const uint32_t DataType,
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const AD5940_ELECTROCHEMICAL_ENERGY_MODE energy_mode,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan
 )
 {
 	AD5940Err error = AD5940ERR_OK;
@@ -92,6 +98,14 @@ static AD5940Err _write_ADC_sequence_commands(
 	uint32_t WaitClks;
     ClksCalInfo_Type clks_cal;
 
+    uint8_t sampling_number = AD5940_ELECTROCHEMICAL_SAMPLING_get_number(sampling);
+    float t_offset;
+    float t_offset_previous;
+    float gap_clocks;
+    const uint32_t settle_clocks = (energy_mode == AD5940_ELECTROCHEMICAL_ENERGY_MODE_LOW)
+        ? AD5940_ELECTROCHEMICAL_ENERGY_SETTLE_CLOCKS_LOW
+        : AD5940_ELECTROCHEMICAL_ENERGY_SETTLE_CLOCKS_DEFAULT;
+
     _get_ClksCalInfo_Type(
         &clks_cal,
         clock_cfg,
@@ -105,12 +119,45 @@ static AD5940Err _write_ADC_sequence_commands(
     );
 	AD5940_ClksCalculate(&clks_cal, &WaitClks);
 
+    /* Each capture point converts the first electrode, then scans the following ones */
+    const uint32_t scan_clocks = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_clocks(electrode_scan, WaitClks, clock_cfg->SysClkFreq);
+    const uint32_t scan_settle_clocks = (scan_clocks > 0) ? (uint32_t)(electrode_scan->t_settle * clock_cfg->SysClkFreq) : 0;
+
 	AD5940_SEQGenCtrl(bTRUE);
     
 	AD5940_AFECtrlS(AFECTRL_ADCPWR | AFECTRL_SINC2NOTCH, bTRUE);
-	AD5940_SEQGenInsert(SEQ_WAIT(16*250));  /* wait 250us for reference power up */
-	AD5940_AFECtrlS(AFECTRL_ADCCNV, bTRUE);  /* Start ADC convert and DFT */
-	AD5940_SEQGenInsert(SEQ_WAIT(WaitClks));  /* wait for first data ready */
+	AD5940_SEQGenInsert(SEQ_WAIT(settle_clocks));  /* wait for reference power up, or for the ADC to settle in low energy mode */
+    for(uint8_t i=0; i<sampling_number; i++)
+    {
+        if(i > 0)
+        {
+            /* Stay awake until the next sampling point, the conversion time is already elapsed. */
+            AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(sampling, i - 1, &t_offset_previous);
+            AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(sampling, i, &t_offset);
+            gap_clocks = (t_offset - t_offset_previous) * clock_cfg->SysClkFreq - WaitClks - scan_clocks;
+            if(gap_clocks < scan_settle_clocks)  /* The first electrode settles over the gap */
+            {
+                AD5940_SEQGenCtrl(bFALSE);
+                return AD5940ERR_PARA;
+            }
+            if((energy_mode == AD5940_ELECTROCHEMICAL_ENERGY_MODE_LOW) && (gap_clocks > settle_clocks))
+            {
+                /* Power the ADC down over a long gap, powering it up again only costs the settling wait */
+                AD5940_AFECtrlS(AFECTRL_ADCPWR | AFECTRL_SINC2NOTCH, bFALSE);
+                AD5940_SEQGenInsert(SEQ_WAIT((uint32_t) gap_clocks - settle_clocks));
+                AD5940_AFECtrlS(AFECTRL_ADCPWR | AFECTRL_SINC2NOTCH, bTRUE);
+                AD5940_SEQGenInsert(SEQ_WAIT(settle_clocks));
+            }
+            else
+            {
+                AD5940_SEQGenInsert(SEQ_WAIT((uint32_t) gap_clocks));
+            }
+        }
+	    AD5940_AFECtrlS(AFECTRL_ADCCNV, bTRUE);  /* Start ADC convert and DFT */
+	    AD5940_SEQGenInsert(SEQ_WAIT(WaitClks));  /* wait for first data ready */
+	    AD5940_AFECtrlS(AFECTRL_ADCCNV, bFALSE);  /* Stop ADC convert, keep the reference powered for the next capture */
+        AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_write_sequence_commands(electrode_scan, WaitClks, clock_cfg->SysClkFreq);
+    }
 	AD5940_AFECtrlS(AFECTRL_ADCPWR | AFECTRL_ADCCNV | AFECTRL_SINC2NOTCH, bFALSE);  /* Stop ADC */
 	// AD5940_EnterSleepS();/* Goto hibernate */
 	/* Sequence end. */
@@ -119,11 +166,12 @@ static AD5940Err _write_ADC_sequence_commands(
 
     if(error != AD5940ERR_OK) return error;
 
+    SEQInfo_Type *const ADC_seq_info = &_get_state()->ADC_seq_info;
     *sequence_length = SeqLen;
-    _ADC_seq_info.SeqRamAddr = start_address;
-    _ADC_seq_info.pSeqCmd = pSeqCmd;
-    _ADC_seq_info.SeqLen = SeqLen;
-    AD5940_SEQInfoCfg(&_ADC_seq_info);
+    ADC_seq_info->SeqRamAddr = start_address;
+    ADC_seq_info->pSeqCmd = pSeqCmd;
+    ADC_seq_info->SeqLen = SeqLen;
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_sequence_info(ADC_seq_info);
 
 	return AD5940ERR_OK;
 }
@@ -136,12 +184,16 @@ static void _start()
     SEQCfg_Type seq_cfg;
     FIFOCfg_Type fifo_cfg;
     
-    /* Configure sequencer and stop it */
-    _get_SEQCfg_Type(&seq_cfg, bFALSE);
+    /**
+     * Configure sequencer and stop it.
+     * The sequences are written with the largest sequencer memory,
+     * @ref AD5940_ELECTROCHEMICAL_configure_sram gives the rest to the data FIFO before the run.
+     */
+    _get_SEQCfg_Type(&seq_cfg, bFALSE, SEQMEMSIZE_4KB);
     AD5940_SEQCfg(&seq_cfg);
 
     /* Reconfigure FIFO */
-    _get_FIFOCfg_Type(&fifo_cfg, bFALSE);
+    _get_FIFOCfg_Type(&fifo_cfg, bFALSE, FIFOSIZE_2KB);
     AD5940_FIFOCfg(&fifo_cfg);
     
     /**
@@ -160,6 +212,9 @@ AD5940Err AD5940_ELECTROCHEMICAL_write_sequence_commands_config(
     const BoolFlag BpNotch,
     const uint32_t DataCount,
     const uint32_t DataType,
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const AD5940_ELECTROCHEMICAL_ENERGY_MODE energy_mode,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
     uint32_t *const sequence_address
 )
 {
@@ -167,7 +222,7 @@ AD5940Err AD5940_ELECTROCHEMICAL_write_sequence_commands_config(
 
     _start();
 
-    *sequence_address = 0x00;
+    *sequence_address = _get_state()->sequence_base;
     uint32_t sequence_commands_length = 0;
 
     error = _write_ADC_sequence_commands(
@@ -180,10 +235,43 @@ AD5940Err AD5940_ELECTROCHEMICAL_write_sequence_commands_config(
         ADCSinc3Osr,
         BpNotch,
         DataCount,
-        DataType
+        DataType,
+        sampling,
+        energy_mode,
+        electrode_scan
     );
     if(error != AD5940ERR_OK) return AD5940ERR_PARA;
     *sequence_address += sequence_commands_length;
 
     return AD5940ERR_OK;
 }
+
+void AD5940_ELECTROCHEMICAL_set_sequence_region(
+    const uint32_t base,
+    const uint32_t reserved_end
+)
+{
+    AD5940_ELECTROCHEMICAL_SOP_STATE *const state = _get_state();
+
+    state->sequence_base = base;
+    state->sequence_reserved_end = reserved_end;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_configure_sram(
+    const AD5940_SRAM_PARTITION partition,
+    const uint32_t sequence_end,
+    const uint32_t FifoThresh
+)
+{
+    const uint32_t reserved_end = _get_state()->sequence_reserved_end;
+
+    SEQCfg_Type seq_cfg;
+    _get_SEQCfg_Type(&seq_cfg, bFALSE, SEQMEMSIZE_4KB);
+
+    return AD5940_configure_sram(
+        partition,
+        (sequence_end > reserved_end) ? sequence_end : reserved_end,
+        FifoThresh,
+        &seq_cfg
+    );
+}
@@ -20,6 +20,18 @@ extern "C"
 #include "ad5940_utils.h"
 #include "ad5940_electrochemical_utils.h"
 
+/**
+ * @brief ADC sequence and SRAM layout of one AD5940, kept in its technique context
+ *        (see @ref AD5940_TECHNIQUE_CONTEXT).
+ */
+typedef struct
+{
+    SEQInfo_Type ADC_seq_info;          // ADC sequence, on SEQID_0.
+    uint32_t sequence_base;             // SRAM address of the ADC sequence.
+    uint32_t sequence_reserved_end;     // Sequencer memory kept for the staged sequences.
+}
+AD5940_ELECTROCHEMICAL_SOP_STATE;
+
 /**
  * @brief Retrieves the sequence information for ADC sampling.
  * 
@@ -49,6 +61,12 @@ void AD5940_ELECTROCHEMICAL_UTILITY_get_ADC_seq_info(
  *                         in utility/ad5940_utility_power.h.
  * @param DataType         The data type configuration for ADC outputs. 
  *                         Refer to @ref DATATYPE_Const for options.
+ * @param sampling         ADC capture points within one wakeup, or NULL for a single capture.
+ *                         See @ref AD5940_ELECTROCHEMICAL_SAMPLING.
+ * @param energy_mode      Settling wait and ADC power between captures.
+ *                         See @ref AD5940_ELECTROCHEMICAL_ENERGY_MODE.
+ * @param electrode_scan   Electrodes converted in turn at each capture point, or NULL for the routed electrode.
+ *                         See @ref AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN.
  * @param sequence_address Pointer to store the address of the written sequence.
  * 
  * @return AD5940Err       Error code indicating success or failure of the operation:
@@ -64,9 +82,50 @@ AD5940Err AD5940_ELECTROCHEMICAL_write_sequence_commands_config(
     const BoolFlag BpNotch,
     const uint32_t DataCount,
     const uint32_t DataType,
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const AD5940_ELECTROCHEMICAL_ENERGY_MODE energy_mode,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN *const electrode_scan,
     uint32_t *const sequence_address
 );
 
+/**
+ * @brief Places the sequences of the next techniques in SRAM.
+ * 
+ * The ADC sequence is written at `base`, and the other sequences of the technique follow it.
+ * @ref AD5940_ELECTROCHEMICAL_configure_sram keeps at least `reserved_end` sequence commands
+ * of sequencer memory, so the sequences staged for the following techniques are not
+ * overwritten by the data FIFO. Both are zero by default, set them back to zero when done.
+ * 
+ * @param base             SRAM address of the ADC sequence (in sequence commands).
+ * @param reserved_end     End of the sequences to keep in SRAM (in sequence commands).
+ */
+void AD5940_ELECTROCHEMICAL_set_sequence_region(
+    const uint32_t base,
+    const uint32_t reserved_end
+);
+
+/**
+ * @brief Splits SRAM between the written sequences and the data FIFO, right before the run.
+ * 
+ * The sequences are written with 4kB of sequencer memory. This function then gives
+ * the SRAM not used by the sequences to the data FIFO, refer to @ref AD5940_configure_sram.
+ * The sequencer memory also covers the region reserved by @ref AD5940_ELECTROCHEMICAL_set_sequence_region.
+ * The sequencer and the data FIFO are left disabled.
+ * 
+ * @param partition        Requested partition, @ref AD5940_SRAM_PARTITION_AUTO to size it from the sequences.
+ * @param sequence_end     End of the last sequence in SRAM (in sequence commands).
+ * @param FifoThresh       FIFO threshold of the run, it must fit in the data FIFO.
+ * 
+ * @return AD5940Err       Error code indicating success or failure of the operation:
+ *                         - `AD5940ERR_SEQLEN`: The sequences do not fit the sequencer memory.
+ *                         - `AD5940ERR_PARA`: The FIFO threshold does not fit the data FIFO.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_configure_sram(
+    const AD5940_SRAM_PARTITION partition,
+    const uint32_t sequence_end,
+    const uint32_t FifoThresh
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -8,6 +8,8 @@ extern "C"
 #include "ad5940_electrochemical_utils_electrode_routing.h"
 #include "ad5940_electrochemical_utils_afe_dac_tia_struct.h"
 #include "ad5940_electrochemical_utils_dac_tia_adc_struct.h"
+#include "ad5940_electrochemical_utils_sampling.h"
+#include "ad5940_electrochemical_utils_temperature.h"
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,105 @@
+#include "ad5940_electrochemical_utils_temperature.h"
+
+#include "ad5940_electrochemical_utils_reconfigure.h"
+#include "ad5940_technique_context.h"
+
+void AD5940_ELECTROCHEMICAL_TEMPERATURE_get_seq_info(
+    SEQInfo_Type **temperature_seq_info
+)
+{
+    *temperature_seq_info = &AD5940_TECHNIQUE_CONTEXT_get()->electrochemical_temperature_seq_info;
+    return;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_TEMPERATURE_write_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    const AD5940_ClockConfig *const clock_cfg,
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg,
+    const uint32_t ADCMuxP,
+    const uint32_t ADCMuxN,
+    const uint32_t DataType,
+    const uint32_t start_address,
+    uint32_t *const sequence_length
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    const uint32_t *pSeqCmd;
+    uint32_t SeqLen;
+
+    uint32_t WaitClks;
+    ClksCalInfo_Type clks_cal;
+    ADCBaseCfg_Type adc_base;
+
+    clks_cal.DataType = DataType;
+    clks_cal.DataCount = 1;             /* Sample one data when wakeup */
+    clks_cal.ADCSinc2Osr = dsp_cfg->ADCFilterCfg.ADCSinc2Osr;
+    clks_cal.ADCSinc3Osr = dsp_cfg->ADCFilterCfg.ADCSinc3Osr;
+    clks_cal.ADCAvgNum = dsp_cfg->ADCFilterCfg.ADCAvgNum;
+    clks_cal.ADCRate = clock_cfg->ADCRate;
+    clks_cal.RatioSys2AdcClk = clock_cfg->RatioSys2AdcClk;
+    clks_cal.BpNotch = dsp_cfg->ADCFilterCfg.BpNotch;
+    clks_cal.DftSrc = dsp_cfg->DftCfg.DftSrc;
+    AD5940_ClksCalculate(&clks_cal, &WaitClks);
+
+    AD5940_SEQGenCtrl(bTRUE);
+
+    /* Switch the ADC to the temperature sensor */
+    adc_base.ADCMuxP = ADCMUXP_TEMPP;
+    adc_base.ADCMuxN = ADCMUXN_TEMPN;
+    adc_base.ADCPga = temperature->ADCPga;
+    AD5940_ADCBaseCfgS(&adc_base);
+
+    AD5940_AFECtrlS(AFECTRL_TEMPSPWR | AFECTRL_ADCPWR | AFECTRL_SINC2NOTCH, bTRUE);
+    AD5940_SEQGenInsert(SEQ_WAIT(16*250));  /* wait 250us for reference and temperature sensor power up */
+    AD5940_AFECtrlS(AFECTRL_TEMPCNV | AFECTRL_ADCCNV, bTRUE);  /* Start ADC convert */
+    AD5940_SEQGenInsert(SEQ_WAIT(WaitClks));  /* wait for data ready */
+    AD5940_AFECtrlS(AFECTRL_TEMPSPWR | AFECTRL_TEMPCNV | AFECTRL_ADCPWR | AFECTRL_ADCCNV | AFECTRL_SINC2NOTCH, bFALSE);  /* Stop ADC */
+
+    /* Switch the ADC back to the technique */
+    adc_base.ADCMuxP = ADCMuxP;
+    adc_base.ADCMuxN = ADCMuxN;
+    adc_base.ADCPga = dsp_cfg->ADCPga;
+    AD5940_ADCBaseCfgS(&adc_base);
+
+    error = AD5940_SEQGenFetchSeq(&pSeqCmd, &SeqLen);
+    AD5940_SEQGenCtrl(bFALSE); /* Stop sequencer generator */
+
+    if(error != AD5940ERR_OK) return error;
+
+    SEQInfo_Type *const temperature_seq_info = &AD5940_TECHNIQUE_CONTEXT_get()->electrochemical_temperature_seq_info;
+    *sequence_length = SeqLen;
+    temperature_seq_info->SeqRamAddr = start_address;
+    temperature_seq_info->pSeqCmd = pSeqCmd;
+    temperature_seq_info->SeqLen = SeqLen;
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_sequence_info(temperature_seq_info);
+
+    AD5940_WriteReg(REG_AFE_TEMPSENS, temperature->TEMPSENS);
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_TEMPERATURE_get_fifo_count(
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    const uint16_t wakeup_number,
+    uint16_t *const FIFO_count
+)
+{
+    if(temperature == NULL)
+    {
+        *FIFO_count = 0;
+        return AD5940ERR_OK;
+    }
+    if(temperature->interval == 0) return AD5940ERR_PARA;
+
+    *FIFO_count = wakeup_number / temperature->interval;
+
+    return AD5940ERR_OK;
+}
+
+BoolFlag AD5940_ELECTROCHEMICAL_TEMPERATURE_is_temperature_data(
+    const uint32_t fifo_data
+)
+{
+    return (AD5940_ELECTROCHEMICAL_FIFO_SEQID(fifo_data) == AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID) ? bTRUE : bFALSE;
+}
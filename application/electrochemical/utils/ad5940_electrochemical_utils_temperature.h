@@ -0,0 +1,122 @@
+/**
+ * @file ad5940_electrochemical_utils_temperature.h
+ * @brief Interleaves temperature captures with the ADC samples of electrochemical techniques.
+ *
+ * The temperature sequence runs on @ref AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID. It switches
+ * the ADC mux to the internal temperature sensor, converts once, and switches the mux back
+ * to the TIA of the technique, so the electrochemical run continues without reconfiguration.
+ * The FIFO tags every data with the sequence ID that produced it, which separates the
+ * temperature data from the current data.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils_dac_tia_adc_struct.h"
+
+/**
+ * @brief Sequence ID of the temperature sequence.
+ */
+#define AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID SEQID_3
+
+/**
+ * @brief Maximum number of ADC wakeups per temperature capture.
+ *
+ * Chronoamperometry uses one wakeup timer slot per ADC wakeup plus one slot for the temperature,
+ * out of the 8 slots of the wakeup timer.
+ */
+#define AD5940_ELECTROCHEMICAL_TEMPERATURE_INTERVAL_MAX 7
+
+/**
+ * @brief Gets the sequence ID of a FIFO data. Refer to datasheet page 108.
+ */
+#define AD5940_ELECTROCHEMICAL_FIFO_SEQID(fifo_data) (((fifo_data) >> 23) & 0x3)
+
+/**
+ * @brief Configuration of the interleaved temperature capture.
+ */
+typedef struct
+{
+    uint8_t interval;       /**< Number of ADC wakeups per temperature capture.
+                                 - Chronoamperometry: 1 to @ref AD5940_ELECTROCHEMICAL_TEMPERATURE_INTERVAL_MAX.
+                                 - Waveform techniques (CV, DPV, SWV, NPV, LSV): 2, one capture after every pair of DAC levels. */
+    uint32_t ADCPga;        /**< ADC PGA used for the temperature sensor. Refer to @ref ADCPGA_Const. */
+    uint32_t TEMPSENS;      /**< Temperature sensor configuration. Refer to page 57 and 61 of the datasheet. */
+}
+AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG;
+
+/**
+ * @brief Retrieves the sequence information of the temperature sequence.
+ *
+ * @param temperature_seq_info Pointer to a `SEQInfo_Type` pointer where the temperature sequence
+ *                             information will be stored.
+ */
+void AD5940_ELECTROCHEMICAL_TEMPERATURE_get_seq_info(
+    SEQInfo_Type **temperature_seq_info
+);
+
+/**
+ * @brief Writes the temperature sequence to SRAM.
+ *
+ * The temperature sequence uses the same ADC filter as the electrochemical technique.
+ *
+ * @param temperature       Temperature configuration.
+ * @param clock_cfg         Clock configuration.
+ * @param dsp_cfg           DSP configuration of the technique.
+ * @param ADCMuxP           Positive ADC mux of the technique to restore. Refer to @ref ADCMUXP_Const.
+ * @param ADCMuxN           Negative ADC mux of the technique to restore. Refer to @ref ADCMUXN_Const.
+ * @param DataType          The data type configuration for ADC outputs. Refer to @ref DATATYPE_Const.
+ * @param start_address     SRAM address of the temperature sequence.
+ * @param sequence_length   Pointer to store the number of sequence commands written.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_TEMPERATURE_write_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    const AD5940_ClockConfig *const clock_cfg,
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg,
+    const uint32_t ADCMuxP,
+    const uint32_t ADCMuxN,
+    const uint32_t DataType,
+    const uint32_t start_address,
+    uint32_t *const sequence_length
+);
+
+/**
+ * @brief Gets the number of temperature data produced during a number of ADC wakeups.
+ *
+ * The techniques' `get_fifo_count` functions only count the current data,
+ * add this count to them when the temperature capture is enabled.
+ *
+ * @param temperature       Temperature configuration, or NULL when the temperature capture is disabled.
+ * @param wakeup_number     Number of ADC wakeups.
+ * @param FIFO_count        Pointer to store the number of temperature data.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_TEMPERATURE_get_fifo_count(
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    const uint16_t wakeup_number,
+    uint16_t *const FIFO_count
+);
+
+/**
+ * @brief Checks whether a FIFO data is produced by the temperature sequence.
+ *
+ * @param fifo_data     Data read from the FIFO.
+ *
+ * @return BoolFlag     bTRUE for temperature data, bFALSE for current data.
+ */
+BoolFlag AD5940_ELECTROCHEMICAL_TEMPERATURE_is_temperature_data(
+    const uint32_t fifo_data
+);
+
+#ifdef __cplusplus
+}
+#endif
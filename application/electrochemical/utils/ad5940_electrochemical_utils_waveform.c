@@ -0,0 +1,1196 @@
+#include "ad5940_electrochemical_utils_waveform.h"
+
+#include "ad5940_electrochemical_utils.h"
+#include "ad5940_technique_context.h"
+
+#include <math.h>
+#include <string.h>
+
+#define SEQLEN_ONESTEP AD5940_ELECTROCHEMICAL_WAVEFORM_SEQLEN_ONESTEP
+#define SEQLEN_STATIC AD5940_ELECTROCHEMICAL_WAVEFORM_SEQLEN_STATIC
+#define DAC_0_SEQID AD5940_ELECTROCHEMICAL_WAVEFORM_DAC_0_SEQID
+#define DAC_1_SEQID AD5940_ELECTROCHEMICAL_WAVEFORM_DAC_1_SEQID
+#define DAC_2_SEQID AD5940_ELECTROCHEMICAL_WAVEFORM_DAC_2_SEQID
+
+#define WRITE_BATCH_STEP 8  /* How many DAC levels are written to SRAM at once. */
+#define DAC_WAIT_CLOCKS 10  /* Wait of every DAC sequence for the LPDAC or HSDAC update. */
+
+static inline float _get_e_step_real(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment
+)
+{
+    return (segment->e_end > segment->e_begin)
+        ? segment->e_step
+        : -segment->e_step;
+}
+
+static inline uint16_t _get_step_number_ramp(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment
+)
+{
+    float total = fabsf((segment->e_end - segment->e_begin) / segment->e_step);
+    float intpart;
+    float frac = modff(total, &intpart);
+
+    if (frac > 1e-5f) {  // If the fractional part is greater than epsilon, round up unconditionally
+        return (uint16_t)(intpart + 1.0f);
+    } else {
+        return (uint16_t)(intpart);  // Otherwise, treat it as an integer without rounding up
+    }
+}
+
+static inline uint16_t _get_step_number_pulse(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment
+)
+{
+    float total = fabsf((segment->e_end - segment->e_begin) / segment->e_step);
+    float intpart;
+    modff(total, &intpart);
+    return (uint16_t)(intpart + 1.0f);
+}
+
+static uint32_t _get_segment_level_number(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment
+)
+{
+    switch (segment->type)
+    {
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_RAMP:
+        return _get_step_number_ramp(segment);
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_HOLD:
+        return segment->number;
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE:
+        return ((uint32_t) _get_step_number_pulse(segment)) * 2;
+    }
+    return 0;
+}
+
+static float _get_segment_potential_at_index(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment,
+    const uint16_t index,
+    const float e_step_real
+)
+{
+    switch (segment->type)
+    {
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_RAMP:
+        return segment->e_begin + (index * e_step_real);
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_HOLD:
+        return segment->e_begin;
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE:
+        if(index % 2 == 1) return segment->e_begin + ((index / 2) * e_step_real) + segment->e_offset[1];
+        if(segment->hold_first) return segment->e_begin + segment->e_offset[0];
+        return segment->e_begin + ((index / 2) * e_step_real) + segment->e_offset[0];
+    }
+    return 0.0;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_check(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform
+)
+{
+    uint32_t level_number = 0;
+
+    if(waveform->segments == NULL) return AD5940ERR_PARA;
+    if(waveform->segment_number == 0) return AD5940ERR_PARA;
+
+    for(uint8_t i=0; i<waveform->segment_number; i++)
+    {
+        const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *segment = &waveform->segments[i];
+        switch (segment->type)
+        {
+        case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_RAMP:
+        case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE:
+            if(segment->e_step <= 0) return AD5940ERR_PARA;
+            break;
+
+        case AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_HOLD:
+            break;
+
+        default:
+            return AD5940ERR_PARA;
+        }
+        level_number += _get_segment_level_number(segment);
+    }
+    if(level_number == 0) return AD5940ERR_PARA;
+    if(level_number > 0xFFFF) return AD5940ERR_PARA;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_level_number(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    uint16_t *const level_number
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_check(waveform);
+    if(error != AD5940ERR_OK) return error;
+
+    *level_number = 0;
+    for(uint8_t i=0; i<waveform->segment_number; i++)
+    {
+        *level_number += _get_segment_level_number(&waveform->segments[i]);
+    }
+
+    return AD5940ERR_OK;
+}
+
+static AD5940Err _get_potential_at_index(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const uint16_t index,
+    float *const potential
+)
+{
+    uint16_t position = index;
+    uint16_t segment_level_number;
+
+    for(uint8_t i=0; i<waveform->segment_number; i++)
+    {
+        const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *segment = &waveform->segments[i];
+        segment_level_number = _get_segment_level_number(segment);
+        if(position < segment_level_number)
+        {
+            *potential = _get_segment_potential_at_index(
+                segment,
+                position,
+                _get_e_step_real(segment)
+            );
+            return AD5940ERR_OK;
+        }
+        position -= segment_level_number;
+    }
+
+    return AD5940ERR_PARA;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_potential_at_index(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const uint16_t index,
+    float *const potential
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_check(waveform);
+    if(error != AD5940ERR_OK) return error;
+
+    return _get_potential_at_index(
+        waveform,
+        index,
+        potential
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_schedule(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE *const schedule
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    SEQInfo_Type *ADC_seq_info;
+    AD5940_ELECTROCHEMICAL_UTILITY_get_ADC_seq_info(
+        &ADC_seq_info
+    );
+
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_get_level_number(
+        waveform,
+        &schedule->level_number
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    schedule->type = AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_ALTERNATE;
+    schedule->slot_number = 4;
+    schedule->order[0] = DAC_0_SEQID;
+    schedule->order[1] = ADC_seq_info->SeqId;
+    schedule->order[2] = DAC_1_SEQID;
+    schedule->order[3] = ADC_seq_info->SeqId;
+    schedule->sequence_length = ((uint32_t) schedule->level_number) * SEQLEN_ONESTEP;
+
+    /**
+     * The temperature sequence runs once per DAC_0, DAC_1 pair.
+     * It takes the sequence ID of DAC_2, so the static first schedule is not available.
+     */
+    if(temperature != NULL)
+    {
+        if(temperature->interval != 2) return AD5940ERR_PARA;
+        schedule->order[4] = AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID;
+        schedule->slot_number = 5;
+        return AD5940ERR_OK;
+    }
+
+    /**
+     * The first level of a PULSE segment with hold_first (NPV) never changes,
+     * so it doesn't need its own DAC sequence on every step.
+     * The levels of the other techniques all change, the alternate schedule is already the cheapest.
+     */
+    if(
+        (waveform->segment_number == 1) &&
+        (waveform->segments[0].type == AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE) &&
+        (waveform->segments[0].hold_first == bTRUE)
+    )
+    {
+        uint32_t sequence_length = SEQLEN_STATIC + ((uint32_t) (schedule->level_number / 2)) * SEQLEN_ONESTEP;
+        if(sequence_length < schedule->sequence_length)
+        {
+            schedule->type = AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_STATIC_FIRST;
+            schedule->slot_number = 8;
+            schedule->order[0] = DAC_0_SEQID;
+            schedule->order[1] = ADC_seq_info->SeqId;
+            schedule->order[2] = DAC_1_SEQID;
+            schedule->order[3] = ADC_seq_info->SeqId;
+            schedule->order[4] = DAC_0_SEQID;
+            schedule->order[5] = ADC_seq_info->SeqId;
+            schedule->order[6] = DAC_2_SEQID;
+            schedule->order[7] = ADC_seq_info->SeqId;
+            schedule->sequence_length = sequence_length;
+        }
+    }
+
+    return AD5940ERR_OK;
+}
+
+
+/**
+* @brief Update DAC sequence in SRAM in real time.
+* @details This function generates sequences to update DAC code step by step.
+*          We don't use sequence generator to save memory.
+*          Up to WRITE_BATCH_STEP levels are buffered and written to SRAM at once,
+*          starting from `first_level`.
+*/
+static AD5940Err _write_alternate_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const uint16_t level_number,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const uint32_t start_address,
+    const uint16_t first_level,
+    const uint16_t level_count
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    uint32_t SeqCmdBuff[SEQLEN_ONESTEP * WRITE_BATCH_STEP];
+    uint32_t *pSeqCmd = SeqCmdBuff;
+
+    uint32_t current_address = start_address + ((uint32_t) first_level) * SEQLEN_ONESTEP;
+    uint16_t level_index;
+
+    float e_current;
+
+    if(level_count > WRITE_BATCH_STEP) return AD5940ERR_PARA;
+
+    for(uint16_t j=0; j<level_count; j++)
+    {
+        level_index = first_level + j;
+        error = _get_potential_at_index(
+            waveform,
+            level_index,
+            &e_current
+        );
+        if(error != AD5940ERR_OK) return error;
+        error = AD5940_ELECTROCHEMICAL_get_dac_sequence_command_by_potential(
+            e_current,
+            hsdac_cfg,
+            pSeqCmd
+        );
+        if(error != AD5940ERR_OK) return error;
+        pSeqCmd[1] = SEQ_WAIT(DAC_WAIT_CLOCKS); /* !!!NOTE the LPDAC, or the HSDAC through HSDACDAT on path 2, needs 10 clocks to update data. Before send AFE to sleep state, wait 10 extra clocks */
+        AD5940_get_change_sequence_info_command(
+            (level_index % 2 == 1) ? DAC_0_SEQID : DAC_1_SEQID,
+            (level_index == (level_number - 1))
+                ? start_address     // Turn back to the first point.
+                : (current_address + (j + 1) * SEQLEN_ONESTEP),
+            SEQLEN_ONESTEP,
+            pSeqCmd + 2
+        );
+        pSeqCmd += SEQLEN_ONESTEP;
+    }
+    AD5940_SEQCmdWrite(current_address, SeqCmdBuff, pSeqCmd - SeqCmdBuff);
+
+    return AD5940ERR_OK;
+}
+
+static void _write_alternate_sequence_info(
+    const uint32_t start_address
+)
+{
+    AD5940_write_change_sequence_info_command(
+        DAC_0_SEQID,
+        start_address,
+        SEQLEN_ONESTEP
+    );
+
+    AD5940_write_change_sequence_info_command(
+        DAC_1_SEQID,
+        start_address + SEQLEN_ONESTEP,
+        SEQLEN_ONESTEP
+    );
+}
+
+/**
+* @brief Write the static first level followed by the chain of second levels.
+* @details The static DAC sequence has no sequence info command, DAC_0 always executes it,
+*          and it is written with the first batch.
+*          The second levels alternate between DAC_1 and DAC_2.
+*/
+static AD5940Err _write_static_first_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment,
+    const uint16_t level_number,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const uint32_t start_address,
+    const uint16_t first_step,
+    const uint16_t step_count
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    uint32_t SeqCmdBuff[SEQLEN_ONESTEP * WRITE_BATCH_STEP];
+    uint32_t *pSeqCmd = SeqCmdBuff;
+
+    const float e_step_real = _get_e_step_real(segment);
+    const uint16_t step_number = level_number / 2;
+    const uint32_t chain_address = start_address + SEQLEN_STATIC;
+    const uint32_t current_address = chain_address + ((uint32_t) first_step) * SEQLEN_ONESTEP;
+    uint16_t k;
+
+    float e_current;
+
+    if(step_count > WRITE_BATCH_STEP) return AD5940ERR_PARA;
+
+    if(first_step == 0)
+    {
+        e_current = _get_segment_potential_at_index(
+            segment,
+            0,
+            e_step_real
+        );
+        error = AD5940_ELECTROCHEMICAL_get_dac_sequence_command_by_potential(
+            e_current,
+            hsdac_cfg,
+            SeqCmdBuff
+        );
+        if(error != AD5940ERR_OK) return error;
+        SeqCmdBuff[1] = SEQ_WAIT(DAC_WAIT_CLOCKS); /* !!!NOTE the LPDAC, or the HSDAC through HSDACDAT on path 2, needs 10 clocks to update data. Before send AFE to sleep state, wait 10 extra clocks */
+        AD5940_SEQCmdWrite(start_address, SeqCmdBuff, SEQLEN_STATIC);
+    }
+
+    for(uint16_t j=0; j<step_count; j++)
+    {
+        k = first_step + j;
+        e_current = _get_segment_potential_at_index(
+            segment,
+            (k * 2) + 1,
+            e_step_real
+        );
+        error = AD5940_ELECTROCHEMICAL_get_dac_sequence_command_by_potential(
+            e_current,
+            hsdac_cfg,
+            pSeqCmd
+        );
+        if(error != AD5940ERR_OK) return error;
+        pSeqCmd[1] = SEQ_WAIT(DAC_WAIT_CLOCKS); /* !!!NOTE the LPDAC, or the HSDAC through HSDACDAT on path 2, needs 10 clocks to update data. Before send AFE to sleep state, wait 10 extra clocks */
+        AD5940_get_change_sequence_info_command(
+            (k % 2 == 1) ? DAC_1_SEQID : DAC_2_SEQID,
+            (k == (step_number - 1))
+                ? chain_address     // Turn back to the first point.
+                : (current_address + (j + 1) * SEQLEN_ONESTEP),
+            SEQLEN_ONESTEP,
+            pSeqCmd + 2
+        );
+        pSeqCmd += SEQLEN_ONESTEP;
+    }
+    AD5940_SEQCmdWrite(current_address, SeqCmdBuff, pSeqCmd - SeqCmdBuff);
+
+    return AD5940ERR_OK;
+}
+
+static void _write_static_first_sequence_info(
+    const uint16_t level_number,
+    const uint32_t start_address
+)
+{
+    const uint16_t step_number = level_number / 2;
+    const uint32_t chain_address = start_address + SEQLEN_STATIC;
+
+    AD5940_write_change_sequence_info_command(
+        DAC_0_SEQID,
+        start_address,
+        SEQLEN_STATIC
+    );
+
+    AD5940_write_change_sequence_info_command(
+        DAC_1_SEQID,
+        chain_address,
+        SEQLEN_ONESTEP
+    );
+
+    AD5940_write_change_sequence_info_command(
+        DAC_2_SEQID,
+        (step_number > 1) ? (chain_address + SEQLEN_ONESTEP) : chain_address,
+        SEQLEN_ONESTEP
+    );
+}
+
+/**
+ * @brief Number of DAC sequences with their own SRAM entry, written in batches.
+ */
+static uint16_t _get_entry_number(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE *const schedule
+)
+{
+    switch (schedule->type)
+    {
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_ALTERNATE:
+        return schedule->level_number;
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_STATIC_FIRST:
+        return schedule->level_number / 2;
+    }
+    return 0;
+}
+
+static AD5940Err _write_entries(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE *const schedule,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const uint32_t start_address,
+    const uint16_t first_entry,
+    const uint16_t entry_count
+)
+{
+    switch (schedule->type)
+    {
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_ALTERNATE:
+        return _write_alternate_sequence_commands(
+            waveform,
+            schedule->level_number,
+            hsdac_cfg,
+            start_address,
+            first_entry,
+            entry_count
+        );
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_STATIC_FIRST:
+        return _write_static_first_sequence_commands(
+            &waveform->segments[0],
+            schedule->level_number,
+            hsdac_cfg,
+            start_address,
+            first_entry,
+            entry_count
+        );
+    }
+    return AD5940ERR_PARA;
+}
+
+static void _write_sequence_info(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE *const schedule,
+    const uint32_t start_address
+)
+{
+    switch (schedule->type)
+    {
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_ALTERNATE:
+        _write_alternate_sequence_info(start_address);
+        break;
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_STATIC_FIRST:
+        _write_static_first_sequence_info(
+            schedule->level_number,
+            start_address
+        );
+        break;
+    }
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_write_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const uint32_t start_address,
+    uint32_t *const sequence_length
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE schedule;
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_get_schedule(
+        waveform,
+        temperature,
+        &schedule
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate_sram(
+        start_address,
+        schedule.sequence_length
+    );
+
+    const uint16_t entry_number = _get_entry_number(&schedule);
+    uint16_t entry_count;
+    for(uint16_t entry_index=0; entry_index<entry_number; entry_index+=entry_count)
+    {
+        entry_count = ((entry_number - entry_index) > WRITE_BATCH_STEP)
+            ? WRITE_BATCH_STEP
+            : (entry_number - entry_index);
+        error = _write_entries(
+            waveform,
+            &schedule,
+            hsdac_cfg,
+            start_address,
+            entry_index,
+            entry_count
+        );
+        if(error != AD5940ERR_OK) return error;
+    }
+    _write_sequence_info(
+        &schedule,
+        start_address
+    );
+    *sequence_length = schedule.sequence_length;
+
+    return AD5940ERR_OK;
+}
+
+/**
+ * @brief Gets the end of the last sequence in SRAM, the temperature sequence follows the DAC sequences.
+ */
+static uint32_t _get_sequence_end(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    SEQInfo_Type *temperature_seq_info;
+
+    if(context->run->temperature != NULL)
+    {
+        AD5940_ELECTROCHEMICAL_TEMPERATURE_get_seq_info(
+            &temperature_seq_info
+        );
+        return temperature_seq_info->SeqRamAddr + temperature_seq_info->SeqLen;
+    }
+
+    return context->dac_address + context->schedule.sequence_length;
+}
+
+/**
+ * @brief Writes the ADC sequence at the beginning of SRAM and the temperature sequence
+ *        after the room left for the DAC sequences.
+ */
+static AD5940Err _write_adc_sequence_commands(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg,
+    const uint32_t ADCMuxP,
+    const uint32_t ADCMuxN
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    uint32_t sequence_address = 0x00;
+    uint32_t sequence_commands_length = 0;
+
+    error = AD5940_ELECTROCHEMICAL_write_sequence_commands_config(
+        context->run->clock_cfg,
+        &(dsp_cfg->DftCfg),
+        dsp_cfg->ADCFilterCfg.ADCAvgNum,
+        dsp_cfg->ADCFilterCfg.ADCSinc2Osr,
+        dsp_cfg->ADCFilterCfg.ADCSinc3Osr,
+        dsp_cfg->ADCFilterCfg.BpNotch,
+        1,
+        context->run->DataType,
+        context->sampling,
+        context->run->energy_mode,
+        context->run->electrode_scan,
+        &sequence_address
+    );
+    if(error != AD5940ERR_OK) return AD5940ERR_PARA;
+
+    context->dac_address = sequence_address;
+    sequence_address += context->schedule.sequence_length;
+
+    if(context->run->temperature != NULL)
+    {
+        error = AD5940_ELECTROCHEMICAL_TEMPERATURE_write_sequence_commands(
+            context->run->temperature,
+            context->run->clock_cfg,
+            dsp_cfg,
+            ADCMuxP,
+            ADCMuxN,
+            context->run->DataType,
+            sequence_address,
+            &sequence_commands_length
+        );
+        if(error != AD5940ERR_OK) return AD5940ERR_PARA;
+        sequence_address += sequence_commands_length;
+    }
+
+    /* Dry run of the SRAM partition, so a waveform too long for SRAM fails before its upload */
+    uint32_t SeqMemSize;
+    uint32_t FIFOSize;
+    error = AD5940_get_sram_partition(
+        context->run->sram_partition,
+        sequence_address,
+        context->FifoThresh,
+        &SeqMemSize,
+        &FIFOSize
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940ERR_OK;
+}
+
+static AD5940Err _start_wakeup_timer_sequence(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE *const schedule,
+    const float t_level[2],
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const uint32_t FifoSrc,
+    const uint16_t FifoThresh,
+    const float LFOSCClkFreq
+)
+{
+    // The ADC wakes up at the first sampling point, the following captures run in the same wakeup.
+    float t_sample;
+    AD5940_ELECTROCHEMICAL_SAMPLING_get_offset(
+        sampling,
+        0,
+        &t_sample
+    );
+
+    /**
+     * Every wakeup spends at least 2 32kHz clocks of sleep time before counting the wakeup time,
+     * so each level must leave room for both sleep times.
+     */
+    if((LFOSCClkFreq * t_sample) < 3) return AD5940ERR_PARA;
+    if((LFOSCClkFreq * (t_level[0] - t_sample)) < 3) return AD5940ERR_PARA;
+    if((LFOSCClkFreq * (t_level[1] - t_sample)) < 3) return AD5940ERR_PARA;
+
+    /**
+     * The temperature slot splits the rest of the odd level in two halves,
+     * the first half before the temperature capture, the second half before the next even level.
+     */
+    float t_temperature = 0;
+    if(schedule->slot_number == 5)
+    {
+        t_temperature = (t_level[1] - t_sample) / 2;
+        if((LFOSCClkFreq * t_temperature) < 3) return AD5940ERR_PARA;
+        if((LFOSCClkFreq * (t_level[1] - t_sample - t_temperature)) < 3) return AD5940ERR_PARA;
+    }
+
+    /* Configure FIFO and Sequencer for normal Amperometric Measurement */
+    AD5940_FIFOThrshSet((uint32_t) FifoThresh);
+    AD5940_FIFOCtrlS(FifoSrc, bTRUE);
+
+    AD5940_SEQCtrlS(bTRUE);
+
+    SEQInfo_Type *ADC_seq_info;
+    AD5940_ELECTROCHEMICAL_UTILITY_get_ADC_seq_info(
+        &ADC_seq_info
+    );
+
+    /**
+     * Configure Wakeup Timer.
+     * The wakeup time of a sequence counts from the previous sequence,
+     * so a DAC sequence waits for the rest of the previous level.
+     * The slots alternate between DAC and ADC sequences,
+     * and the DAC slots alternate between even and odd levels.
+     */
+	WUPTCfg_Type wupt_cfg;
+	wupt_cfg.WuptEn = bTRUE;
+	wupt_cfg.WuptEndSeq = WUPTENDSEQ_A + (schedule->slot_number - 1);
+    for(uint8_t i=0; i<schedule->slot_number; i++)
+    {
+        wupt_cfg.WuptOrder[i] = schedule->order[i];
+        wupt_cfg.SeqxSleepTime[schedule->order[i]] = 1;     // The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock.
+        if(schedule->order[i] == ADC_seq_info->SeqId)
+        {
+            wupt_cfg.SeqxWakeupTime[schedule->order[i]] = (uint32_t)(LFOSCClkFreq * t_sample) - 1;
+        }
+        else if(i == 4 && schedule->slot_number == 5)
+        {
+            wupt_cfg.SeqxWakeupTime[schedule->order[i]] = (uint32_t)(LFOSCClkFreq * t_temperature) - 1;
+        }
+        else if(i == 0)
+        {
+            wupt_cfg.SeqxWakeupTime[schedule->order[i]] = (uint32_t)(LFOSCClkFreq * (t_level[1] - t_sample - t_temperature)) - 1;
+        }
+        else
+        {
+            wupt_cfg.SeqxWakeupTime[schedule->order[i]] = (uint32_t)(LFOSCClkFreq * (t_level[((i / 2) % 2 == 0) ? 1 : 0] - t_sample)) - 1;
+        }
+    }
+    AD5940_WUPTCfg(&wupt_cfg);
+
+    return AD5940ERR_OK;
+}
+
+/**
+ * @brief Wakes up the AFE, configures the path and writes the ADC and temperature sequences.
+ */
+static AD5940Err _start_config(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run = context->run;
+    const AD5940_ELECTROCHEMICAL_PATH *const path = context->path;
+
+    /* Wakeup AFE by read register, read 10 times at most */
+    if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
+
+    /**
+     * Before the application begins, INT are used for configuring parameters.
+     * Therefore, they should not be used during the configuration process itself.
+     */
+    AD5940_clear_GPIO_and_INT_flag();
+
+    switch (context->path_type)
+    {
+    case 0:
+        error = AD5940_ELECTROCHEMICAL_config_afe_lpdac_lptia(
+            path->lpdac_to_lptia->afe_ref_cfg,
+            0
+        );
+        if(error != AD5940ERR_OK) return error;
+
+        error = _write_adc_sequence_commands(
+            context,
+            path->lpdac_to_lptia->dsp_cfg,
+            ADCMUXP_LPTIA0_P,
+            ADCMUXN_LPTIA0_N
+        );
+        if(error != AD5940ERR_OK) return error;
+
+        error = AD5940_ELECTROCHEMICAL_config_lpdac_lptia_adc(
+            path->lpdac_to_lptia->lpdac_cfg,
+            path->lpdac_to_lptia->lptia_cfg,
+            path->lpdac_to_lptia->dsp_cfg,
+            run->clock_cfg->ADCRate,
+            bFALSE
+        );
+        if(error != AD5940ERR_OK) return error;
+        context->hsdac_cfg = NULL;
+        break;
+
+    case 1:
+        error = AD5940_ELECTROCHEMICAL_config_afe_lpdac_hstia(
+            path->lpdac_to_hstia->afe_ref_cfg,
+            0
+        );
+        if(error != AD5940ERR_OK) return error;
+
+        error = _write_adc_sequence_commands(
+            context,
+            path->lpdac_to_hstia->dsp_cfg,
+            ADCMUXP_HSTIA_P,
+            ADCMUXN_HSTIA_N
+        );
+        if(error != AD5940ERR_OK) return error;
+
+        error = AD5940_ELECTROCHEMICAL_config_lpdac_hstia_adc(
+            path->lpdac_to_hstia->lpdac_cfg,
+            path->lpdac_to_hstia->hstia_cfg,
+            path->lpdac_to_hstia->dsp_cfg,
+            AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_routing(
+                run->electrode_scan,
+                path->lpdac_to_hstia->electrode_routing
+            ),
+            run->clock_cfg->ADCRate,
+            bFALSE
+        );
+        if(error != AD5940ERR_OK) return error;
+        context->hsdac_cfg = NULL;
+        break;
+
+    case 2:
+        error = AD5940_ELECTROCHEMICAL_config_afe_hsdac_hstia(
+            path->hsdac_to_hstia->afe_ref_cfg,
+            path->hsdac_to_hstia->hsdac_cfg,
+            0
+        );
+        if(error != AD5940ERR_OK) return error;
+
+        error = _write_adc_sequence_commands(
+            context,
+            path->hsdac_to_hstia->dsp_cfg,
+            ADCMUXP_HSTIA_P,
+            ADCMUXN_HSTIA_N
+        );
+        if(error != AD5940ERR_OK) return error;
+
+        error = AD5940_ELECTROCHEMICAL_config_hsdac_hstia_adc(
+            path->hsdac_to_hstia->hstia_cfg,
+            path->hsdac_to_hstia->dsp_cfg,
+            AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_get_routing(
+                run->electrode_scan,
+                path->hsdac_to_hstia->electrode_routing
+            ),
+            run->clock_cfg->ADCRate
+        );
+        if(error != AD5940ERR_OK) return error;
+        context->hsdac_cfg = path->hsdac_to_hstia->hsdac_cfg;
+        break;
+
+    default:
+        return AD5940ERR_PARA;
+    }
+
+    return AD5940ERR_OK;
+}
+
+static uint32_t _add_checksum(
+    uint32_t checksum,
+    const void *const data,
+    const uint32_t size
+)
+{
+    // FNV-1a, field by field so that the struct padding is left out.
+    const uint8_t *const bytes = (const uint8_t *) data;
+    for(uint32_t i=0; i<size; i++)
+    {
+        checksum = (checksum ^ bytes[i]) * 16777619UL;
+    }
+    return checksum;
+}
+
+/**
+ * @brief Checksum of everything the DAC sequences are generated from, at their SRAM address.
+ */
+static uint32_t _get_dac_checksum(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    uint32_t checksum = 2166136261UL;
+
+    for(uint8_t i=0; i<context->waveform.segment_number; i++)
+    {
+        const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *const segment = &context->waveform.segments[i];
+        const uint32_t type = (uint32_t) segment->type;
+        const uint32_t hold_first = (uint32_t) segment->hold_first;
+        checksum = _add_checksum(checksum, &type, sizeof(type));
+        checksum = _add_checksum(checksum, &segment->e_begin, sizeof(segment->e_begin));
+        checksum = _add_checksum(checksum, &segment->e_end, sizeof(segment->e_end));
+        checksum = _add_checksum(checksum, &segment->e_step, sizeof(segment->e_step));
+        checksum = _add_checksum(checksum, segment->e_offset, sizeof(segment->e_offset));
+        checksum = _add_checksum(checksum, &hold_first, sizeof(hold_first));
+        checksum = _add_checksum(checksum, &segment->number, sizeof(segment->number));
+    }
+
+    const uint32_t schedule_type = (uint32_t) context->schedule.type;
+    checksum = _add_checksum(checksum, &schedule_type, sizeof(schedule_type));
+    checksum = _add_checksum(checksum, &context->schedule.level_number, sizeof(context->schedule.level_number));
+
+    if(context->hsdac_cfg != NULL)
+    {
+        checksum = _add_checksum(checksum, &context->hsdac_cfg->ExcitBufGain, sizeof(context->hsdac_cfg->ExcitBufGain));
+        checksum = _add_checksum(checksum, &context->hsdac_cfg->HsDacGain, sizeof(context->hsdac_cfg->HsDacGain));
+    }
+
+    return checksum;
+}
+
+/**
+ * @brief Writes the next batch of DAC sequences, and their sequence info after the last batch.
+ *
+ * For a reconfiguration, the upload is skipped when SRAM already holds the same DAC sequences,
+ * e.g. staged by @ref AD5940_ELECTROCHEMICAL_EXPERIMENT_start.
+ */
+static AD5940Err _start_upload(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    BoolFlag *const finished
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    const uint16_t entry_number = _get_entry_number(&context->schedule);
+    const uint16_t entry_count = ((entry_number - context->entry_index) > WRITE_BATCH_STEP)
+        ? WRITE_BATCH_STEP
+        : (entry_number - context->entry_index);
+
+    if(context->entry_index == 0)
+    {
+        if((context->reconfigure == bTRUE)
+            && (AD5940_ELECTROCHEMICAL_RECONFIGURE_sram_holds(
+                    context->dac_address,
+                    context->schedule.sequence_length,
+                    _get_dac_checksum(context)
+                ) == bTRUE))
+        {
+            context->entry_index = entry_number;
+            *finished = bTRUE;
+            _write_sequence_info(
+                &context->schedule,
+                context->dac_address
+            );
+            return AD5940ERR_OK;
+        }
+
+        AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate_sram(
+            context->dac_address,
+            context->schedule.sequence_length
+        );
+    }
+
+    error = _write_entries(
+        &context->waveform,
+        &context->schedule,
+        context->hsdac_cfg,
+        context->dac_address,
+        context->entry_index,
+        entry_count
+    );
+    if(error != AD5940ERR_OK) return error;
+    context->entry_index += entry_count;
+
+    *finished = (context->entry_index >= entry_number) ? bTRUE : bFALSE;
+    if(*finished == bTRUE)
+    {
+        _write_sequence_info(
+            &context->schedule,
+            context->dac_address
+        );
+        AD5940_ELECTROCHEMICAL_RECONFIGURE_record_sram(
+            context->dac_address,
+            context->schedule.sequence_length,
+            _get_dac_checksum(context)
+        );
+    }
+
+    return AD5940ERR_OK;
+}
+
+static AD5940Err _start_run(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run = context->run;
+
+    error = AD5940_ELECTROCHEMICAL_configure_sram(
+        run->sram_partition,
+        _get_sequence_end(context),
+        context->FifoThresh
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    // Ensure it is cleared as ad5940.c relies on the INTC flag as well.
+    AD5940_INTCClrFlag(AFEINTSRC_ALLINT);
+
+    AGPIOCfg_Type agpio_cfg;
+    memcpy(&agpio_cfg, run->agpio_cfg, sizeof(AGPIOCfg_Type));
+    AD5940_set_INTCCfg_by_AGPIOCfg_Type(&agpio_cfg, context->IntSrc | AD5940_FIFO_ERROR_INTSRC);
+    AD5940_AGPIOCfg(&agpio_cfg);
+
+    return _start_wakeup_timer_sequence(
+        &context->schedule,
+        context->t_level,
+        context->sampling,
+        run->FifoSrc,
+        context->FifoThresh,
+        run->LFOSCClkFreq
+    );
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const float t_level[2],
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint8_t path_type,
+    const AD5940_ELECTROCHEMICAL_PATH *const path,
+    const uint32_t IntSrc
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_check(waveform);
+    if(error != AD5940ERR_OK) return error;
+    if(waveform->segment_number > AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_NUMBER_MAX) return AD5940ERR_PARA;
+
+    error = AD5940_ELECTROCHEMICAL_ELECTRODE_SCAN_check(run->electrode_scan, path_type);
+    if(error != AD5940ERR_OK) return error;
+
+    memcpy(
+        context->segments,
+        waveform->segments,
+        sizeof(AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT) * waveform->segment_number
+    );
+    context->device = device;
+    context->waveform.segments = context->segments;
+    context->waveform.segment_number = waveform->segment_number;
+    context->t_level[0] = t_level[0];
+    context->t_level[1] = t_level[1];
+    context->sampling = sampling;
+    context->run = run;
+    context->path_type = path_type;
+    context->path = path;
+    context->IntSrc = IntSrc;
+    context->FifoThresh = run->FifoThresh;
+    context->hsdac_cfg = NULL;
+    context->dac_address = 0;
+    context->entry_index = 0;
+    context->reconfigure = bFALSE;
+
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_get_schedule(
+        &context->waveform,
+        run->temperature,
+        &context->schedule
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    context->phase = AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_CONFIG;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start_step(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    BoolFlag *const done
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+    BoolFlag finished;
+
+    *done = bFALSE;
+
+    /* Other devices may have been driven since the previous step */
+    error = AD5940_TECHNIQUE_CONTEXT_select(context->device);
+    if(error != AD5940ERR_OK) return error;
+
+    switch (context->phase)
+    {
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_CONFIG:
+    {
+        AD5940_METRICS_BEGIN(begin);
+        if(context->reconfigure == bTRUE) AD5940_ELECTROCHEMICAL_RECONFIGURE_begin();
+        error = _start_config(context);
+        AD5940_ELECTROCHEMICAL_RECONFIGURE_end();
+        AD5940_METRICS_END(AD5940_METRICS_PHASE_START_CONFIG, begin);
+        if(error != AD5940ERR_OK) return error;
+        context->phase = AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_UPLOAD;
+        return AD5940ERR_OK;
+    }
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_UPLOAD:
+    {
+        AD5940_METRICS_BEGIN(begin);
+        error = _start_upload(context, &finished);
+        AD5940_METRICS_END(AD5940_METRICS_PHASE_START_UPLOAD, begin);
+        if(error != AD5940ERR_OK) return error;
+        if(finished == bTRUE) context->phase = AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_RUN;
+        return AD5940ERR_OK;
+    }
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_RUN:
+    {
+        AD5940_METRICS_BEGIN(begin);
+        error = _start_run(context);
+        AD5940_METRICS_END(AD5940_METRICS_PHASE_START_RUN, begin);
+        if(error != AD5940ERR_OK) return error;
+        context->phase = AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_DONE;
+        *done = bTRUE;
+        return AD5940ERR_OK;
+    }
+
+    case AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_DONE:
+        *done = bTRUE;
+        return AD5940ERR_OK;
+    }
+    return AD5940ERR_PARA;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+    BoolFlag done = bFALSE;
+
+    /* Bind the metrics of the device before measuring */
+    error = AD5940_TECHNIQUE_CONTEXT_select(context->device);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_METRICS_BEGIN(begin);
+    while(done == bFALSE)
+    {
+        error = AD5940_ELECTROCHEMICAL_WAVEFORM_start_step(context, &done);
+        if(error != AD5940ERR_OK) break;
+    }
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_START, begin);
+
+    return error;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const float t_level[2],
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint8_t path_type,
+    const AD5940_ELECTROCHEMICAL_PATH *const path,
+    const uint32_t IntSrc
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT context;
+    error = AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin(
+        &context,
+        device,
+        waveform,
+        t_level,
+        sampling,
+        run,
+        path_type,
+        path,
+        IntSrc
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(&context);
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_plan(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    const uint16_t level_number = context->schedule.level_number;
+
+    memset(plan, 0, sizeof(AD5940_ELECTROCHEMICAL_PLAN));
+
+    /* Even and odd levels alternate, starting with an even level */
+    plan->duration = (float)(level_number / 2) * (context->t_level[0] + context->t_level[1])
+        + (float)(level_number % 2) * context->t_level[0];
+    plan->sram_words = context->schedule.sequence_length;
+    plan->wakeup_number = level_number;
+    plan->t_awake = (float) level_number * DAC_WAIT_CLOCKS / context->run->clock_cfg->SysClkFreq;
+
+    error = AD5940_ELECTROCHEMICAL_PLAN_add_captures(
+        plan,
+        context->run,
+        context->path_type,
+        context->path,
+        context->sampling,
+        level_number
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    return AD5940_ELECTROCHEMICAL_PLAN_complete(
+        plan,
+        context->run,
+        context->IntSrc
+    );
+}
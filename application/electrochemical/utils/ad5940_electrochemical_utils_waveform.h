@@ -0,0 +1,351 @@
+/**
+ * @file ad5940_electrochemical_utils_waveform.h
+ * @brief Compiles piecewise potential waveforms into DAC sequences in SRAM.
+ *
+ * A waveform is a list of segments. Every segment is expanded into DAC levels,
+ * and every level is written to SRAM as one DAC sequence. The DAC sequences are
+ * executed in turn by two sequence IDs driven by the wakeup timer,
+ * with the ADC sequence sampling each level.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_utils.h"
+#include "ad5940_device.h"
+#include "ad5940_electrochemical_utils_struct.h"
+#include "ad5940_electrochemical_utils_loop.h"
+#include "ad5940_electrochemical_utils_run.h"
+#include "ad5940_electrochemical_utils_plan.h"
+
+/**
+ * @brief Number of sequence commands of one DAC level.
+ *
+ * DAC update, wait for the DAC to settle, and the switch to the next DAC level.
+ */
+#define AD5940_ELECTROCHEMICAL_WAVEFORM_SEQLEN_ONESTEP 3L
+
+/**
+ * @brief Number of sequence commands of a DAC level that never changes.
+ *
+ * DAC update and wait for the DAC to settle, the sequence info is never rewritten.
+ */
+#define AD5940_ELECTROCHEMICAL_WAVEFORM_SEQLEN_STATIC 2L
+
+/**
+ * @brief Sequence IDs executing the DAC levels.
+ */
+#define AD5940_ELECTROCHEMICAL_WAVEFORM_DAC_0_SEQID SEQID_1
+#define AD5940_ELECTROCHEMICAL_WAVEFORM_DAC_1_SEQID SEQID_2
+#define AD5940_ELECTROCHEMICAL_WAVEFORM_DAC_2_SEQID SEQID_3
+
+/**
+ * @brief Maximum number of wakeup timer slots. Refer to datasheet page 100.
+ */
+#define AD5940_ELECTROCHEMICAL_WAVEFORM_SLOT_NUMBER_MAX 8
+
+/**
+ * @brief Maximum number of segments kept by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT.
+ */
+#define AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_NUMBER_MAX 4
+
+/**
+ * @brief Types of waveform segments.
+ */
+typedef enum {
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_RAMP,      /**< Staircase from `e_begin` towards `e_end` in `e_step`, `e_end` excluded. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_HOLD,      /**< `number` levels at `e_begin`. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE,     /**< Staircase from `e_begin` to `e_end` in `e_step`, `e_end` included,
+                                                                 with two levels per step offset by `e_offset`. */
+} AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE;
+
+/**
+ * @brief Segment of a waveform.
+ *
+ * `e_step` must be positive, the staircase always moves from `e_begin` towards `e_end`.
+ *
+ * For PULSE segments, the k-th step with staircase potential E_k produces the levels
+ * `E_k + e_offset[0]` and `E_k + e_offset[1]`. If `hold_first` is set, the first level
+ * stays at `e_begin + e_offset[0]` on every step instead of following the staircase.
+ */
+typedef struct
+{
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE type;  /**< Type of the segment. */
+    float e_begin;                                      /**< Starting potential, in volts (V). */
+    float e_end;                                        /**< Ending potential of RAMP and PULSE segments, in volts (V). */
+    float e_step;                                       /**< Staircase step of RAMP and PULSE segments, in volts (V). */
+    float e_offset[2];                                  /**< Offsets of the two levels of PULSE segments, in volts (V). */
+    BoolFlag hold_first;                                /**< Keep the first level of PULSE segments at the starting potential. */
+    uint16_t number;                                    /**< Number of levels of HOLD segments. */
+}
+AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT;
+
+/**
+ * @brief Piecewise potential waveform.
+ */
+typedef struct
+{
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT *segments;    /**< Segments of the waveform, executed in order. */
+    uint8_t segment_number;                                     /**< Number of segments. */
+}
+AD5940_ELECTROCHEMICAL_WAVEFORM;
+
+/**
+ * @brief Ways of executing the DAC levels with the wakeup timer.
+ */
+typedef enum {
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_ALTERNATE,    /**< Every level is a DAC sequence that points the other DAC sequence ID to the next level.
+                                                                     Slots: DAC_0, ADC, DAC_1, ADC. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_STATIC_FIRST, /**< NPV only: for a single PULSE segment with `hold_first`, the first level of every step
+                                                                     shares one static DAC sequence on DAC_0, and the second levels alternate
+                                                                     between DAC_1 and DAC_2.
+                                                                     Slots: DAC_0, ADC, DAC_1, ADC, DAC_0, ADC, DAC_2, ADC. */
+} AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE;
+
+/**
+ * @brief Wakeup timer schedule and SRAM footprint of a waveform.
+ *
+ * Each DAC level is still followed by one ADC wakeup, so the number of wakeups per level
+ * is the same for every schedule. The schedules differ in how many DAC levels need
+ * their own sequence in SRAM.
+ */
+typedef struct
+{
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE type;                 /**< Type of the schedule. */
+    uint8_t slot_number;                                                /**< Number of wakeup timer slots used, including the temperature slot. */
+    uint8_t order[AD5940_ELECTROCHEMICAL_WAVEFORM_SLOT_NUMBER_MAX];     /**< Sequence IDs of the slots, the ADC sequence is @ref SEQID_0. */
+    uint16_t level_number;                                              /**< Number of DAC levels. */
+    uint32_t sequence_length;                                           /**< Number of sequence commands of the DAC sequences in SRAM. */
+}
+AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE;
+
+/**
+ * @brief Phases of an incremental start, executed in order by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_step.
+ */
+typedef enum {
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_CONFIG,     /**< Wakeup, path configuration, ADC and temperature sequences. One step. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_UPLOAD,     /**< DAC sequences, one SPI burst of up to 8 DAC levels per step. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_RUN,        /**< Interrupt, FIFO and wakeup timer. One step. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE_DONE,       /**< The technique is running. */
+} AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE;
+
+/**
+ * @brief State of an incremental start.
+ *
+ * The segments are copied into the context, the other pointers (device, sampling, run, path)
+ * must stay valid until the start is done.
+ */
+typedef struct
+{
+    AD5940_DEVICE *device;                                      /**< Device selected by every step, or NULL to keep the selection. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segments[AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_NUMBER_MAX];  /**< Copy of the segments. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform;                   /**< Waveform over the copied segments. */
+    float t_level[2];                                           /**< Durations of the even and the odd DAC levels, in seconds (s). */
+    const AD5940_ELECTROCHEMICAL_SAMPLING *sampling;            /**< ADC capture points within each level. */
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *run;               /**< Execution and timing configuration. */
+    uint8_t path_type;                                          /**< Type of path. */
+    const AD5940_ELECTROCHEMICAL_PATH *path;                    /**< Configuration of the selected path. */
+    uint32_t IntSrc;                                            /**< Interrupt sources enabled on the interrupt GPIO. */
+    uint16_t FifoThresh;                                        /**< FIFO threshold set by the run phase, before the wakeup timer starts.
+                                                                     Set to `run->FifoThresh` by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin,
+                                                                     may be lowered before the run phase, e.g. for a short step. */
+    BoolFlag reconfigure;                                       /**< bTRUE to write only the blocks that differ from the previous technique.
+                                                                     Cleared by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin.
+                                                                     Refer to @ref AD5940_ELECTROCHEMICAL_RECONFIGURE_begin. */
+
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_PHASE phase;          /**< Next phase to execute. */
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE schedule;          /**< Schedule of the waveform. */
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *hsdac_cfg;      /**< HSDAC configuration, or NULL to drive the LPDAC. */
+    uint32_t dac_address;                                       /**< SRAM address of the first DAC sequence. */
+    uint16_t entry_index;                                       /**< Next DAC sequence to upload. */
+}
+AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT;
+
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_check(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform
+);
+
+/**
+ * @brief Gets the number of DAC levels of a waveform.
+ *
+ * @param waveform      Waveform.
+ * @param level_number  Pointer to store the number of DAC levels.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_level_number(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    uint16_t *const level_number
+);
+
+/**
+ * @brief Gets the potential of a DAC level of a waveform.
+ *
+ * @param waveform      Waveform.
+ * @param index         Index of the DAC level.
+ * @param potential     Pointer to store the potential, in volts (V).
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_potential_at_index(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const uint16_t index,
+    float *const potential
+);
+
+/**
+ * @brief Chooses the schedule of a waveform that needs the fewest sequence commands in SRAM.
+ *
+ * Only a level that never changes can skip its own DAC sequence, and only NPV (a single PULSE
+ * segment with `hold_first`) has one, so only NPV gets the 8-slot
+ * @ref AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_STATIC_FIRST. Every level of CV, DPV, SWV
+ * and LSV differs from the previous one and needs its own DAC sequence and SEQxINFO rewrite
+ * whatever the slot order, so they keep the 4-slot
+ * @ref AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_ALTERNATE; packing them into more slots
+ * would not save any sequence command or wakeup and is out of scope.
+ *
+ * When the temperature capture is enabled, @ref AD5940_ELECTROCHEMICAL_TEMPERATURE_SEQID is
+ * taken by the temperature sequence, so the schedule is always
+ * @ref AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE_TYPE_ALTERNATE with the temperature slot appended.
+ *
+ * @param waveform      Waveform.
+ * @param temperature   Temperature configuration, or NULL when the temperature capture is disabled.
+ * @param schedule      Pointer to store the schedule.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_schedule(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SCHEDULE *const schedule
+);
+
+/**
+ * @brief Writes the DAC sequences of a waveform to SRAM.
+ *
+ * The DAC sequences follow the schedule chosen by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_get_schedule.
+ * Each varying DAC sequence points the next sequence ID to the next level,
+ * and the last level points back to the first one.
+ *
+ * @param waveform          Waveform.
+ * @param temperature       Temperature configuration, or NULL when the temperature capture is disabled.
+ * @param hsdac_cfg         HSDAC configuration, or NULL to drive the LPDAC.
+ * @param start_address     SRAM address of the first DAC sequence.
+ * @param sequence_length   Pointer to store the number of sequence commands written.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_write_sequence_commands(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const AD5940_ELECTROCHEMICAL_TEMPERATURE_CONFIG *const temperature,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const uint32_t start_address,
+    uint32_t *const sequence_length
+);
+
+/**
+ * @brief Starts a waveform technique on the selected path.
+ *
+ * Configures the AFE of the path, writes the ADC sequence and the DAC sequences to SRAM,
+ * and starts the wakeup timer.
+ * When `run->temperature` is set, the temperature is captured once every two DAC levels,
+ * halfway between the ADC capture of the odd level and the next even level.
+ *
+ * @param device        Device to start, or NULL for the selected device (single AD5940).
+ *                      Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
+ * @param waveform      Waveform.
+ * @param t_level       Durations of the even and the odd DAC levels, in seconds (s).
+ * @param sampling      ADC capture points within each level, or NULL for the default single capture.
+ * @param run           Execution and timing configuration.
+ * @param path_type     Type of path. See @ref AD5940_ELECTROCHEMICAL_PATH.
+ * @param path          Configuration of the selected path.
+ * @param IntSrc        Interrupt sources enabled on the interrupt GPIO. Refer to @ref AFEINTC_SRC_Const.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start(
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const float t_level[2],
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint8_t path_type,
+    const AD5940_ELECTROCHEMICAL_PATH *const path,
+    const uint32_t IntSrc
+);
+
+/**
+ * @brief Prepares an incremental start, without any SPI access.
+ *
+ * Same parameters as @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start. Call
+ * @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_step until it reports done,
+ * the MCU can serve other tasks between two steps, including the starts and
+ * the interrupts of other devices: every step selects the device again.
+ *
+ * @param context       Context to prepare.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    AD5940_DEVICE *const device,
+    const AD5940_ELECTROCHEMICAL_WAVEFORM *const waveform,
+    const float t_level[2],
+    const AD5940_ELECTROCHEMICAL_SAMPLING *const sampling,
+    const AD5940_ELECTROCHEMICAL_RUN_CONFIG *const run,
+    const uint8_t path_type,
+    const AD5940_ELECTROCHEMICAL_PATH *const path,
+    const uint32_t IntSrc
+);
+
+/**
+ * @brief Executes one bounded step of an incremental start.
+ *
+ * The longest step is the path configuration; an upload step writes at most 8 DAC levels.
+ * On error the start is aborted, begin again to retry.
+ *
+ * @param context       Context prepared by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin.
+ * @param done          Pointer to store bTRUE once the technique is running.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start_step(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    BoolFlag *const done
+);
+
+/**
+ * @brief Executes the remaining steps of an incremental start.
+ *
+ * @param context       Context prepared by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_start_complete(
+    AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context
+);
+
+/**
+ * @brief Predicts the cost of a prepared start, without any SPI access.
+ *
+ * One pass over the waveform: every DAC level is one DAC wakeup and one ADC wakeup,
+ * plus one temperature wakeup per pair of levels when the temperature capture is enabled.
+ *
+ * @param context       Context prepared by @ref AD5940_ELECTROCHEMICAL_WAVEFORM_start_begin.
+ * @param plan          Pointer to store the plan.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure, refer to @ref AD5940_ELECTROCHEMICAL_PLAN_complete.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_WAVEFORM_get_plan(
+    const AD5940_ELECTROCHEMICAL_WAVEFORM_START_CONTEXT *const context,
+    AD5940_ELECTROCHEMICAL_PLAN *const plan
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,15 +10,19 @@ static void _config(
     const uint32_t AfeCtrlSet
 )
 {
-    AD5940_AFECtrlS(AFECTRL_ALL, bFALSE);  /* Init all to disable state */
+    /* A reconfiguration keeps the AFE powered and only writes the blocks that change */
+    if(AD5940_ELECTROCHEMICAL_RECONFIGURE_is_active() == bFALSE)
+    {
+        AD5940_AFECtrlS(AFECTRL_ALL, bFALSE);  /* Init all to disable state */
+    }
 
-    AD5940_REFCfgS(aferef_cfg);
-    AD5940_LPLoopCfgS(lp_loop_cfg);
-    AD5940_HSLoopCfgS(hs_loop_cfg);
-    AD5940_DSPCfgS(dsp_cfg);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_reference(aferef_cfg);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_lp_loop(lp_loop_cfg);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_hs_loop(hs_loop_cfg);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(dsp_cfg);
 
     /* Enable all of them. They are automatically turned off during hibernate mode to save power */
-    AD5940_AFECtrlS(AfeCtrlSet, bTRUE);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_power(AfeCtrlSet);
 
     return;
 }
@@ -138,6 +142,40 @@ static AD5940Err _get_LPDACCfg_Type(
     return AD5940ERR_OK;
 }
 
+/**
+ * @brief Configures the HSDAC for MMR mode, the waveform generator writes `HSDACDAT` directly.
+ * 
+ * @note
+ * - Refer to page 43 of the datasheet for the HSDAC output range.
+ * - Refer to page 99 of the datasheet, HSDAC is always connected to WG.
+ */
+static AD5940Err _get_HSDACCfg_Type(
+    HSLoopCfg_Type *const hs_loop_cfg,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const float e_start
+)
+{
+    AD5940Err error;
+
+    hs_loop_cfg->HsDacCfg.ExcitBufGain = hsdac_cfg->ExcitBufGain;
+    hs_loop_cfg->HsDacCfg.HsDacGain = hsdac_cfg->HsDacGain;
+    hs_loop_cfg->HsDacCfg.HsDacUpdateRate = (hsdac_cfg->HsDacUpdateRate < 7) ? 7 : hsdac_cfg->HsDacUpdateRate;
+
+    hs_loop_cfg->WgCfg.WgType = WGTYPE_MMR;
+    hs_loop_cfg->WgCfg.GainCalEn = hsdac_cfg->GainCalEn;
+    hs_loop_cfg->WgCfg.OffsetCalEn = hsdac_cfg->OffsetCalEn;
+
+    error = AD5940_ELECTROCHEMICAL_calculate_hsdac_dat_bits_by_potential(
+        e_start,
+        hsdac_cfg->ExcitBufGain,
+        hsdac_cfg->HsDacGain,
+        &(hs_loop_cfg->WgCfg.WgCode)
+    );
+    if(error) return error;
+
+    return AD5940ERR_OK;
+}
+
 AD5940Err AD5940_ELECTROCHEMICAL_config_afe_lpdac_lptia(
     const AD5940_ELECTROCHEMICAL_AFERefCfg_Type *const afe_ref_cfg,
     const float e_start
@@ -240,3 +278,62 @@ AD5940Err AD5940_ELECTROCHEMICAL_config_afe_lpdac_hstia(
 
     return AD5940ERR_OK;
 }
+
+AD5940Err AD5940_ELECTROCHEMICAL_config_afe_hsdac_hstia(
+    const AD5940_ELECTROCHEMICAL_AFERefCfg_Type *const afe_ref_cfg,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const float e_start
+)
+{
+    AD5940Err error;
+
+    AFERefCfg_Type aferef_cfg = {};
+    LPLoopCfg_Type lp_loop_cfg = {};
+    HSLoopCfg_Type hs_loop_cfg = {};
+    DSPCfg_Type dsp_cfg = {};
+
+    // @see page 34 of the datasheet, LP reference is not needed without LPDAC.
+    _get_AFERefCfg_Type(
+        &aferef_cfg,
+        afe_ref_cfg,
+        bFALSE
+    );
+
+    AD5940_StructInit(
+        &lp_loop_cfg, 
+        sizeof(lp_loop_cfg)
+    );
+
+    AD5940_StructInit(
+        &hs_loop_cfg, 
+        sizeof(hs_loop_cfg)
+    );
+
+    error = _get_HSDACCfg_Type(
+        &hs_loop_cfg,
+        hsdac_cfg,
+        e_start
+    );
+    if(error) return error;
+
+    AD5940_StructInit(
+        &dsp_cfg, 
+        sizeof(dsp_cfg)
+    );
+
+    _config(
+        &aferef_cfg,
+        &lp_loop_cfg,
+        &hs_loop_cfg,
+        &dsp_cfg,
+        0
+        | AFECTRL_HSTIAPWR
+        | AFECTRL_INAMPPWR
+        | AFECTRL_EXTBUFPWR
+        | AFECTRL_WG
+        | AFECTRL_DACREFPWR
+        | AFECTRL_HSDACPWR
+    );
+
+    return AD5940ERR_OK;
+}
@@ -35,6 +35,24 @@ AD5940Err AD5940_ELECTROCHEMICAL_config_afe_lpdac_hstia(
     const float e_start
 );
 
+/**
+ * @brief Configures the High Speed DAC (HSDAC) and High Speed TIA (HSTIA) measurement loop.
+ * 
+ * The HSDAC is driven in MMR mode, so the sequencer updates the potential by writing `HSDACDAT`.
+ * 
+ * @param afe_ref_cfg   Pointer to the utility-specific reference configuration type
+ *                      (`AD5940_ELECTROCHEMICAL_AFERefCfg_Type`).
+ * @param hsdac_cfg     Pointer to the utility-specific HSDAC configuration type
+ *                      (`AD5940_ELECTROCHEMICAL_HSDACCfg_Type`).
+ * @param e_start       The starting potential for the measurement (in volts).
+ * @return              Returns an `AD5940Err` error code indicating the success or failure of the configuration.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_config_afe_hsdac_hstia(
+    const AD5940_ELECTROCHEMICAL_AFERefCfg_Type *const afe_ref_cfg,
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    const float e_start
+);
+
 // /**
 //  * @ref AD5940_ELECTROCHEMICAL_STRUCT_get_MMR_HSLoopCfg_Type
 //  * @param V_out_peak_to_peak: TDAC output voltage in mV peak to peak. Maximum value is 800mVpp. Peak to peak voltage. (Refer to page 43 and page 103)
@@ -67,3 +67,36 @@ AD5940Err AD5940_ELECTROCHEMICAL_calculate_hsdac_dat_bits_by_potential(
         hsdac_dat_bits
     );
 }
+
+AD5940Err AD5940_ELECTROCHEMICAL_get_dac_sequence_command_by_potential(
+    const float potential, 
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    uint32_t *const sequence_command
+)
+{
+    AD5940Err error;
+    uint32_t dat_bits;
+
+    if(hsdac_cfg == NULL)
+    {
+        error = AD5940_ELECTROCHEMICAL_calculate_lpdac_dat_bits_by_potential(
+            potential,
+            &dat_bits
+        );
+        if(error) return error;
+        *sequence_command = SEQ_WR(REG_AFE_LPDACDAT0, dat_bits);
+    }
+    else
+    {
+        error = AD5940_ELECTROCHEMICAL_calculate_hsdac_dat_bits_by_potential(
+            potential,
+            hsdac_cfg->ExcitBufGain,
+            hsdac_cfg->HsDacGain,
+            &dat_bits
+        );
+        if(error) return error;
+        *sequence_command = SEQ_WR(REG_AFE_HSDACDAT, dat_bits);
+    }
+
+    return AD5940ERR_OK;
+}
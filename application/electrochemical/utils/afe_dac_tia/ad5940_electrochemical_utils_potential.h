@@ -6,6 +6,7 @@
  #endif
  
  #include "ad5940.h"
+ #include "ad5940_electrochemical_utils_dac_tia_adc_struct.h"
  
 /**
  * @brief Calculates the required 12-bit and 6-bit LPDAC data based on the input potential.
@@ -61,6 +62,22 @@ AD5940Err AD5940_ELECTROCHEMICAL_calculate_hsdac_dat_bits_by_potential(
     const uint32_t HSDACGAIN, 
     uint32_t *const hsdac_dat_bits
 );
+
+/**
+ * @brief Builds the sequencer command that sets the excitation DAC to the input potential.
+ *
+ * @param[in]  potential          Target output potential (in volts).
+ * @param[in]  hsdac_cfg          HSDAC configuration when the HSDAC drives the cell, 
+ *                                or NULL to drive LPDAC0 (`LPDACDAT0`).
+ * @param[out] sequence_command   Pointer to store the `SEQ_WR` command.
+ *
+ * @return AD5940Err              Returns an error code. Returns `AD5940_SUCCESS` if successful.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_get_dac_sequence_command_by_potential(
+    const float potential, 
+    const AD5940_ELECTROCHEMICAL_HSDACCfg_Type *const hsdac_cfg,
+    uint32_t *const sequence_command
+);
  
  #ifdef __cplusplus
  }
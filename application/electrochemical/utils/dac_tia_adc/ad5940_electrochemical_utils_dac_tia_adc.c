@@ -1,6 +1,7 @@
 #include "ad5940_electrochemical_utils_dac_tia_adc.h"
 
 #include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils_reconfigure.h"
 
 static void _get_LPAmpCfg_Type_with_LPTIA(
     LPAmpCfg_Type *const type,
@@ -161,8 +162,9 @@ AD5940Err AD5940_ELECTROCHEMICAL_config_lpdac_lptia_adc(
     const BoolFlag WGClkEnable
 )
 {
-    LPAmpCfg_Type lp_amp_cfg_type;
-    DSPCfg_Type dsp_cfg_type;
+    // Zeroed, the unused fields are compared by the reconfiguration.
+    LPAmpCfg_Type lp_amp_cfg_type = {};
+    DSPCfg_Type dsp_cfg_type = {};
 
     _get_LPAmpCfg_Type_with_LPTIA(
         &lp_amp_cfg_type,
@@ -177,8 +179,9 @@ AD5940Err AD5940_ELECTROCHEMICAL_config_lpdac_lptia_adc(
         dsp_cfg
     );
 
-    AD5940_LPAMPCfgS(&lp_amp_cfg_type);
-    AD5940_DSPCfgS(&dsp_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_lpamp(&lp_amp_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(&dsp_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_commit();
 
     return AD5940ERR_OK;
 }
@@ -192,10 +195,10 @@ AD5940Err AD5940_ELECTROCHEMICAL_config_lpdac_hstia_adc(
     const BoolFlag WGClkEnable
 )
 {
-    LPAmpCfg_Type lp_amp_cfg_type;
-    HSTIACfg_Type hstia_cfg_type;
-    SWMatrixCfg_Type sw_matrix_cfg;
-    DSPCfg_Type dsp_cfg_type;
+    LPAmpCfg_Type lp_amp_cfg_type = {};
+    HSTIACfg_Type hstia_cfg_type = {};
+    SWMatrixCfg_Type sw_matrix_cfg = {};
+    DSPCfg_Type dsp_cfg_type = {};
 
     _get_LPAmpCfg_Type_with_HSTIA(
         &lp_amp_cfg_type,
@@ -215,10 +218,45 @@ AD5940Err AD5940_ELECTROCHEMICAL_config_lpdac_hstia_adc(
         dsp_cfg
     );
 
-    AD5940_LPAMPCfgS(&lp_amp_cfg_type);
-    AD5940_HSTIACfgS(&hstia_cfg_type);
-    AD5940_SWMatrixCfgS(&sw_matrix_cfg);
-    AD5940_DSPCfgS(&dsp_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_lpamp(&lp_amp_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_hstia(&hstia_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_switch_matrix(&sw_matrix_cfg);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(&dsp_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_commit();
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_ELECTROCHEMICAL_config_hsdac_hstia_adc(
+    const AD5940_ELECTROCHEMICAL_HSTIACfg_Type *const hstia_cfg,
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *const electrode_routing,
+    const uint32_t ADCRate
+)
+{
+    HSTIACfg_Type hstia_cfg_type = {};
+    SWMatrixCfg_Type sw_matrix_cfg = {};
+    DSPCfg_Type dsp_cfg_type = {};
+
+    _get_HSTIACfg_Type(
+        &hstia_cfg_type,
+        hstia_cfg,
+        bFALSE
+    );
+    memcpy(&sw_matrix_cfg, electrode_routing, sizeof(SWMatrixCfg_Type));
+    // The waveform generator forwards HSDACDAT to the HSDAC, so it needs its clock.
+    _get_DSPCfg_Type(
+        &dsp_cfg_type, 
+        _TIA_SELECTION_HSTIA,
+        ADCRate,
+        bTRUE,
+        dsp_cfg
+    );
+
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_hstia(&hstia_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_switch_matrix(&sw_matrix_cfg);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(&dsp_cfg_type);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_commit();
 
     return AD5940ERR_OK;
 }
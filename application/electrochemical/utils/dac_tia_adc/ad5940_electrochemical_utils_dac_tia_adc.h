@@ -64,6 +64,29 @@ AD5940Err AD5940_ELECTROCHEMICAL_config_lpdac_hstia_adc(
     const BoolFlag WGClkEnable
 );
 
+/**
+ * @brief Configures the High Speed DAC (HSDAC) and High Speed TIA (HSTIA) measurement loop.
+ * 
+ * The HSDAC itself is configured by @ref AD5940_ELECTROCHEMICAL_config_afe_hsdac_hstia,
+ * the sequences then drive it through the waveform generator (HSDACDAT), which this function clocks.
+ * HSTIA is biased at 1.1 V because LPDAC does not provide V_zero on this path.
+ * 
+ * @param hstia_cfg         HSTIA settings (RTIA, DE0 resistors, capacitor), the bias is forced to 1.1 V
+ *                          (`AD5940_ELECTROCHEMICAL_HSTIACfg_Type`).
+ * @param dsp_cfg           ADC filter and DFT settings of the HSTIA measurement
+ *                          (`AD5940_ELECTROCHEMICAL_DSPCfg_Type`).
+ * @param electrode_routing Switch matrix connecting the HSDAC excitation amplifier to CE/RE
+ *                          and WE/SE to the HSTIA.
+ * @param ADCRate           ADC clock rate. Refer to @ref ADCRATE_Const.
+ * @return        Returns an `AD5940Err` error code indicating the success or failure of the configuration.
+ */
+AD5940Err AD5940_ELECTROCHEMICAL_config_hsdac_hstia_adc(
+    const AD5940_ELECTROCHEMICAL_HSTIACfg_Type *const hstia_cfg,
+    const AD5940_ELECTROCHEMICAL_DSPCfg_Type *const dsp_cfg,
+    const AD5940_ELECTROCHEMICAL_ELECTRODE_ROUTING *const electrode_routing,
+    const uint32_t ADCRate
+);
+
 // /**
 //  * @ref AD5940_ELECTROCHEMICAL_STRUCT_get_MMR_HSLoopCfg_Type
 //  * @param V_out_peak_to_peak: TDAC output voltage in mV peak to peak. Maximum value is 800mVpp. Peak to peak voltage. (Refer to page 43 and page 103)
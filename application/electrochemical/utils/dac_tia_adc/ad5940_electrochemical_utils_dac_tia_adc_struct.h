@@ -26,6 +26,7 @@ typedef struct
 {
     uint32_t ExcitBufGain;      /**< Select from  EXCITBUFGAIN_2, EXCITBUFGAIN_0P25 */     
     uint32_t HsDacGain;         /**< Select from  HSDACGAIN_1, HSDACGAIN_0P2 */
+    uint32_t HsDacUpdateRate;   /**< Divider for DAC update, range 7 to 255. Values below 7 are raised to 7. Refer to page 43 of the datasheet. */
     BoolFlag GainCalEn;         /**< Enable Gain calibration */
     BoolFlag OffsetCalEn;       /**< Enable offset calibration */
 }
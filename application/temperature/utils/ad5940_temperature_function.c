@@ -2,13 +2,15 @@
 
 #include "ad5940.h"
 #include "ad5940_utils.h"
+#include "ad5940_technique_context.h"
 
 static void _get_SEQCfg_Type(
     SEQCfg_Type *const type, 
-    BoolFlag enable
+    BoolFlag enable,
+    const uint32_t SeqMemSize
 )
 {
-    type->SeqMemSize = SEQMEMSIZE_2KB;  /* 2kB SRAM is used for sequencer, others for data FIFO */
+    type->SeqMemSize = SeqMemSize;      /* SRAM used for sequencer, others for data FIFO */
     type->SeqBreakEn = bFALSE;
     type->SeqIgnoreEn = bFALSE;
     type->SeqCntCRCClr = bTRUE;
@@ -19,16 +21,48 @@ static void _get_SEQCfg_Type(
 
 static void _get_FIFOCfg_Type(
     FIFOCfg_Type *const type, 
-    BoolFlag enable
+    BoolFlag enable,
+    const uint32_t FIFOSize
 )
 {
     type->FIFOEn = enable;
     type->FIFOMode = FIFOMODE_FIFO;
-    type->FIFOSize = FIFOSIZE_4KB;
+    type->FIFOSize = FIFOSize;
     return;
 }
 
+static uint32_t _get_stat_sample_number(
+    const uint32_t StatSample
+)
+{
+    return 128UL >> StatSample;
+}
+
+static AD5940Err _get_conversion_number(
+    const AD5940_TEMPERATURE_PARAMETERS *const parameters,
+    uint32_t *const conversion_number
+)
+{
+    switch (parameters->chop_mode)
+    {
+    case AD5940_TEMPERATURE_CHOP_MODE_OFF:
+        *conversion_number = 1;
+        return AD5940ERR_OK;
+
+    case AD5940_TEMPERATURE_CHOP_MODE_ON_CHIP:
+        if(parameters->StatSample > STATSAMPLE_8) return AD5940ERR_PARA;
+        *conversion_number = _get_stat_sample_number(parameters->StatSample);
+        return AD5940ERR_OK;
+
+    case AD5940_TEMPERATURE_CHOP_MODE_HOST:
+        *conversion_number = 2;
+        return AD5940ERR_OK;
+    }
+    return AD5940ERR_PARA;
+}
+
 static void _ad5940_analog_config(
+    const AD5940_TEMPERATURE_PARAMETERS *const parameters,
     const AD5940_TEMPERATURE_ANALOG_CONFIG *const analog_cfg,
     const AD5940_ClockConfig *const clock_cfg
 )
@@ -36,6 +70,7 @@ static void _ad5940_analog_config(
     AFERefCfg_Type aferef_cfg;
     ADCBaseCfg_Type adc_base;
     ADCFilterCfg_Type adc_filter;
+    StatCfg_Type stat_cfg;
     //init ad5940 for temperature measurement.
     AD5940_AFECtrlS(AFECTRL_ALL, bFALSE);  /* Init all to disable state */
     aferef_cfg.HpBandgapEn = bTRUE;
@@ -66,18 +101,19 @@ static void _ad5940_analog_config(
     adc_filter.BpSinc3 = analog_cfg->BpSinc3;
     adc_filter.Sinc2NotchEnable = analog_cfg->Sinc2NotchEnable;
     AD5940_ADCFilterCfgS(&adc_filter);
+    /* The statistics block averages the chopped conversions of one wakeup */
+    stat_cfg.StatDev = STATDEV_1;
+    stat_cfg.StatSample = parameters->StatSample;
+    stat_cfg.StatEnable = (parameters->chop_mode == AD5940_TEMPERATURE_CHOP_MODE_ON_CHIP) ? bTRUE : bFALSE;
+    AD5940_StatisticCfgS(&stat_cfg);
     AD5940_AFECtrlS(AFECTRL_TEMPSPWR, bTRUE);   /* Turn on temperature sensor power */
     return;
 }
 
-static SEQInfo_Type _temperature_seq_info = {
-    .SeqId = SEQID_0,       // use SEQ0 to run this sequence
-    .WriteSRAM = bTRUE,     // we need to write this sequence to AD5940 SRAM.
-};
-
 static AD5940Err _write_temperature_sequence_commands(
 	const uint32_t start_address,
     uint32_t *const sequence_length,
+    const uint32_t conversion_number,
     const AD5940_TEMPERATURE_ANALOG_CONFIG *const analog_cfg,
     const AD5940_ClockConfig *const clock_cfg
 )
@@ -89,7 +125,7 @@ static AD5940Err _write_temperature_sequence_commands(
     ClksCalInfo_Type clks_cal;
     uint32_t WaitClks;
     clks_cal.DataType = analog_cfg->DataType;
-    clks_cal.DataCount = 1;             /* Sample one data when wakeup */
+    clks_cal.DataCount = conversion_number;     /* Sample all the chopped conversions of one wakeup back to back */
     clks_cal.ADCSinc2Osr = analog_cfg->ADCSinc2Osr;
     clks_cal.ADCSinc3Osr = analog_cfg->ADCSinc3Osr;
     clks_cal.ADCAvgNum = analog_cfg->ADCAvgNum;
@@ -112,34 +148,40 @@ static AD5940Err _write_temperature_sequence_commands(
 
     if(error != AD5940ERR_OK) return error;
 
+    SEQInfo_Type *const temperature_seq_info = &AD5940_TECHNIQUE_CONTEXT_get()->temperature_seq_info;
     *sequence_length = seq_len;
-    _temperature_seq_info.SeqRamAddr = start_address;
-    _temperature_seq_info.pSeqCmd = pSeqCmd;
-    _temperature_seq_info.SeqLen = seq_len;
-    AD5940_SEQInfoCfg(&_temperature_seq_info);
+    temperature_seq_info->SeqRamAddr = start_address;
+    temperature_seq_info->pSeqCmd = pSeqCmd;
+    temperature_seq_info->SeqLen = seq_len;
+    AD5940_SEQInfoCfg(temperature_seq_info);
 
     return error;
 }
 
 static AD5940Err _write_sequence_commands(
+    const AD5940_TEMPERATURE_PARAMETERS *const parameters,
     const AD5940_TEMPERATURE_ANALOG_CONFIG *const config,
     const AD5940_ClockConfig *const clock_cfg
 )
 {
     AD5940Err error = AD5940ERR_OK;
 
+    uint32_t conversion_number;
+    error = _get_conversion_number(parameters, &conversion_number);
+    if(error != AD5940ERR_OK) return error;
+
     /* Wakeup AFE by read register, read 10 times at most */
     if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
 
     SEQCfg_Type seq_cfg;
     FIFOCfg_Type fifo_cfg;
     
-    /* Configure sequencer and stop it */
-    _get_SEQCfg_Type(&seq_cfg, bFALSE);
+    /* Configure sequencer and stop it, the sequence is written with the largest sequencer memory */
+    _get_SEQCfg_Type(&seq_cfg, bFALSE, SEQMEMSIZE_4KB);
     AD5940_SEQCfg(&seq_cfg);
 
     /* Reconfigure FIFO */
-    _get_FIFOCfg_Type(&fifo_cfg, bFALSE);
+    _get_FIFOCfg_Type(&fifo_cfg, bFALSE, FIFOSIZE_2KB);
     AD5940_FIFOCfg(&fifo_cfg);
 
     AD5940_clear_GPIO_and_INT_flag();
@@ -151,6 +193,7 @@ static AD5940Err _write_sequence_commands(
     error = _write_temperature_sequence_commands(
         sequence_address,
         &sequence_commands_length,
+        conversion_number,
         config,
         clock_cfg
     );
@@ -160,6 +203,27 @@ static AD5940Err _write_sequence_commands(
     return error;
 }
 
+/**
+ * @brief Gives the SRAM not used by the sequence to the data FIFO, refer to @ref AD5940_configure_sram.
+ */
+static AD5940Err _configure_sram(
+    const AD5940_SRAM_PARTITION partition,
+    const uint32_t FIFO_thresh
+)
+{
+    const SEQInfo_Type *const temperature_seq_info = &AD5940_TECHNIQUE_CONTEXT_get()->temperature_seq_info;
+
+    SEQCfg_Type seq_cfg;
+    _get_SEQCfg_Type(&seq_cfg, bFALSE, SEQMEMSIZE_4KB);
+
+    return AD5940_configure_sram(
+        partition,
+        temperature_seq_info->SeqRamAddr + temperature_seq_info->SeqLen,
+        FIFO_thresh,
+        &seq_cfg
+    );
+}
+
 static AD5940Err _start_wakeup_timer_sequence(
     const uint32_t FIFO_thresh, 
     const float sampling_interval,
@@ -174,54 +238,128 @@ static AD5940Err _start_wakeup_timer_sequence(
     AD5940_SEQCtrlS(bTRUE);
 
     /* Configure Wakeup Timer*/
+    const uint32_t SeqId = AD5940_TECHNIQUE_CONTEXT_get()->temperature_seq_info.SeqId;
     WUPTCfg_Type wupt_cfg;
     wupt_cfg.WuptEn = bTRUE;
     wupt_cfg.WuptEndSeq = WUPTENDSEQ_A;
-    wupt_cfg.WuptOrder[0] = _temperature_seq_info.SeqId;
-    wupt_cfg.SeqxSleepTime[_temperature_seq_info.SeqId] = 1; /* The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock_cfg. */
-    wupt_cfg.SeqxWakeupTime[_temperature_seq_info.SeqId] = (uint32_t)(LFOSC_frequency * sampling_interval) - 1;
+    wupt_cfg.WuptOrder[0] = SeqId;
+    wupt_cfg.SeqxSleepTime[SeqId] = 1; /* The minimum value is 1. Do not set it to zero. Set it to 1 will spend 2 32kHz clock_cfg. */
+    wupt_cfg.SeqxWakeupTime[SeqId] = (uint32_t)(LFOSC_frequency * sampling_interval) - 1;
     AD5940_WUPTCfg(&wupt_cfg);
 
     return AD5940ERR_OK;
 }
 
-AD5940Err AD5940_TEMPERATURE_start(
+static AD5940Err _start(
     const AD5940_TEMPERATURE_START_CONFIG *const config
 )
 {
     AD5940Err error = AD5940ERR_OK;
 
+    /* The statistics block only averages the SINC2+Notch output */
+    uint32_t FifoSrc = config->analog_cfg->FifoSrc;
+    if(config->parameters->chop_mode == AD5940_TEMPERATURE_CHOP_MODE_ON_CHIP)
+    {
+        if(config->analog_cfg->Sinc2NotchEnable != bTRUE) return AD5940ERR_PARA;
+        FifoSrc = FIFOSRC_MEAN;
+    }
+
     /* Wakeup AFE by read register, read 10 times at most */
     if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
 
+    /* The AFE and the SRAM are configured below without the reconfiguration */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate();
+
     AD5940_WriteReg(REG_AFE_TEMPSENS, config->parameters->TEMPSENS);
     
     AD5940_clear_GPIO_and_INT_flag();
 
     _ad5940_analog_config(
+        config->parameters,
         config->analog_cfg,
         config->run_cfg->clock_cfg
     );
-    _write_sequence_commands(
+    error = _write_sequence_commands(
+        config->parameters,
         config->analog_cfg,
         config->run_cfg->clock_cfg
     );
+    if(error) return error;
+
+    error = _configure_sram(
+        config->run_cfg->sram_partition,
+        config->run_cfg->FIFO_thresh
+    );
+    if(error) return error;
 
     // Ensure it is cleared as ad5940.c relies on the INTC flag as well.
     AD5940_INTCClrFlag(AFEINTSRC_ALLINT);
 
     AGPIOCfg_Type agpio_cfg;
     memcpy(&agpio_cfg, config->run_cfg->agpio_cfg, sizeof(AGPIOCfg_Type));
-    AD5940_set_INTCCfg_by_AGPIOCfg_Type(&agpio_cfg, AFEINTSRC_DATAFIFOTHRESH);
+    AD5940_set_INTCCfg_by_AGPIOCfg_Type(&agpio_cfg, AFEINTSRC_DATAFIFOTHRESH | AD5940_FIFO_ERROR_INTSRC);
     AD5940_AGPIOCfg(&agpio_cfg);
 
     error = _start_wakeup_timer_sequence(
         config->run_cfg->FIFO_thresh,
         config->parameters->sampling_interval,
-        config->analog_cfg->FifoSrc,
+        FifoSrc,
         config->run_cfg->LFOSC_frequency
     );
     if(error) return error;
 	
     return AD5940ERR_OK;
 }
+
+AD5940Err AD5940_TEMPERATURE_start(
+    AD5940_DEVICE *const device,
+    const AD5940_TEMPERATURE_START_CONFIG *const config
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_TECHNIQUE_CONTEXT_select(device);
+    if(error != AD5940ERR_OK) return error;
+
+    AD5940_METRICS_BEGIN(begin);
+    error = _start(config);
+    AD5940_METRICS_END(AD5940_METRICS_PHASE_START, begin);
+
+    return error;
+}
+
+AD5940Err AD5940_TEMPERATURE_get_fifo_count(
+    const AD5940_TEMPERATURE_PARAMETERS *const parameters,
+    uint16_t *const FIFO_count
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    uint32_t conversion_number;
+    error = _get_conversion_number(parameters, &conversion_number);
+    if(error != AD5940ERR_OK) return error;
+
+    *FIFO_count = (parameters->chop_mode == AD5940_TEMPERATURE_CHOP_MODE_ON_CHIP)
+        ? 1
+        : (uint16_t) conversion_number;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_TEMPERATURE_average_chop_pairs(
+    uint32_t *const data,
+    const uint32_t length,
+    uint32_t *const averaged_length
+)
+{
+    if(length % 2 != 0) return AD5940ERR_PARA;
+
+    for(uint32_t i=0; i<length/2; i++)
+    {
+        /* ADC codes are 16 bits, the sum of a pair never overflows */
+        data[i] = ((data[2*i] & 0xFFFF) + (data[2*i+1] & 0xFFFF) + 1) / 2;
+    }
+    *averaged_length = length / 2;
+
+    return AD5940ERR_OK;
+}
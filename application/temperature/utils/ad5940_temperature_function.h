@@ -6,6 +6,7 @@ extern "C"
 #endif
 
 #include "ad5940_temperature_struct.h"
+#include "ad5940_device.h"
 
 /**
  * @brief Starts the temperature measurement process on the AD5940.
@@ -14,6 +15,8 @@ extern "C"
  * ADC settings, FIFO thresholds, and interrupts. It uses the specified configuration 
  * structure to define measurement parameters such as sampling frequency and FIFO settings.
  *
+ * @param device A device to start, or NULL for the selected device (single AD5940).
+ *               Refer to @ref AD5940_TECHNIQUE_CONTEXT_select.
  * @param config A pointer to an `AD5940_TEMPERATURE_START_CONFIG` structure that 
  *               contains all the required configuration parameters.
  * 
@@ -21,9 +24,42 @@ extern "C"
  *                   success, while any other value represents an error during initialization.
  */
 AD5940Err AD5940_TEMPERATURE_start(
+    AD5940_DEVICE *const device,
     const AD5940_TEMPERATURE_START_CONFIG *const config
 );
 
+/**
+ * @brief Gets the number of FIFO data produced per sampling interval.
+ *
+ * @param parameters    Temperature parameters.
+ * @param FIFO_count    Pointer to store the number of FIFO data per sampling interval.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_TEMPERATURE_get_fifo_count(
+    const AD5940_TEMPERATURE_PARAMETERS *const parameters,
+    uint16_t *const FIFO_count
+);
+
+/**
+ * @brief Averages the conversion pairs of @ref AD5940_TEMPERATURE_CHOP_MODE_HOST in place.
+ *
+ * The data of every sampling interval are averaged into one value,
+ * the same value @ref AD5940_TEMPERATURE_CHOP_MODE_ON_CHIP writes to the FIFO.
+ * The FIFO data must start at the first conversion of a pair.
+ *
+ * @param data          FIFO data, the averaged values are written back to the beginning of the array.
+ * @param length        Number of FIFO data, must be even.
+ * @param averaged_length   Pointer to store the number of averaged values.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_TEMPERATURE_average_chop_pairs(
+    uint32_t *const data,
+    const uint32_t length,
+    uint32_t *const averaged_length
+);
+
 #ifdef __cplusplus
 }
 #endif
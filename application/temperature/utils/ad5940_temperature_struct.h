@@ -38,9 +38,27 @@ typedef struct
     float LFOSC_frequency;                  /**< Low-frequency oscillator frequency, used for internal timing.
                                                  Obtainable via @ref AD5940_LFOSCMeasure in library/ad5940.h.*/
     uint16_t FIFO_thresh;                   /**< FIFO threshold value. Interrupt is triggered when this threshold is reached. */
+    AD5940_SRAM_PARTITION sram_partition;   /**< Split of SRAM between sequence and data FIFO, zero for @ref AD5940_SRAM_PARTITION_AUTO.
+                                                 Refer to utils/ad5940_utils_fifo.h. */
 }
 AD5940_TEMPERATURE_RUN_CONFIG;
 
+/**
+ * @brief Averaging of the chopped temperature sensor conversions.
+ *
+ * In chop mode the temperature sensor output alternates between two polarities,
+ * so an even number of conversions must be averaged to cancel the offset.
+ */
+typedef enum
+{
+    AD5940_TEMPERATURE_CHOP_MODE_OFF = 0,   /**< One conversion per sampling interval. Use it when chopping is disabled in `TEMPSENS`. */
+    AD5940_TEMPERATURE_CHOP_MODE_ON_CHIP,   /**< `StatSample` conversions per sampling interval, averaged by the statistics block.
+                                                 The FIFO receives one mean value per sampling interval. */
+    AD5940_TEMPERATURE_CHOP_MODE_HOST,      /**< One pair of conversions per sampling interval, averaged by
+                                                 @ref AD5940_TEMPERATURE_average_chop_pairs after reading the FIFO. */
+}
+AD5940_TEMPERATURE_CHOP_MODE;
+
 typedef struct
 {
     float sampling_interval;    /**< Sampling interval in microseconds. */
@@ -52,6 +70,9 @@ typedef struct
                                      temperature sensor channel and that these results are averaged.
                                      ```
                                      See TEMPCON0 configuration details on page 61 of the datasheet. */
+    AD5940_TEMPERATURE_CHOP_MODE chop_mode;     /**< Averaging of the chopped conversions. */
+    uint32_t StatSample;                        /**< Number of conversions averaged on chip, only used by
+                                                     @ref AD5940_TEMPERATURE_CHOP_MODE_ON_CHIP. Refer to @ref STATSAMPLE_Const. */
 }
 AD5940_TEMPERATURE_PARAMETERS;
 
@@ -4,17 +4,43 @@ function(import_ad5940 TARGET_NAME AD5940_DIR)
         message(FATAL_ERROR "Given AD5940_DIR path '${AD5940_DIR}' is not valid")
     endif()
 
-    # Search for source files
+    # Search for source files, the host tools have their own main()
     file(GLOB_RECURSE AD5940_SOURCES
         ${AD5940_DIR}/*.c
     )
+    list(FILTER AD5940_SOURCES EXCLUDE REGEX "^${AD5940_DIR}/tools/")
     target_sources(${TARGET_NAME} PRIVATE ${AD5940_SOURCES})
 
     # Add all subdirectories as include paths
     file(GLOB_RECURSE AD5940_RECURSE_DIRS LIST_DIRECTORIES true ${AD5940_DIR})
     foreach(_dir IN LISTS AD5940_RECURSE_DIRS)
-        if(IS_DIRECTORY ${_dir})
+        if(IS_DIRECTORY ${_dir} AND NOT _dir MATCHES "^${AD5940_DIR}/tools")
             target_include_directories(${TARGET_NAME} PRIVATE ${_dir})
         endif()
     endforeach()
 endfunction()
+
+# Host tool listing and replaying the SPI traces of main/ad5940_trace.h.
+# Needs ad5940.c in AD5940_DIR/library, like import_ad5940.
+function(add_ad5940_trace_replay TARGET_NAME AD5940_DIR)
+    add_executable(${TARGET_NAME} ${AD5940_DIR}/tools/trace_replay/ad5940_trace_replay.c)
+    import_ad5940(${TARGET_NAME} ${AD5940_DIR})
+    target_compile_definitions(${TARGET_NAME} PRIVATE AD5940_DEVICE_PORT_ENABLE)
+endfunction()
+
+# Host benchmark of the sequence generation, upload and conversion hot paths, against a stub port.
+# Needs ad5940.c in AD5940_DIR/library, like import_ad5940.
+function(add_ad5940_benchmark TARGET_NAME AD5940_DIR)
+    add_executable(${TARGET_NAME} ${AD5940_DIR}/tools/benchmark/ad5940_benchmark.c)
+    import_ad5940(${TARGET_NAME} ${AD5940_DIR})
+    target_compile_definitions(${TARGET_NAME} PRIVATE AD5940_DEVICE_PORT_ENABLE)
+    target_link_libraries(${TARGET_NAME} PRIVATE m)
+endfunction()
+
+# Host decoder of the measurement streams of utils/ad5940_utils_stream.h.
+# Needs ad5940.c in AD5940_DIR/library, like import_ad5940.
+function(add_ad5940_stream_dump TARGET_NAME AD5940_DIR)
+    add_executable(${TARGET_NAME} ${AD5940_DIR}/tools/stream_dump/ad5940_stream_dump.c)
+    import_ad5940(${TARGET_NAME} ${AD5940_DIR})
+    target_link_libraries(${TARGET_NAME} PRIVATE m)
+endfunction()
@@ -0,0 +1,236 @@
+#include "ad5940_device.h"
+
+#include "ad5940_utils.h"
+
+static AD5940_DEVICE *_selected_device = NULL;
+
+AD5940Err AD5940_DEVICE_init(
+    AD5940_DEVICE *const device,
+    const AD5940_PORT_OPS *const port,
+    uint32_t *const sequence_generator_buffer,
+    const uint16_t sequence_generator_buffer_length
+)
+{
+    if(device == NULL) return AD5940ERR_PARA;
+    if(port == NULL) return AD5940ERR_PARA;
+    if(sequence_generator_buffer == NULL) return AD5940ERR_PARA;
+    if(sequence_generator_buffer_length == 0) return AD5940ERR_PARA;
+
+    device->port = port;
+    device->sequence_generator_buffer = sequence_generator_buffer;
+    device->sequence_generator_buffer_length = sequence_generator_buffer_length;
+    device->shadow = NULL;
+    device->trace = NULL;
+    device->technique = NULL;
+    device->metrics = NULL;
+
+    /* The buffer may have changed, bind it again on the next selection */
+    if(device == _selected_device) _selected_device = NULL;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_DEVICE_enable_shadow(
+    AD5940_DEVICE *const device,
+    AD5940_SHADOW *const shadow
+)
+{
+    if(device == NULL) return AD5940ERR_PARA;
+
+    device->shadow = NULL;
+    if(shadow == NULL) return AD5940ERR_OK;
+
+    AD5940Err error = AD5940_SHADOW_init(shadow);
+    if(error) return error;
+    device->shadow = shadow;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_DEVICE_enable_trace(
+    AD5940_DEVICE *const device,
+    AD5940_TRACE *const trace
+)
+{
+    if(device == NULL) return AD5940ERR_PARA;
+    if((trace != NULL) && (trace->buffer == NULL)) return AD5940ERR_PARA;
+
+    device->trace = trace;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_DEVICE_enable_metrics(
+    AD5940_DEVICE *const device,
+    AD5940_METRICS *const metrics
+)
+{
+    if(device == NULL) return AD5940ERR_PARA;
+
+    device->metrics = metrics;
+    if(device == _selected_device) AD5940_METRICS_bind(metrics);
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_DEVICE_select(
+    AD5940_DEVICE *const device
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    if(device == NULL) return AD5940ERR_PARA;
+    if(device->port == NULL) return AD5940ERR_PARA;
+
+    AD5940_METRICS_bind(device->metrics);
+
+    /* SEQGenInit drops the sequence generator state, only do it when switching buffers */
+    if(device == _selected_device) return AD5940ERR_OK;
+
+    _selected_device = device;
+
+    error = AD5940_set_sequence_generator_buffer(
+        device->sequence_generator_buffer,
+        device->sequence_generator_buffer_length
+    );
+    if(error) return error;
+
+    return AD5940ERR_OK;
+}
+
+AD5940_DEVICE *AD5940_DEVICE_get_selected(void)
+{
+    return _selected_device;
+}
+
+#ifdef AD5940_DEVICE_PORT_ENABLE
+
+/**
+ * Port functions of the trace recorder, they record into the trace of the selected device
+ * and forward to its port.
+ */
+
+static void _trace_cs_clr(void)
+{
+    AD5940_TRACE_cs_clr(_selected_device->trace, _selected_device->port);
+}
+
+static void _trace_cs_set(void)
+{
+    AD5940_TRACE_cs_set(_selected_device->trace, _selected_device->port);
+}
+
+static void _trace_rst_clr(void)
+{
+    AD5940_TRACE_rst_clr(_selected_device->trace, _selected_device->port);
+}
+
+static void _trace_rst_set(void)
+{
+    AD5940_TRACE_rst_set(_selected_device->trace, _selected_device->port);
+}
+
+static void _trace_delay_10us(uint32_t time)
+{
+    AD5940_TRACE_delay_10us(_selected_device->trace, _selected_device->port, time);
+}
+
+static void _trace_read_write_n_bytes(unsigned char *pSendBuffer, unsigned char *pRecvBuff, unsigned long length)
+{
+    AD5940_TRACE_read_write_n_bytes(_selected_device->trace, _selected_device->port, pSendBuffer, pRecvBuff, length);
+}
+
+static uint32_t _trace_get_mcu_int_flag(void)
+{
+    return AD5940_TRACE_get_mcu_int_flag(_selected_device->trace, _selected_device->port);
+}
+
+static uint32_t _trace_clr_mcu_int_flag(void)
+{
+    return _selected_device->port->clr_mcu_int_flag();
+}
+
+static const AD5940_PORT_OPS _trace_port = {
+    .cs_clr = _trace_cs_clr,
+    .cs_set = _trace_cs_set,
+    .rst_clr = _trace_rst_clr,
+    .rst_set = _trace_rst_set,
+    .delay_10us = _trace_delay_10us,
+    .read_write_n_bytes = _trace_read_write_n_bytes,
+    .get_mcu_int_flag = _trace_get_mcu_int_flag,
+    .clr_mcu_int_flag = _trace_clr_mcu_int_flag,
+};
+
+/**
+ * Port of the selected device, behind the trace recorder when it is enabled.
+ */
+static const AD5940_PORT_OPS *_get_port(void)
+{
+    return (_selected_device->trace != NULL) ? &_trace_port : _selected_device->port;
+}
+
+/**
+ * Port functions required by ad5940.c, routed to the selected device.
+ * Define AD5940_DEVICE_PORT_ENABLE instead of implementing them in the platform code.
+ */
+
+void AD5940_CsClr(void)
+{
+    if(_selected_device->shadow != NULL)
+    {
+        AD5940_SHADOW_cs_clr(_selected_device->shadow, _get_port());
+        return;
+    }
+    _get_port()->cs_clr();
+}
+
+void AD5940_CsSet(void)
+{
+    if(_selected_device->shadow != NULL)
+    {
+        AD5940_SHADOW_cs_set(_selected_device->shadow, _get_port());
+        return;
+    }
+    _get_port()->cs_set();
+}
+
+void AD5940_RstClr(void)
+{
+    if(_selected_device->shadow != NULL)
+    {
+        AD5940_SHADOW_invalidate(_selected_device->shadow);
+    }
+    _get_port()->rst_clr();
+}
+
+void AD5940_RstSet(void)
+{
+    _get_port()->rst_set();
+}
+
+void AD5940_Delay10us(uint32_t time)
+{
+    _get_port()->delay_10us(time);
+}
+
+void AD5940_ReadWriteNBytes(unsigned char *pSendBuffer, unsigned char *pRecvBuff, unsigned long length)
+{
+    if(_selected_device->shadow != NULL)
+    {
+        AD5940_SHADOW_read_write_n_bytes(_selected_device->shadow, _get_port(), pSendBuffer, pRecvBuff, length);
+        return;
+    }
+    _get_port()->read_write_n_bytes(pSendBuffer, pRecvBuff, length);
+}
+
+uint32_t AD5940_GetMCUIntFlag(void)
+{
+    return _get_port()->get_mcu_int_flag();
+}
+
+uint32_t AD5940_ClrMCUIntFlag(void)
+{
+    return _get_port()->clr_mcu_int_flag();
+}
+
+#endif
@@ -0,0 +1,138 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_port.h"
+#include "ad5940_shadow.h"
+#include "ad5940_trace.h"
+#include "ad5940_utils_metrics.h"
+
+struct AD5940_TECHNIQUE_CONTEXT;
+
+/**
+ * @brief Context of one AD5940.
+ *
+ * `ad5940.c` and the applications talk to "the" AD5940 through the port functions and a single
+ * sequence generator. A device context carries what differs between chips, and
+ * @ref AD5940_DEVICE_select points the port functions and the sequence generator at it.
+ * The sequences of a technique keep running from the SRAM of the device after its `*_start`,
+ * so their state is kept per device too, in the technique context of the device
+ * (see `AD5940_TECHNIQUE_CONTEXT_init` in application/ad5940_technique_context.h).
+ *
+ * Once started, every AD5940 runs its sequences on its own. The `*_start` functions and the
+ * interrupt handlers take the device they drive and select it, so independent measurements
+ * run in parallel on several chips.
+ */
+typedef struct
+{
+    const AD5940_PORT_OPS *port;                /**< Platform functions of the device. */
+    uint32_t *sequence_generator_buffer;        /**< Sequence generator buffer of the device.
+                                                     Refer to @ref AD5940_set_sequence_generator_buffer. */
+    uint16_t sequence_generator_buffer_length;  /**< Length of the sequence generator buffer (in words). */
+    AD5940_SHADOW *shadow;                      /**< Register shadow of the device, or NULL to disable it.
+                                                     Refer to @ref AD5940_DEVICE_enable_shadow. */
+    AD5940_TRACE *trace;                        /**< SPI trace recorder of the device, or NULL to disable it.
+                                                     Refer to @ref AD5940_DEVICE_enable_trace. */
+    struct AD5940_TECHNIQUE_CONTEXT *technique; /**< Technique state of the device, or NULL for the default one.
+                                                     Refer to `AD5940_TECHNIQUE_CONTEXT_init`. */
+    AD5940_METRICS *metrics;                    /**< Metrics of the device, or NULL to disable them.
+                                                     Refer to @ref AD5940_DEVICE_enable_metrics. */
+}
+AD5940_DEVICE;
+
+/**
+ * @brief Initializes a device context.
+ *
+ * @param device                            Device context to initialize.
+ * @param port                              Platform functions of the device.
+ * @param sequence_generator_buffer         Buffer used for sequence generation, one per device.
+ * @param sequence_generator_buffer_length  Length of the sequence generator buffer (in words).
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_DEVICE_init(
+    AD5940_DEVICE *const device,
+    const AD5940_PORT_OPS *const port,
+    uint32_t *const sequence_generator_buffer,
+    const uint16_t sequence_generator_buffer_length
+);
+
+/**
+ * @brief Puts a register shadow between `ad5940.c` and the port functions of a device.
+ *
+ * Needs AD5940_DEVICE_PORT_ENABLE, the shadow works on the SPI transactions routed by the device.
+ * Unchanged register writes are dropped and reads of known configuration registers are
+ * answered locally, see @ref AD5940_SHADOW.
+ *
+ * @param device    Device context.
+ * @param shadow    Shadow storage of the device, or NULL to disable the shadow.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_DEVICE_enable_shadow(
+    AD5940_DEVICE *const device,
+    AD5940_SHADOW *const shadow
+);
+
+/**
+ * @brief Records the SPI transactions of a device into a trace.
+ *
+ * Needs AD5940_DEVICE_PORT_ENABLE, the recorder sits below the register shadow and records
+ * what is actually sent over SPI, see @ref AD5940_TRACE. The recorder must be initialized
+ * with @ref AD5940_TRACE_init, and the trace can be replayed offline with @ref AD5940_TRACE_REPLAY.
+ *
+ * @param device    Device context.
+ * @param trace     Initialized recorder of the device, or NULL to stop recording.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_DEVICE_enable_trace(
+    AD5940_DEVICE *const device,
+    AD5940_TRACE *const trace
+);
+
+/**
+ * @brief Records the latency metrics of a device, see @ref AD5940_METRICS.
+ *
+ * The metrics are bound with @ref AD5940_METRICS_bind whenever the device is selected.
+ *
+ * @param device    Device context.
+ * @param metrics   Initialized metrics of the device, or NULL to stop recording.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_DEVICE_enable_metrics(
+    AD5940_DEVICE *const device,
+    AD5940_METRICS *const metrics
+);
+
+/**
+ * @brief Selects the device driven by the following AD5940 calls.
+ *
+ * Routes the port functions to `device->port`, binds the metrics of the device and, when the
+ * selection changes, binds the sequence generator to the buffer of the device. Selecting the
+ * selected device again keeps the sequence generator as it is. Selecting is not thread safe,
+ * the devices must be driven from one thread or behind one lock.
+ *
+ * @param device    Device context to select.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_DEVICE_select(
+    AD5940_DEVICE *const device
+);
+
+/**
+ * @brief Gets the selected device.
+ *
+ * @return AD5940_DEVICE* Selected device, or NULL if no device is selected.
+ */
+AD5940_DEVICE *AD5940_DEVICE_get_selected(void);
+
+#ifdef __cplusplus
+}
+#endif
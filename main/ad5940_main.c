@@ -1,5 +1,52 @@
 #include "ad5940_main.h"
 #include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils_reconfigure.h"
+
+#define AD5940_ADIID 0x4144     // Analog Devices Inc. identifier, read back once the AD5940 is out of reset.
+#define RESET_PULSE 200         // Time the reset pin is held low (in 10us), 2ms as AD5940_HWReset.
+#define PWRMOD_ACTIVE 1         // PWRMOD mode of an awake AD5940, 2 in hibernate. Refer to the PWRMOD register of the datasheet.
+#define RESET_POLL_STEP 1       // Time between two readiness polls (in 10us).
+
+/**
+ * The AD5940 is ready once it answers with its identifiers and reports the active power mode.
+ * A floating MISO reads all zeros or all ones.
+ */
+static BoolFlag _is_ready(void)
+{
+    if(AD5940_ReadReg(REG_AFECON_ADIID) != AD5940_ADIID) return bFALSE;
+
+    const uint32_t chip_id = AD5940_ReadReg(REG_AFECON_CHIPID);
+    if((chip_id == 0) || (chip_id == 0xFFFF)) return bFALSE;
+
+    if((AD5940_ReadReg(REG_ALLON_PWRMOD) & BITM_ALLON_PWRMOD_PWRMOD) != PWRMOD_ACTIVE) return bFALSE;
+
+    return bTRUE;
+}
+
+static AD5940Err _wait_ready(
+    const uint32_t timeout,
+    uint32_t *const elapsed
+)
+{
+    *elapsed = 0;
+    while(_is_ready() == bFALSE)
+    {
+        if(*elapsed >= timeout) return AD5940ERR_TIMEOUT;
+        AD5940_Delay10us(RESET_POLL_STEP);
+        *elapsed += RESET_POLL_STEP;
+    }
+    return AD5940ERR_OK;
+}
+
+static void _hardware_reset(void)
+{
+    /* The reset clears the AFE configuration and the SRAM */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate();
+
+    AD5940_RstClr();
+    AD5940_Delay10us(RESET_PULSE);
+    AD5940_RstSet();
+}
 
 AD5940Err AD5940_MAIN_init(
     uint32_t *const sequencer_generator_buffer, 
@@ -15,14 +62,22 @@ AD5940Err AD5940_MAIN_init(
     );
     if(error) return error;
 
+    /* Nothing written before the init is known to be kept */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate();
+
     // Reset
+    uint32_t elapsed;
     switch (reset_option)
     {
     case 1:
-        AD5940_HWReset();
+        _hardware_reset();
+        error = _wait_ready(AD5940_MAIN_RESET_TIMEOUT, &elapsed);
+        if(error) return error;
         break;
     case 2:
         AD5940_SoftRst();
+        error = _wait_ready(AD5940_MAIN_RESET_TIMEOUT, &elapsed);
+        if(error) return error;
         break;
     }
 
@@ -38,27 +93,158 @@ AD5940Err AD5940_MAIN_init(
     return AD5940ERR_OK;
 }
 
+static void _configure_after_reset(void)
+{
+    /* Platform configuration */
+    AD5940_Initialize();
+
+    /* Enable AFE to enter sleep mode. */
+    AD5940_SleepKeyCtrlS(SLPKEY_UNLOCK);
+
+    /* Goto hibernate */
+    AD5940_EnterSleepS();
+}
+
 AD5940Err AD5940_MAIN_reset(void)
+{
+    uint32_t elapsed;
+
+    return AD5940_MAIN_reset_with_timeout(
+        AD5940_MAIN_RESET_TIMEOUT,
+        &elapsed
+    );
+}
+
+AD5940Err AD5940_MAIN_reset_with_timeout(
+    const uint32_t timeout,
+    uint32_t *const elapsed
+)
 {
     AD5940Err error = AD5940ERR_OK;
 
+    *elapsed = 0;
+
     error = AD5940_clear_sequence_generator_buffer();
     if(error) return error;
 
     /* Use hardware reset */
-    AD5940_HWReset();
-    // AD5940_SoftRst();
-    
-    AD5940_Delay10us(1E4);
+    _hardware_reset();
 
-    /* Platform configuration */
-    AD5940_Initialize();
+    error = _wait_ready(timeout, elapsed);
+    if(error) return error;
 
-    /* Enable AFE to enter sleep mode. */
-    AD5940_SleepKeyCtrlS(SLPKEY_UNLOCK);
+    _configure_after_reset();
 
-    /* Goto hibernate */
-    AD5940_EnterSleepS();
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_MAIN_reset_begin(
+    AD5940_MAIN_RESET_CONTEXT *const context,
+    AD5940_DEVICE *const device,
+    const uint32_t poll_period,
+    const uint32_t timeout
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    if(poll_period == 0) return AD5940ERR_PARA;
+
+    context->device = device;
+    context->poll_period = poll_period;
+    context->timeout = timeout;
+    context->phase = AD5940_MAIN_RESET_PHASE_IDLE;
+    context->elapsed = 0;
+
+    if(device != NULL)
+    {
+        error = AD5940_DEVICE_select(device);
+        if(error) return error;
+    }
+
+    error = AD5940_clear_sequence_generator_buffer();
+    if(error) return error;
+
+    /* The reset clears the AFE configuration and the SRAM */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate();
+
+    AD5940_RstClr();
+    context->phase = AD5940_MAIN_RESET_PHASE_HOLD;
 
     return AD5940ERR_OK;
 }
+
+AD5940Err AD5940_MAIN_reset_poll(
+    AD5940_MAIN_RESET_CONTEXT *const context,
+    BoolFlag *const done
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    *done = bFALSE;
+
+    if(context->phase == AD5940_MAIN_RESET_PHASE_IDLE) return AD5940ERR_PARA;
+
+    if(context->device != NULL)
+    {
+        error = AD5940_DEVICE_select(context->device);
+        if(error) return error;
+    }
+
+    /* At least one poll period passed since the previous call */
+    context->elapsed += context->poll_period;
+
+    switch (context->phase)
+    {
+    case AD5940_MAIN_RESET_PHASE_HOLD:
+        if(context->elapsed < RESET_PULSE) return AD5940ERR_OK;
+        AD5940_RstSet();
+        context->phase = AD5940_MAIN_RESET_PHASE_WAIT;
+        context->elapsed = 0;
+        return AD5940ERR_OK;
+
+    case AD5940_MAIN_RESET_PHASE_WAIT:
+        if(_is_ready() == bFALSE)
+        {
+            if(context->elapsed < context->timeout) return AD5940ERR_OK;
+            context->phase = AD5940_MAIN_RESET_PHASE_IDLE;
+            return AD5940ERR_TIMEOUT;
+        }
+        _configure_after_reset();
+        context->phase = AD5940_MAIN_RESET_PHASE_IDLE;
+        *done = bTRUE;
+        return AD5940ERR_OK;
+
+    default:
+        break;
+    }
+    return AD5940ERR_PARA;
+}
+
+AD5940Err AD5940_MAIN_init_device(
+    AD5940_DEVICE *const device,
+    const uint8_t reset_option
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_DEVICE_select(device);
+    if(error) return error;
+
+    return AD5940_MAIN_init(
+        device->sequence_generator_buffer,
+        device->sequence_generator_buffer_length,
+        reset_option
+    );
+}
+
+AD5940Err AD5940_MAIN_reset_device(
+    AD5940_DEVICE *const device
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    error = AD5940_DEVICE_select(device);
+    if(error) return error;
+
+    return AD5940_MAIN_reset();
+}
@@ -6,6 +6,12 @@ extern "C"
 #endif
 
 #include "ad5940.h"
+#include "ad5940_device.h"
+
+/**
+ * @brief Longest wait for the AD5940 to answer after a reset (in 10us), the fixed delay used before polling.
+ */
+#define AD5940_MAIN_RESET_TIMEOUT 10000
 
 /**
  * @brief
@@ -27,6 +33,8 @@ extern "C"
  *                     - 0: Do not reset
  *                     - 1: Perform a hardware reset
  *                     - 2: Perform a software reset
+ *                     After a reset, the identifiers and the power mode are polled until the AD5940 is awake,
+ *                     at most @ref AD5940_MAIN_RESET_TIMEOUT.
  * 
  * @attention
  * @ref AD5940_set_sequence_generator_buffer() in the 
@@ -50,11 +58,129 @@ AD5940Err AD5940_MAIN_init(
  * all settings are restored to their default states. Use this function to 
  * reinitialize the device if needed.
  * 
+ * Same as @ref AD5940_MAIN_reset_with_timeout with @ref AD5940_MAIN_RESET_TIMEOUT.
+ * 
  * @return AD5940Err Returns an error code indicating the success or failure of 
  * the reset process.
  */
 AD5940Err AD5940_MAIN_reset(void);
 
+/**
+ * @brief
+ * Resets the AD5940 and waits until it answers, instead of a fixed delay.
+ * 
+ * After the hardware reset, the ADIID, CHIPID and PWRMOD registers are polled every 10us until
+ * the AD5940 answers with its identifiers and is awake, then the device is configured and sent to
+ * hibernate as in @ref AD5940_MAIN_reset.
+ * 
+ * @param timeout Longest wait for the AD5940 to answer (in 10us).
+ * @param elapsed Pointer to store the time spent waiting (in 10us), SPI transfers not included.
+ * 
+ * @return AD5940Err Returns an error code indicating the success or failure of 
+ * the reset process. AD5940ERR_TIMEOUT if the AD5940 did not answer in time.
+ */
+AD5940Err AD5940_MAIN_reset_with_timeout(
+    const uint32_t timeout,
+    uint32_t *const elapsed
+);
+
+/**
+ * @brief Phases of a non-blocking reset, see @ref AD5940_MAIN_reset_poll.
+ */
+typedef enum
+{
+    AD5940_MAIN_RESET_PHASE_IDLE = 0,       /**< No reset in progress. */
+    AD5940_MAIN_RESET_PHASE_HOLD,           /**< The reset pin is held low. */
+    AD5940_MAIN_RESET_PHASE_WAIT,           /**< The reset pin is released, waiting for the AD5940 to answer. */
+}
+AD5940_MAIN_RESET_PHASE;
+
+/**
+ * @brief State of a non-blocking reset, owned by the caller, one per device being reset.
+ */
+typedef struct
+{
+    AD5940_DEVICE *device;                  /**< Device selected by every poll, or NULL to keep the selection. */
+    uint32_t poll_period;                   /**< Least time between two polls (in 10us), guaranteed by the caller. */
+    uint32_t timeout;                       /**< Longest wait for the AD5940 to answer once released (in 10us). */
+    AD5940_MAIN_RESET_PHASE phase;          /**< Current phase. */
+    uint32_t elapsed;                       /**< Time spent in the current phase, counted in poll periods (in 10us). */
+}
+AD5940_MAIN_RESET_CONTEXT;
+
+/**
+ * @brief
+ * Starts a non-blocking hardware reset of the AD5940.
+ * 
+ * Pulls the reset pin low and returns at once. Call @ref AD5940_MAIN_reset_poll
+ * every `poll_period` until it reports done. The pin is held low for 2ms as in
+ * @ref AD5940_MAIN_reset, whatever the poll period.
+ * 
+ * @param context       Reset context, it must stay valid until the reset is done.
+ * @param device        Device to reset, or NULL for the selected device (single AD5940).
+ * @param poll_period   Least time between two calls of @ref AD5940_MAIN_reset_poll (in 10us), not zero.
+ * @param timeout       Longest wait for the AD5940 to answer once released (in 10us),
+ *                      e.g. @ref AD5940_MAIN_RESET_TIMEOUT.
+ * 
+ * @return AD5940Err Returns an error code indicating the success or failure of 
+ * the reset process.
+ */
+AD5940Err AD5940_MAIN_reset_begin(
+    AD5940_MAIN_RESET_CONTEXT *const context,
+    AD5940_DEVICE *const device,
+    const uint32_t poll_period,
+    const uint32_t timeout
+);
+
+/**
+ * @brief
+ * Advances a reset started by @ref AD5940_MAIN_reset_begin.
+ * 
+ * Each call counts one poll period. Once the reset pin was held low for 2ms, it is released;
+ * the following calls read the ADIID, CHIPID and PWRMOD registers, and once the AD5940 answers,
+ * the device is configured and sent to hibernate as in @ref AD5940_MAIN_reset.
+ * Every call takes bounded time instead of the 100ms delay.
+ * 
+ * @param context   Reset context prepared by @ref AD5940_MAIN_reset_begin.
+ * @param done      Pointer to store bTRUE once the device is ready.
+ * 
+ * @return AD5940Err Returns an error code indicating the success or failure of 
+ * the reset process. AD5940ERR_PARA if no reset was started, AD5940ERR_TIMEOUT if the
+ * AD5940 did not answer within the timeout, the reset is then over.
+ */
+AD5940Err AD5940_MAIN_reset_poll(
+    AD5940_MAIN_RESET_CONTEXT *const context,
+    BoolFlag *const done
+);
+
+/**
+ * @brief
+ * Selects a device and initializes it with its own sequence generator buffer.
+ * 
+ * @param device       Device context, see @ref AD5940_DEVICE_init.
+ * @param reset_option See @ref AD5940_MAIN_init.
+ * 
+ * @return AD5940Err Returns an error code indicating the success or failure of 
+ * the initialization process.
+ */
+AD5940Err AD5940_MAIN_init_device(
+    AD5940_DEVICE *const device,
+    const uint8_t reset_option
+);
+
+/**
+ * @brief
+ * Selects a device and resets it, see @ref AD5940_MAIN_reset.
+ * 
+ * @param device       Device context, see @ref AD5940_DEVICE_init.
+ * 
+ * @return AD5940Err Returns an error code indicating the success or failure of 
+ * the reset process.
+ */
+AD5940Err AD5940_MAIN_reset_device(
+    AD5940_DEVICE *const device
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+
+/**
+ * @brief Platform functions of one AD5940, the per-device counterpart of the port
+ *        functions required by `ad5940.c` (AD5940_CsClr, AD5940_ReadWriteNBytes, ...).
+ *
+ * Each AD5940 on its own SPI bus, chip select, reset and interrupt line gets its own set.
+ */
+typedef struct
+{
+    void (*cs_clr)(void);                   /**< Pulls the chip select low. */
+    void (*cs_set)(void);                   /**< Pulls the chip select high. */
+    void (*rst_clr)(void);                  /**< Pulls the reset pin low. */
+    void (*rst_set)(void);                  /**< Pulls the reset pin high. */
+    void (*delay_10us)(uint32_t time);      /**< Waits `time` * 10us. */
+    void (*read_write_n_bytes)(
+        unsigned char *pSendBuffer,
+        unsigned char *pRecvBuff,
+        unsigned long length
+    );                                      /**< Full duplex SPI transfer. */
+    uint32_t (*get_mcu_int_flag)(void);     /**< Returns the interrupt flag set by the GPIO interrupt of this device. */
+    uint32_t (*clr_mcu_int_flag)(void);     /**< Clears the interrupt flag of this device. */
+}
+AD5940_PORT_OPS;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,338 @@
+#include "ad5940_shadow.h"
+
+#include <string.h>
+
+/**
+ * AFE configuration registers written by REFCfgS, LPLoopCfgS, HSLoopCfgS, DSPCfgS and the applications.
+ * The hardware never changes them while the sequencer is disabled.
+ */
+static const uint16_t _shadow_registers[AD5940_SHADOW_REGISTER_NUMBER] = {
+    REG_AFE_AFECON,
+    REG_AFE_SWCON,
+    REG_AFE_HSDACCON,
+    REG_AFE_WGCON,
+    REG_AFE_HSDACDAT,
+    REG_AFE_LPDACDAT0,
+    REG_AFE_LPDACSW0,
+    REG_AFE_LPDACCON0,
+    REG_AFE_LPTIASW0,
+    REG_AFE_LPTIACON0,
+    REG_AFE_HSRTIACON,
+    REG_AFE_DE0RESCON,
+    REG_AFE_HSTIACON,
+    REG_AFE_LPREFBUFCON,
+    REG_AFE_BUFSENCON,
+    REG_AFE_ADCCON,
+    REG_AFE_ADCFILTERCON,
+    REG_AFE_DFTCON,
+    REG_AFE_STATSCON,
+    REG_AFE_DSWFULLCON,
+    REG_AFE_NSWFULLCON,
+    REG_AFE_PSWFULLCON,
+    REG_AFE_TSWFULLCON,
+    REG_AFE_TEMPSENS,
+    REG_AFE_DATAFIFOTHRES,
+    REG_AFE_SEQ0INFO,
+    REG_AFE_SEQ1INFO,
+    REG_AFE_SEQ2INFO,
+    REG_AFE_SEQ3INFO,
+};
+
+typedef enum
+{
+    _FRAME_MODE_IDLE = 0,       // Chip select is low for ad5940.c, nothing received yet.
+    _FRAME_MODE_ADDRESS,        // Set address transaction, buffered.
+    _FRAME_MODE_WRITE,          // Write register transaction, buffered until chip select goes high.
+    _FRAME_MODE_LOCAL_READ,     // Read register transaction answered from the shadow.
+    _FRAME_MODE_READ,           // Read register transaction sent to the AD5940, the data is captured.
+    _FRAME_MODE_PASS,           // Any other transaction, sent to the AD5940 unchanged.
+}
+_FRAME_MODE;
+
+static int8_t _get_index(
+    const uint16_t address
+)
+{
+    for(uint8_t i=0; i<AD5940_SHADOW_REGISTER_NUMBER; i++)
+    {
+        if(_shadow_registers[i] == address) return (int8_t) i;
+    }
+    return -1;
+}
+
+static BoolFlag _is_valid(
+    const AD5940_SHADOW *const shadow,
+    const int8_t index
+)
+{
+    if(index < 0) return bFALSE;
+    if(shadow->sequencer_enabled == bTRUE) return bFALSE;
+    return (shadow->valid_mask & (1UL << index)) ? bTRUE : bFALSE;
+}
+
+static void _update(
+    AD5940_SHADOW *const shadow,
+    const int8_t index,
+    const uint32_t value
+)
+{
+    if(index < 0) return;
+    if(shadow->sequencer_enabled == bTRUE)
+    {
+        shadow->valid_mask &= ~(1UL << index);
+        return;
+    }
+    shadow->value[index] = value;
+    shadow->valid_mask |= (1UL << index);
+}
+
+static uint32_t _get_data(
+    const uint8_t *const data,
+    const uint8_t length
+)
+{
+    uint32_t value = 0;
+    for(uint8_t i=0; i<length; i++)
+    {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+static void _send_frame(
+    const AD5940_PORT_OPS *const port,
+    uint8_t *const frame,
+    const uint8_t length
+)
+{
+    uint8_t recv[AD5940_SHADOW_FRAME_SIZE];
+    port->cs_clr();
+    port->read_write_n_bytes(frame, recv, length);
+    port->cs_set();
+}
+
+static void _flush_address(
+    AD5940_SHADOW *const shadow,
+    const AD5940_PORT_OPS *const port
+)
+{
+    if(shadow->address_pending == bFALSE) return;
+    _send_frame(port, shadow->address_frame, sizeof(shadow->address_frame));
+    shadow->address_pending = bFALSE;
+}
+
+/**
+ * Tracks the registers whose writes change what the shadow may trust.
+ */
+static void _track_write(
+    AD5940_SHADOW *const shadow,
+    const uint16_t address,
+    const uint32_t value
+)
+{
+    if(address == REG_AFE_SEQCON)
+    {
+        BoolFlag enabled = (value & BITM_AFE_SEQCON_SEQEN) ? bTRUE : bFALSE;
+        if((enabled == bTRUE) && (shadow->sequencer_enabled == bFALSE))
+        {
+            AD5940_SHADOW_invalidate(shadow);
+        }
+        shadow->sequencer_enabled = enabled;
+        return;
+    }
+    if(address == REG_ALLON_SWRSTCON)
+    {
+        AD5940_SHADOW_invalidate(shadow);
+        shadow->sequencer_enabled = bFALSE;
+        return;
+    }
+    _update(shadow, _get_index(address), value);
+}
+
+AD5940Err AD5940_SHADOW_init(
+    AD5940_SHADOW *const shadow
+)
+{
+    if(shadow == NULL) return AD5940ERR_PARA;
+
+    memset(shadow, 0, sizeof(AD5940_SHADOW));
+    shadow->sequencer_enabled = bFALSE;
+    shadow->frame_mode = _FRAME_MODE_IDLE;
+    shadow->address_pending = bFALSE;
+    shadow->address_valid = bFALSE;
+
+    return AD5940ERR_OK;
+}
+
+void AD5940_SHADOW_invalidate(
+    AD5940_SHADOW *const shadow
+)
+{
+    shadow->valid_mask = 0;
+}
+
+void AD5940_SHADOW_cs_clr(
+    AD5940_SHADOW *const shadow,
+    const AD5940_PORT_OPS *const port
+)
+{
+    (void) port;    // The chip select is only pulled once the transaction needs the AD5940.
+    shadow->frame_length = 0;
+    shadow->frame_mode = _FRAME_MODE_IDLE;
+}
+
+void AD5940_SHADOW_read_write_n_bytes(
+    AD5940_SHADOW *const shadow,
+    const AD5940_PORT_OPS *const port,
+    unsigned char *pSendBuffer,
+    unsigned char *pRecvBuff,
+    unsigned long length
+)
+{
+    uint8_t position = shadow->frame_length;
+    unsigned long first;
+    int8_t index;
+
+    if(shadow->frame_mode == _FRAME_MODE_IDLE)
+    {
+        switch (pSendBuffer[0])
+        {
+        case SPICMD_SETADDR:
+            shadow->frame_mode = _FRAME_MODE_ADDRESS;
+            break;
+
+        case SPICMD_WRITEREG:
+            shadow->frame_mode = _FRAME_MODE_WRITE;
+            break;
+
+        case SPICMD_READREG:
+            index = _get_index(shadow->address);
+            if((shadow->address_valid == bTRUE) && (_is_valid(shadow, index) == bTRUE))
+            {
+                shadow->frame_mode = _FRAME_MODE_LOCAL_READ;
+                shadow->read_hit_count++;
+                break;
+            }
+            _flush_address(shadow, port);
+            port->cs_clr();
+            shadow->frame_mode = _FRAME_MODE_READ;
+            break;
+
+        default:
+            _flush_address(shadow, port);
+            port->cs_clr();
+            shadow->frame_mode = _FRAME_MODE_PASS;
+            break;
+        }
+    }
+
+    switch (shadow->frame_mode)
+    {
+    case _FRAME_MODE_ADDRESS:
+    case _FRAME_MODE_WRITE:
+        if((position + length) > AD5940_SHADOW_FRAME_SIZE)
+        {
+            // Not a register transaction of ad5940.c, give up buffering.
+            _flush_address(shadow, port);
+            port->cs_clr();
+            port->read_write_n_bytes(shadow->frame, shadow->frame, position);
+            port->read_write_n_bytes(pSendBuffer, pRecvBuff, length);
+            shadow->frame_mode = _FRAME_MODE_PASS;
+            break;
+        }
+        memcpy(shadow->frame + position, pSendBuffer, length);
+        memset(pRecvBuff, 0, length);
+        break;
+
+    case _FRAME_MODE_LOCAL_READ:
+        // Command byte and dummy byte, then the register data MSB first.
+        first = (position >= 2) ? 0 : (2 - position);
+        if(first > length) first = length;
+        memset(pRecvBuff, 0, first);
+        index = _get_index(shadow->address);
+        for(unsigned long j=first; j<length; j++)
+        {
+            pRecvBuff[j] = (uint8_t)(shadow->value[index] >> (8 * (length - 1 - j)));
+        }
+        break;
+
+    case _FRAME_MODE_READ:
+        port->read_write_n_bytes(pSendBuffer, pRecvBuff, length);
+        first = (position >= 2) ? 0 : (2 - position);
+        if((first < length) && ((length - first) <= 4))
+        {
+            _update(shadow, _get_index(shadow->address), _get_data(pRecvBuff + first, (uint8_t)(length - first)));
+        }
+        break;
+
+    default:
+        port->read_write_n_bytes(pSendBuffer, pRecvBuff, length);
+        break;
+    }
+
+    shadow->frame_length = position + (uint8_t) length;
+}
+
+void AD5940_SHADOW_cs_set(
+    AD5940_SHADOW *const shadow,
+    const AD5940_PORT_OPS *const port
+)
+{
+    uint32_t value;
+    int8_t index;
+
+    switch (shadow->frame_mode)
+    {
+    case _FRAME_MODE_ADDRESS:
+        if(shadow->frame_length != sizeof(shadow->address_frame))
+        {
+            _flush_address(shadow, port);
+            _send_frame(port, shadow->frame, shadow->frame_length);
+            shadow->address_valid = bFALSE;
+            break;
+        }
+        // Keep the address until the next transaction tells whether the AD5940 needs it.
+        // An older pending address is overridden, the AD5940 never needed it.
+        memcpy(shadow->address_frame, shadow->frame, sizeof(shadow->address_frame));
+        shadow->address_pending = bTRUE;
+        shadow->address = (uint16_t) _get_data(shadow->frame + 1, 2);
+        shadow->address_valid = bTRUE;
+        break;
+
+    case _FRAME_MODE_WRITE:
+        if((shadow->address_valid == bFALSE) || (shadow->frame_length < 3) || (shadow->frame_length > 5))
+        {
+            _flush_address(shadow, port);
+            _send_frame(port, shadow->frame, shadow->frame_length);
+            break;
+        }
+        value = _get_data(shadow->frame + 1, shadow->frame_length - 1);
+        index = _get_index(shadow->address);
+        if((_is_valid(shadow, index) == bTRUE) && (shadow->value[index] == value))
+        {
+            // The AD5940 already holds this value, drop the address and the write.
+            shadow->address_pending = bFALSE;
+            shadow->write_skip_count++;
+            break;
+        }
+        _flush_address(shadow, port);
+        _send_frame(port, shadow->frame, shadow->frame_length);
+        _track_write(shadow, shadow->address, value);
+        break;
+
+    case _FRAME_MODE_LOCAL_READ:
+        shadow->address_pending = bFALSE;
+        break;
+
+    case _FRAME_MODE_READ:
+    case _FRAME_MODE_PASS:
+        port->cs_set();
+        break;
+
+    default:
+        break;
+    }
+
+    shadow->frame_mode = _FRAME_MODE_IDLE;
+    shadow->frame_length = 0;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_port.h"
+
+/**
+ * @brief Number of AFE configuration registers kept by the shadow.
+ */
+#define AD5940_SHADOW_REGISTER_NUMBER 29
+
+/**
+ * @brief Size of the buffer holding one SPI transaction.
+ *
+ * The longest transaction of `ad5940.c` on a register is a command byte, a dummy byte and 4 data bytes.
+ */
+#define AD5940_SHADOW_FRAME_SIZE 8
+
+/**
+ * @brief Write-through shadow of the AFE configuration registers of one AD5940.
+ *
+ * The shadow sits between `ad5940.c` and the SPI port, see @ref AD5940_DEVICE. It parses the
+ * register transactions of `ad5940.c` (set address, write register, read register):
+ * - A write of the value the register already holds is dropped, address transaction included.
+ * - A read of a known register is answered locally without any SPI transfer.
+ * - Any other transaction goes to the AD5940 unchanged.
+ *
+ * Only configuration registers that the hardware never changes on its own are shadowed,
+ * status, data and key registers always go to the AD5940.
+ * While the sequencer is enabled (SEQCON.SEQEN), sequences may rewrite any register, so the shadow
+ * is invalidated when the sequencer is enabled and passes everything through until it is disabled.
+ * A reset invalidates the shadow as well.
+ */
+typedef struct
+{
+    uint32_t value[AD5940_SHADOW_REGISTER_NUMBER];  /**< Last known value of the shadowed registers. */
+    uint32_t valid_mask;                            /**< Bit i set when value[i] matches the AD5940. */
+    BoolFlag sequencer_enabled;                     /**< Last value written to SEQCON.SEQEN. */
+
+    uint8_t frame[AD5940_SHADOW_FRAME_SIZE];        /**< Transaction being parsed. */
+    uint8_t frame_length;                           /**< Number of bytes of the transaction so far. */
+    uint8_t frame_mode;                             /**< How the transaction is handled. */
+    uint8_t address_frame[3];                       /**< Set address transaction not sent yet. */
+    BoolFlag address_pending;                       /**< bTRUE while address_frame is not sent. */
+    BoolFlag address_valid;                         /**< bTRUE when address holds the last set address. */
+    uint16_t address;                               /**< Last register address set by `ad5940.c`. */
+
+    uint32_t write_skip_count;                      /**< Number of register writes dropped. */
+    uint32_t read_hit_count;                        /**< Number of register reads answered locally. */
+}
+AD5940_SHADOW;
+
+/**
+ * @brief Initializes an empty shadow.
+ *
+ * @param shadow    Shadow to initialize.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_SHADOW_init(
+    AD5940_SHADOW *const shadow
+);
+
+/**
+ * @brief Marks every shadowed register dirty, the next access of each goes to the AD5940.
+ *
+ * Call it when the registers may have changed behind the shadow, e.g. after a reset
+ * or when an other master accessed the AD5940.
+ *
+ * @param shadow    Shadow to invalidate.
+ */
+void AD5940_SHADOW_invalidate(
+    AD5940_SHADOW *const shadow
+);
+
+/**
+ * @brief Port hooks of the shadow, called in place of the chip select and SPI port functions.
+ */
+void AD5940_SHADOW_cs_clr(
+    AD5940_SHADOW *const shadow,
+    const AD5940_PORT_OPS *const port
+);
+
+void AD5940_SHADOW_cs_set(
+    AD5940_SHADOW *const shadow,
+    const AD5940_PORT_OPS *const port
+);
+
+void AD5940_SHADOW_read_write_n_bytes(
+    AD5940_SHADOW *const shadow,
+    const AD5940_PORT_OPS *const port,
+    unsigned char *pSendBuffer,
+    unsigned char *pRecvBuff,
+    unsigned long length
+);
+
+#ifdef __cplusplus
+}
+#endif
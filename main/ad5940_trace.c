@@ -0,0 +1,680 @@
+#include "ad5940_trace.h"
+
+#include <string.h>
+
+#define FIFO_PREFIX_LENGTH 7        // Command byte and 6 dummy bytes before the FIFO data.
+#define VARINT_LENGTH_MAX 5         // Unsigned LEB128 of a 32 bits value.
+
+static const uint8_t _header[AD5940_TRACE_HEADER_SIZE] = {'A', 'D', '5', 'T', AD5940_TRACE_VERSION};
+
+static uint32_t _get_data(
+    const uint8_t *const data,
+    const uint8_t length
+)
+{
+    uint32_t value = 0;
+    for(uint8_t i=0; i<length; i++)
+    {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+static uint8_t _get_varint_length(
+    uint32_t value
+)
+{
+    uint8_t length = 1;
+    while(value >= 0x80)
+    {
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+static void _put_le(
+    AD5940_TRACE *const trace,
+    const uint32_t value,
+    const uint8_t length
+)
+{
+    for(uint8_t i=0; i<length; i++)
+    {
+        trace->buffer[trace->length++] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/**
+ * Writes the type and the elapsed time of a record, if the whole record fits.
+ */
+static BoolFlag _begin_record(
+    AD5940_TRACE *const trace,
+    const AD5940_TRACE_RECORD type,
+    const uint32_t payload_length
+)
+{
+    uint32_t now = (trace->get_time != NULL) ? trace->get_time() : trace->time;
+    uint32_t elapsed = now - trace->time;
+
+    if((trace->length + 1 + _get_varint_length(elapsed) + payload_length) > trace->buffer_length)
+    {
+        trace->dropped_count++;
+        return bFALSE;
+    }
+
+    trace->buffer[trace->length++] = (uint8_t) type;
+    while(elapsed >= 0x80)
+    {
+        trace->buffer[trace->length++] = (uint8_t)(elapsed | 0x80);
+        elapsed >>= 7;
+    }
+    trace->buffer[trace->length++] = (uint8_t) elapsed;
+    trace->time = now;
+
+    return bTRUE;
+}
+
+static void _record_register(
+    AD5940_TRACE *const trace,
+    const AD5940_TRACE_RECORD type,
+    const uint32_t value,
+    const uint8_t value_length
+)
+{
+    if(_begin_record(trace, type, 2 + value_length) == bFALSE) return;
+    _put_le(trace, trace->address, 2);
+    _put_le(trace, value, value_length);
+}
+
+static void _record_raw(
+    AD5940_TRACE *const trace
+)
+{
+    uint8_t length = (trace->frame_length > AD5940_TRACE_FRAME_SIZE) ? AD5940_TRACE_FRAME_SIZE : trace->frame_length;
+    if(trace->frame_length > AD5940_TRACE_FRAME_SIZE)
+    {
+        // Only the beginning of an unknown long transaction is kept.
+        trace->dropped_count++;
+    }
+
+    if(_begin_record(trace, AD5940_TRACE_RECORD_RAW, 1 + 2 * length) == bFALSE) return;
+    trace->buffer[trace->length++] = length;
+    for(uint8_t i=0; i<length; i++)
+    {
+        trace->buffer[trace->length++] = trace->frame_send[i];
+        trace->buffer[trace->length++] = trace->frame_recv[i];
+    }
+}
+
+AD5940Err AD5940_TRACE_init(
+    AD5940_TRACE *const trace,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t (*get_time)(void)
+)
+{
+    if(trace == NULL) return AD5940ERR_PARA;
+    if(buffer == NULL) return AD5940ERR_PARA;
+    if(buffer_length < AD5940_TRACE_HEADER_SIZE) return AD5940ERR_BUFF;
+
+    memset(trace, 0, sizeof(AD5940_TRACE));
+    trace->buffer = buffer;
+    trace->buffer_length = buffer_length;
+    trace->get_time = get_time;
+    trace->time = (get_time != NULL) ? get_time() : 0;
+    trace->frame_fifo = bFALSE;
+
+    memcpy(trace->buffer, _header, AD5940_TRACE_HEADER_SIZE);
+    trace->length = AD5940_TRACE_HEADER_SIZE;
+
+    return AD5940ERR_OK;
+}
+
+void AD5940_TRACE_cs_clr(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+)
+{
+    trace->frame_length = 0;
+    trace->frame_fifo = bFALSE;
+    port->cs_clr();
+}
+
+void AD5940_TRACE_read_write_n_bytes(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port,
+    unsigned char *pSendBuffer,
+    unsigned char *pRecvBuff,
+    unsigned long length
+)
+{
+    port->read_write_n_bytes(pSendBuffer, pRecvBuff, length);
+    trace->byte_count += length;
+
+    if((trace->frame_length == 0) && (trace->frame_fifo == bFALSE) && (length > 0) && (pSendBuffer[0] == SPICMD_READFIFO))
+    {
+        // The length is filled in when the chip select goes high, 0 marks a dropped record.
+        trace->frame_fifo = bTRUE;
+        trace->fifo_length = 0;
+        trace->fifo_record = trace->length;
+        if(_begin_record(trace, AD5940_TRACE_RECORD_READ_FIFO, 2) == bTRUE)
+        {
+            _put_le(trace, 0, 2);
+        }
+        else
+        {
+            trace->fifo_record = 0;
+        }
+    }
+
+    for(unsigned long i=0; i<length; i++)
+    {
+        if(trace->frame_fifo == bTRUE)
+        {
+            if(trace->frame_length < FIFO_PREFIX_LENGTH)
+            {
+                trace->frame_length++;
+                continue;
+            }
+            if(trace->fifo_record == 0) continue;
+            if(trace->length >= trace->buffer_length)
+            {
+                // Drop the whole FIFO read rather than keep a truncated one.
+                trace->length = trace->fifo_record;
+                trace->fifo_record = 0;
+                trace->dropped_count++;
+                continue;
+            }
+            trace->buffer[trace->length++] = pRecvBuff[i];
+            trace->fifo_length++;
+            continue;
+        }
+
+        if(trace->frame_length < AD5940_TRACE_FRAME_SIZE)
+        {
+            trace->frame_send[trace->frame_length] = pSendBuffer[i];
+            trace->frame_recv[trace->frame_length] = pRecvBuff[i];
+        }
+        if(trace->frame_length < 0xFF) trace->frame_length++;
+    }
+}
+
+void AD5940_TRACE_cs_set(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+)
+{
+    port->cs_set();
+    trace->transaction_count++;
+
+    if(trace->frame_fifo == bTRUE)
+    {
+        if(trace->fifo_record != 0)
+        {
+            // Skip the type and the elapsed time to reach the length.
+            uint32_t position = trace->fifo_record + 1;
+            while(trace->buffer[position] & 0x80) position++;
+            position++;
+            trace->buffer[position] = (uint8_t)(trace->fifo_length);
+            trace->buffer[position + 1] = (uint8_t)(trace->fifo_length >> 8);
+        }
+        trace->frame_fifo = bFALSE;
+        trace->frame_length = 0;
+        return;
+    }
+
+    switch (trace->frame_length)
+    {
+    case 0:
+        break;
+
+    case 3:
+        if(trace->frame_send[0] == SPICMD_SETADDR)
+        {
+            trace->address = (uint16_t) _get_data(trace->frame_send + 1, 2);
+            break;
+        }
+        if(trace->frame_send[0] == SPICMD_WRITEREG)
+        {
+            _record_register(trace, AD5940_TRACE_RECORD_WRITE_REG16, _get_data(trace->frame_send + 1, 2), 2);
+            break;
+        }
+        _record_raw(trace);
+        break;
+
+    case 4:
+        if(trace->frame_send[0] == SPICMD_READREG)
+        {
+            _record_register(trace, AD5940_TRACE_RECORD_READ_REG16, _get_data(trace->frame_recv + 2, 2), 2);
+            break;
+        }
+        _record_raw(trace);
+        break;
+
+    case 5:
+        if(trace->frame_send[0] == SPICMD_WRITEREG)
+        {
+            _record_register(trace, AD5940_TRACE_RECORD_WRITE_REG32, _get_data(trace->frame_send + 1, 4), 4);
+            break;
+        }
+        _record_raw(trace);
+        break;
+
+    case 6:
+        if(trace->frame_send[0] == SPICMD_READREG)
+        {
+            _record_register(trace, AD5940_TRACE_RECORD_READ_REG32, _get_data(trace->frame_recv + 2, 4), 4);
+            break;
+        }
+        _record_raw(trace);
+        break;
+
+    default:
+        _record_raw(trace);
+        break;
+    }
+
+    trace->frame_length = 0;
+}
+
+void AD5940_TRACE_rst_clr(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+)
+{
+    _begin_record(trace, AD5940_TRACE_RECORD_RESET, 0);
+    port->rst_clr();
+}
+
+void AD5940_TRACE_rst_set(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+)
+{
+    _begin_record(trace, AD5940_TRACE_RECORD_RESET_RELEASE, 0);
+    port->rst_set();
+}
+
+void AD5940_TRACE_delay_10us(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port,
+    const uint32_t time
+)
+{
+    if(_begin_record(trace, AD5940_TRACE_RECORD_DELAY, 4) == bTRUE) _put_le(trace, time, 4);
+    port->delay_10us(time);
+}
+
+uint32_t AD5940_TRACE_get_mcu_int_flag(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+)
+{
+    uint32_t flag = port->get_mcu_int_flag();
+    // Polling without an interrupt is not recorded, it would fill the trace.
+    if(flag) _begin_record(trace, AD5940_TRACE_RECORD_INTERRUPT, 0);
+    return flag;
+}
+
+AD5940Err AD5940_TRACE_read_header(
+    const uint8_t *const trace,
+    const uint32_t length,
+    uint32_t *const offset
+)
+{
+    if(length < AD5940_TRACE_HEADER_SIZE) return AD5940ERR_PARA;
+    // The versions only add record types, the older traces are read as they are.
+    if(memcmp(trace, _header, AD5940_TRACE_HEADER_SIZE - 1) != 0) return AD5940ERR_PARA;
+    if((trace[AD5940_TRACE_HEADER_SIZE - 1] == 0) || (trace[AD5940_TRACE_HEADER_SIZE - 1] > AD5940_TRACE_VERSION)) return AD5940ERR_PARA;
+
+    *offset = AD5940_TRACE_HEADER_SIZE;
+
+    return AD5940ERR_OK;
+}
+
+static uint32_t _get_le(
+    const uint8_t *const data,
+    const uint8_t length
+)
+{
+    uint32_t value = 0;
+    for(uint8_t i=0; i<length; i++)
+    {
+        value |= ((uint32_t) data[i]) << (8 * i);
+    }
+    return value;
+}
+
+AD5940Err AD5940_TRACE_read_record(
+    const uint8_t *const trace,
+    const uint32_t length,
+    uint32_t *const offset,
+    AD5940_TRACE_RECORD_INFO *const record
+)
+{
+    uint32_t position = *offset;
+    uint32_t elapsed = 0;
+    uint8_t value_length;
+
+    if(position >= length) return AD5940ERR_BUFF;
+    record->type = (AD5940_TRACE_RECORD) trace[position++];
+
+    for(uint8_t i=0; ; i++)
+    {
+        if(i >= VARINT_LENGTH_MAX) return AD5940ERR_PARA;
+        if(position >= length) return AD5940ERR_BUFF;
+        elapsed |= ((uint32_t)(trace[position] & 0x7F)) << (7 * i);
+        if((trace[position++] & 0x80) == 0) break;
+    }
+
+    record->address = 0;
+    record->value = 0;
+    record->data = NULL;
+    record->data_length = 0;
+
+    switch (record->type)
+    {
+    case AD5940_TRACE_RECORD_WRITE_REG16:
+    case AD5940_TRACE_RECORD_READ_REG16:
+    case AD5940_TRACE_RECORD_WRITE_REG32:
+    case AD5940_TRACE_RECORD_READ_REG32:
+        value_length = ((record->type == AD5940_TRACE_RECORD_WRITE_REG16) || (record->type == AD5940_TRACE_RECORD_READ_REG16)) ? 2 : 4;
+        if((position + 2 + value_length) > length) return AD5940ERR_BUFF;
+        record->address = (uint16_t) _get_le(trace + position, 2);
+        record->value = _get_le(trace + position + 2, value_length);
+        position += 2 + value_length;
+        break;
+
+    case AD5940_TRACE_RECORD_READ_FIFO:
+        if((position + 2) > length) return AD5940ERR_BUFF;
+        record->data_length = (uint16_t) _get_le(trace + position, 2);
+        position += 2;
+        if((position + record->data_length) > length) return AD5940ERR_BUFF;
+        record->data = trace + position;
+        position += record->data_length;
+        break;
+
+    case AD5940_TRACE_RECORD_RAW:
+        if((position + 1) > length) return AD5940ERR_BUFF;
+        record->data_length = 2 * trace[position];
+        position += 1;
+        if((position + record->data_length) > length) return AD5940ERR_BUFF;
+        record->data = trace + position;
+        position += record->data_length;
+        break;
+
+    case AD5940_TRACE_RECORD_DELAY:
+        if((position + 4) > length) return AD5940ERR_BUFF;
+        record->value = _get_le(trace + position, 4);
+        position += 4;
+        break;
+
+    case AD5940_TRACE_RECORD_RESET:
+    case AD5940_TRACE_RECORD_INTERRUPT:
+    case AD5940_TRACE_RECORD_RESET_RELEASE:
+        break;
+
+    default:
+        return AD5940ERR_PARA;
+    }
+
+    record->time += elapsed;
+    *offset = position;
+
+    return AD5940ERR_OK;
+}
+
+/**
+ * Replay bound to the port functions, they have no context of their own.
+ */
+static AD5940_TRACE_REPLAY *_replay = NULL;
+
+static void _mismatch(
+    AD5940_TRACE_REPLAY *const replay
+)
+{
+    if(replay->mismatch_count == 0) replay->mismatch_offset = replay->record_offset;
+    replay->mismatch_count++;
+}
+
+/**
+ * Consumes the next record, it must be of one of the two types.
+ */
+static BoolFlag _next(
+    AD5940_TRACE_REPLAY *const replay,
+    const AD5940_TRACE_RECORD type_a,
+    const AD5940_TRACE_RECORD type_b
+)
+{
+    replay->record_offset = replay->offset;
+    if(AD5940_TRACE_read_record(replay->trace, replay->length, &replay->offset, &replay->record) != AD5940ERR_OK)
+    {
+        replay->record_valid = bFALSE;
+        _mismatch(replay);
+        return bFALSE;
+    }
+    replay->record_valid = bTRUE;
+    if((replay->record.type != type_a) && (replay->record.type != type_b))
+    {
+        _mismatch(replay);
+        return bFALSE;
+    }
+    return bTRUE;
+}
+
+static void _replay_cs_clr(void)
+{
+    _replay->frame_length = 0;
+    _replay->record_valid = bFALSE;
+}
+
+static void _replay_read_write_n_bytes(
+    unsigned char *pSendBuffer,
+    unsigned char *pRecvBuff,
+    unsigned long length
+)
+{
+    AD5940_TRACE_REPLAY *const replay = _replay;
+    uint8_t value_length;
+    uint32_t index;
+
+    for(unsigned long i=0; i<length; i++)
+    {
+        const uint32_t position = replay->frame_length;
+        pRecvBuff[i] = 0;
+
+        if(position < AD5940_TRACE_FRAME_SIZE) replay->frame_send[position] = pSendBuffer[i];
+
+        if(position == 0)
+        {
+            switch (pSendBuffer[i])
+            {
+            case SPICMD_READREG:
+                if(_next(replay, AD5940_TRACE_RECORD_READ_REG16, AD5940_TRACE_RECORD_READ_REG32) == bFALSE) break;
+                if(replay->record.address != replay->address) _mismatch(replay);
+                break;
+
+            case SPICMD_READFIFO:
+                _next(replay, AD5940_TRACE_RECORD_READ_FIFO, AD5940_TRACE_RECORD_READ_FIFO);
+                break;
+
+            case SPICMD_SETADDR:
+            case SPICMD_WRITEREG:
+                // Checked when the chip select goes high.
+                break;
+
+            default:
+                _next(replay, AD5940_TRACE_RECORD_RAW, AD5940_TRACE_RECORD_RAW);
+                break;
+            }
+        }
+
+        if(replay->record_valid == bTRUE)
+        {
+            switch (replay->record.type)
+            {
+            case AD5940_TRACE_RECORD_READ_REG16:
+            case AD5940_TRACE_RECORD_READ_REG32:
+                // Command byte and dummy byte, then the register data MSB first.
+                value_length = (replay->record.type == AD5940_TRACE_RECORD_READ_REG16) ? 2 : 4;
+                if((position >= 2) && (position < (uint32_t)(2 + value_length)))
+                {
+                    pRecvBuff[i] = (uint8_t)(replay->record.value >> (8 * (value_length - 1 - (position - 2))));
+                }
+                break;
+
+            case AD5940_TRACE_RECORD_READ_FIFO:
+                if(position >= FIFO_PREFIX_LENGTH)
+                {
+                    index = position - FIFO_PREFIX_LENGTH;
+                    if(index < replay->record.data_length) pRecvBuff[i] = replay->record.data[index];
+                }
+                break;
+
+            case AD5940_TRACE_RECORD_RAW:
+                if((2 * position + 1) < replay->record.data_length) pRecvBuff[i] = replay->record.data[2 * position + 1];
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        replay->frame_length++;
+    }
+}
+
+static void _replay_cs_set(void)
+{
+    AD5940_TRACE_REPLAY *const replay = _replay;
+    const uint32_t length = replay->frame_length;
+    uint32_t value;
+
+    if(length == 0) return;
+
+    switch (replay->frame_send[0])
+    {
+    case SPICMD_SETADDR:
+        if(length == 3) replay->address = (uint16_t) _get_data(replay->frame_send + 1, 2);
+        break;
+
+    case SPICMD_WRITEREG:
+        if(_next(replay, AD5940_TRACE_RECORD_WRITE_REG16, AD5940_TRACE_RECORD_WRITE_REG32) == bFALSE) break;
+        if(length != ((replay->record.type == AD5940_TRACE_RECORD_WRITE_REG16) ? 3UL : 5UL))
+        {
+            _mismatch(replay);
+            break;
+        }
+        value = _get_data(replay->frame_send + 1, (uint8_t)(length - 1));
+        if((replay->record.address != replay->address) || (replay->record.value != value)) _mismatch(replay);
+        break;
+
+    case SPICMD_READFIFO:
+        if(replay->record_valid == bFALSE) break;
+        if(replay->record.type != AD5940_TRACE_RECORD_READ_FIFO) break;
+        if((length - FIFO_PREFIX_LENGTH) != replay->record.data_length) _mismatch(replay);
+        break;
+
+    default:
+        break;
+    }
+
+    replay->record_valid = bFALSE;
+    replay->frame_length = 0;
+}
+
+static void _replay_rst_clr(void)
+{
+    _next(_replay, AD5940_TRACE_RECORD_RESET, AD5940_TRACE_RECORD_RESET);
+    _replay->record_valid = bFALSE;
+    _replay->reset_low = bTRUE;
+    _replay->reset_hold = 0;
+}
+
+static void _replay_rst_set(void)
+{
+    _next(_replay, AD5940_TRACE_RECORD_RESET_RELEASE, AD5940_TRACE_RECORD_RESET_RELEASE);
+    _replay->record_valid = bFALSE;
+    _replay->reset_low = bFALSE;
+}
+
+static void _replay_delay_10us(uint32_t time)
+{
+    // The time is only accounted, the replay does not wait.
+    if(_next(_replay, AD5940_TRACE_RECORD_DELAY, AD5940_TRACE_RECORD_DELAY) == bTRUE)
+    {
+        if(_replay->record.value != time) _mismatch(_replay);
+    }
+    _replay->record_valid = bFALSE;
+    if(_replay->reset_low == bTRUE) _replay->reset_hold += time;
+}
+
+static uint32_t _replay_get_mcu_int_flag(void)
+{
+    AD5940_TRACE_RECORD_INFO record;
+    if(AD5940_TRACE_REPLAY_peek(_replay, &record) != AD5940ERR_OK) return 0;
+    if(record.type != AD5940_TRACE_RECORD_INTERRUPT) return 0;
+    AD5940_TRACE_REPLAY_skip(_replay);
+    return 1;
+}
+
+static uint32_t _replay_clr_mcu_int_flag(void)
+{
+    return 1;
+}
+
+static const AD5940_PORT_OPS _replay_port = {
+    .cs_clr = _replay_cs_clr,
+    .cs_set = _replay_cs_set,
+    .rst_clr = _replay_rst_clr,
+    .rst_set = _replay_rst_set,
+    .delay_10us = _replay_delay_10us,
+    .read_write_n_bytes = _replay_read_write_n_bytes,
+    .get_mcu_int_flag = _replay_get_mcu_int_flag,
+    .clr_mcu_int_flag = _replay_clr_mcu_int_flag,
+};
+
+AD5940Err AD5940_TRACE_REPLAY_init(
+    AD5940_TRACE_REPLAY *const replay,
+    const uint8_t *const trace,
+    const uint32_t length,
+    const AD5940_PORT_OPS **const port
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    if(replay == NULL) return AD5940ERR_PARA;
+    if(trace == NULL) return AD5940ERR_PARA;
+
+    memset(replay, 0, sizeof(AD5940_TRACE_REPLAY));
+    replay->trace = trace;
+    replay->length = length;
+    replay->record_valid = bFALSE;
+
+    error = AD5940_TRACE_read_header(trace, length, &replay->offset);
+    if(error) return error;
+
+    _replay = replay;
+    *port = &_replay_port;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_TRACE_REPLAY_peek(
+    AD5940_TRACE_REPLAY *const replay,
+    AD5940_TRACE_RECORD_INFO *const record
+)
+{
+    uint32_t offset = replay->offset;
+    record->time = replay->record.time;
+    return AD5940_TRACE_read_record(replay->trace, replay->length, &offset, record);
+}
+
+AD5940Err AD5940_TRACE_REPLAY_skip(
+    AD5940_TRACE_REPLAY *const replay
+)
+{
+    replay->record_offset = replay->offset;
+    return AD5940_TRACE_read_record(replay->trace, replay->length, &replay->offset, &replay->record);
+}
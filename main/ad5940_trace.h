@@ -0,0 +1,272 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_port.h"
+
+/**
+ * @brief Version of the trace format, stored in the trace header.
+ *
+ * Version 2 adds the reset release and delay records, the traces of version 1 are still read.
+ */
+#define AD5940_TRACE_VERSION 2
+
+/**
+ * @brief Size of the trace header (in bytes): "AD5T" and the version.
+ */
+#define AD5940_TRACE_HEADER_SIZE 5
+
+/**
+ * @brief Size of the buffer holding one SPI transaction other than a FIFO read.
+ *
+ * The longest transaction of `ad5940.c` on a register is a command byte, a dummy byte and 4 data bytes.
+ */
+#define AD5940_TRACE_FRAME_SIZE 8
+
+/**
+ * @brief Record types of a trace.
+ *
+ * Every record starts with its type and the time elapsed since the previous record
+ * (in the unit of @ref AD5940_TRACE.get_time, unsigned LEB128). Multi-byte fields are little endian.
+ * The set address transactions are not recorded on their own, their address is part of the
+ * register records that follow them.
+ */
+typedef enum
+{
+    AD5940_TRACE_RECORD_WRITE_REG16 = 1,    /**< Address (2 bytes), value (2 bytes). */
+    AD5940_TRACE_RECORD_WRITE_REG32,        /**< Address (2 bytes), value (4 bytes). */
+    AD5940_TRACE_RECORD_READ_REG16,         /**< Address (2 bytes), value read (2 bytes). */
+    AD5940_TRACE_RECORD_READ_REG32,         /**< Address (2 bytes), value read (4 bytes). */
+    AD5940_TRACE_RECORD_READ_FIFO,          /**< Length (2 bytes), bytes read after the command and the 6 dummy bytes. */
+    AD5940_TRACE_RECORD_RAW,                /**< Length (1 byte), then each byte sent followed by the byte received. */
+    AD5940_TRACE_RECORD_RESET,              /**< Reset pin pulled low, no payload. */
+    AD5940_TRACE_RECORD_INTERRUPT,          /**< Interrupt flag of the MCU found set, no payload. */
+    AD5940_TRACE_RECORD_RESET_RELEASE,      /**< Reset pin released high, no payload. */
+    AD5940_TRACE_RECORD_DELAY,              /**< Delay requested by `ad5940.c` or the library, time (4 bytes, in 10us). */
+}
+AD5940_TRACE_RECORD;
+
+/**
+ * @brief Recorder of the SPI transactions of one AD5940.
+ *
+ * The recorder sits at the bottom of the port layer, see @ref AD5940_DEVICE_enable_trace,
+ * so it records what is sent over SPI after the register shadow. Register accesses are
+ * recorded with their address and value, FIFO reads with their data, and any other
+ * transaction byte by byte. The reset pin and the delays are recorded as well, so the
+ * timing of a reset is part of the trace. The records are appended to a caller buffer; once the buffer
+ * is full, the following records are dropped and counted.
+ *
+ * The SPI traffic of a step, e.g. one `*_start` or one @ref AD5940_irq_handler, is the
+ * difference of the counters before and after it.
+ */
+typedef struct
+{
+    uint8_t *buffer;                            /**< Trace storage. */
+    uint32_t buffer_length;                     /**< Size of the trace storage (in bytes). */
+    uint32_t length;                            /**< Number of bytes recorded, header included. */
+    uint32_t (*get_time)(void);                 /**< Timestamp source, e.g. a microsecond counter, or NULL. */
+    uint32_t time;                              /**< Timestamp of the last record. */
+
+    uint8_t frame_send[AD5940_TRACE_FRAME_SIZE];    /**< Bytes sent in the transaction being recorded. */
+    uint8_t frame_recv[AD5940_TRACE_FRAME_SIZE];    /**< Bytes received in the transaction being recorded. */
+    uint8_t frame_length;                       /**< Number of bytes of the transaction so far. */
+    BoolFlag frame_fifo;                        /**< bTRUE while recording a FIFO read. */
+    uint32_t fifo_record;                       /**< Offset of the FIFO read record being written. */
+    uint16_t fifo_length;                       /**< Number of bytes of the FIFO read so far. */
+    uint16_t address;                           /**< Last register address set by `ad5940.c`. */
+
+    uint32_t transaction_count;                 /**< Number of SPI transactions. */
+    uint32_t byte_count;                        /**< Number of bytes transferred over SPI. */
+    uint32_t dropped_count;                     /**< Number of records that did not fit in the buffer. */
+}
+AD5940_TRACE;
+
+/**
+ * @brief Starts a trace in a buffer and writes its header.
+ *
+ * @param trace             Recorder to initialize.
+ * @param buffer            Trace storage.
+ * @param buffer_length     Size of the trace storage (in bytes).
+ * @param get_time          Timestamp source, or NULL to record zero elapsed time.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_TRACE_init(
+    AD5940_TRACE *const trace,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t (*get_time)(void)
+);
+
+/**
+ * @brief Port hooks of the recorder, called in place of the port functions of the device.
+ */
+void AD5940_TRACE_cs_clr(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+);
+
+void AD5940_TRACE_cs_set(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+);
+
+void AD5940_TRACE_rst_clr(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+);
+
+void AD5940_TRACE_rst_set(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+);
+
+void AD5940_TRACE_delay_10us(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port,
+    const uint32_t time
+);
+
+void AD5940_TRACE_read_write_n_bytes(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port,
+    unsigned char *pSendBuffer,
+    unsigned char *pRecvBuff,
+    unsigned long length
+);
+
+uint32_t AD5940_TRACE_get_mcu_int_flag(
+    AD5940_TRACE *const trace,
+    const AD5940_PORT_OPS *const port
+);
+
+/**
+ * @brief One record of a trace, decoded by @ref AD5940_TRACE_read_record.
+ */
+typedef struct
+{
+    AD5940_TRACE_RECORD type;       /**< Record type. */
+    uint32_t time;                  /**< Timestamp, the sum of the elapsed times so far. */
+    uint16_t address;               /**< Register address of the register records. */
+    uint32_t value;                 /**< Register value of the register records, time of the delay records (in 10us). */
+    const uint8_t *data;            /**< Payload of the FIFO read and raw records, in the trace. */
+    uint16_t data_length;           /**< Number of payload bytes, a raw record holds 2 bytes per SPI byte. */
+}
+AD5940_TRACE_RECORD_INFO;
+
+/**
+ * @brief Checks the header of a trace.
+ *
+ * @param trace             Trace.
+ * @param length            Size of the trace (in bytes).
+ * @param offset            Pointer to store the offset of the first record.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_PARA if the header is not a trace header up to @ref AD5940_TRACE_VERSION.
+ */
+AD5940Err AD5940_TRACE_read_header(
+    const uint8_t *const trace,
+    const uint32_t length,
+    uint32_t *const offset
+);
+
+/**
+ * @brief Decodes the record at an offset of a trace.
+ *
+ * @param trace             Trace.
+ * @param length            Size of the trace (in bytes).
+ * @param offset            Offset of the record, advanced to the next record.
+ * @param record            Pointer to store the record. `time` must hold the timestamp of the previous record.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_BUFF at the end of the trace, or if the last record is truncated.
+ *                   - AD5940ERR_PARA if the record type is unknown.
+ */
+AD5940Err AD5940_TRACE_read_record(
+    const uint8_t *const trace,
+    const uint32_t length,
+    uint32_t *const offset,
+    AD5940_TRACE_RECORD_INFO *const record
+);
+
+/**
+ * @brief Replays a trace through `ad5940.c` and the applications, without an AD5940.
+ *
+ * The replay port answers the reads of `ad5940.c` with the values of the trace and
+ * checks that the writes match the trace. The reset pin, the delays and the interrupt flag
+ * follow the trace as well. A mismatch does not stop the replay, the record is consumed and counted.
+ */
+typedef struct
+{
+    const uint8_t *trace;           /**< Trace being replayed. */
+    uint32_t length;                /**< Size of the trace (in bytes). */
+    uint32_t offset;                /**< Offset of the next record. */
+    AD5940_TRACE_RECORD_INFO record;    /**< Record being replayed. */
+    BoolFlag record_valid;          /**< bTRUE when record holds the record being replayed. */
+    uint32_t record_offset;         /**< Offset of the record being replayed. */
+
+    uint8_t frame_send[AD5940_TRACE_FRAME_SIZE];    /**< Bytes sent in the transaction being replayed. */
+    uint32_t frame_length;          /**< Number of bytes of the transaction so far. */
+    uint16_t address;               /**< Last register address set by `ad5940.c`. */
+
+    BoolFlag reset_low;             /**< bTRUE while the replayed reset pin is low. */
+    uint32_t reset_hold;            /**< Time waited with the reset pin low in the last replayed reset (in 10us). */
+
+    uint32_t mismatch_count;        /**< Number of transactions that did not match the trace. */
+    uint32_t mismatch_offset;       /**< Offset of the record of the first mismatch. */
+}
+AD5940_TRACE_REPLAY;
+
+/**
+ * @brief Starts the replay of a trace.
+ *
+ * The port functions are bound to this replay, only one replay runs at a time.
+ *
+ * @param replay            Replay context to initialize.
+ * @param trace             Trace to replay.
+ * @param length            Size of the trace (in bytes).
+ * @param port              Pointer to store the port functions of the replay,
+ *                          e.g. for @ref AD5940_DEVICE_init.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure.
+ */
+AD5940Err AD5940_TRACE_REPLAY_init(
+    AD5940_TRACE_REPLAY *const replay,
+    const uint8_t *const trace,
+    const uint32_t length,
+    const AD5940_PORT_OPS **const port
+);
+
+/**
+ * @brief Peeks at the next record of the replay without consuming it.
+ *
+ * @param replay            Replay context.
+ * @param record            Pointer to store the next record.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_BUFF at the end of the trace.
+ */
+AD5940Err AD5940_TRACE_REPLAY_peek(
+    AD5940_TRACE_REPLAY *const replay,
+    AD5940_TRACE_RECORD_INFO *const record
+);
+
+/**
+ * @brief Consumes the next record of the replay, e.g. to skip what the replayed code does not send.
+ *
+ * @param replay            Replay context.
+ *
+ * @return AD5940Err Error code indicating success (0) or failure:
+ *                   - AD5940ERR_BUFF at the end of the trace.
+ */
+AD5940Err AD5940_TRACE_REPLAY_skip(
+    AD5940_TRACE_REPLAY *const replay
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,380 @@
+/**
+ * @file ad5940_benchmark.c
+ * @brief Host benchmarks of the sequence generation, upload and conversion hot paths.
+ *
+ * Usage:
+ *   ad5940_benchmark [repeat]
+ *
+ * The AD5940 is replaced by a stub port holding a register file, so the timings are the
+ * MCU side cost of `ad5940.c` and of this library, without any SPI wait. An SPI word is one
+ * register access, e.g. one sequence command written to SRAM.
+ * Before the benchmarks, it checks that a reconfiguration after a shutdown writes the AFE again,
+ * and fails without running them otherwise.
+ * Built on a host with AD5940_DEVICE_PORT_ENABLE, refer to cmake/ad5940.cmake.
+ */
+
+/* clock_gettime is POSIX, hidden by a strict -std=c99 without a feature test macro */
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ad5940.h"
+#include "ad5940_device.h"
+#include "ad5940_utils.h"
+#include "ad5940_electrochemical_utils.h"
+#include "ad5940_electrochemical_utils_waveform.h"
+
+#define REPEAT_DEFAULT 100
+#define SEQUENCE_GENERATOR_BUFFER_LENGTH 512
+#define SAMPLE_NUMBER 4096
+#define REGISTER_NUMBER 0x10000
+
+/**
+ * Stub of the AD5940: a register file behind the SPI transactions of `ad5940.c`.
+ */
+static uint32_t _registers[REGISTER_NUMBER];
+static uint8_t _frame[8];
+static uint32_t _frame_length;
+static uint16_t _address;
+static uint32_t _spi_words;
+
+static void _stub_cs_clr(void)
+{
+    _frame_length = 0;
+}
+
+static void _stub_cs_set(void)
+{
+    uint32_t value = 0;
+
+    if((_frame_length == 3) && (_frame[0] == SPICMD_SETADDR))
+    {
+        _address = (uint16_t)((_frame[1] << 8) | _frame[2]);
+        return;
+    }
+    if(_frame[0] == SPICMD_WRITEREG)
+    {
+        for(uint32_t i=1; (i<_frame_length) && (i<sizeof(_frame)); i++) value = (value << 8) | _frame[i];
+        _registers[_address] = value;
+        _spi_words++;
+        return;
+    }
+    if((_frame[0] == SPICMD_READREG) || (_frame[0] == SPICMD_READFIFO))
+    {
+        _spi_words++;
+    }
+}
+
+static void _stub_read_write_n_bytes(
+    unsigned char *pSendBuffer,
+    unsigned char *pRecvBuff,
+    unsigned long length
+)
+{
+    for(unsigned long i=0; i<length; i++)
+    {
+        const uint32_t position = _frame_length++;
+        if(position < sizeof(_frame)) _frame[position] = pSendBuffer[i];
+        pRecvBuff[i] = 0;
+        // Command byte and dummy byte, then the register data MSB first.
+        if((_frame[0] == SPICMD_READREG) && (position >= 2) && (position < 6))
+        {
+            pRecvBuff[i] = (uint8_t)(_registers[_address] >> (8 * (5 - position)));
+        }
+    }
+}
+
+static void _stub_rst(void)
+{
+}
+
+static void _stub_delay_10us(uint32_t time)
+{
+    (void) time;
+}
+
+static uint32_t _stub_int_flag(void)
+{
+    return 0;
+}
+
+static const AD5940_PORT_OPS _stub_port = {
+    .cs_clr = _stub_cs_clr,
+    .cs_set = _stub_cs_set,
+    .rst_clr = _stub_rst,
+    .rst_set = _stub_rst,
+    .delay_10us = _stub_delay_10us,
+    .read_write_n_bytes = _stub_read_write_n_bytes,
+    .get_mcu_int_flag = _stub_int_flag,
+    .clr_mcu_int_flag = _stub_int_flag,
+};
+
+static uint64_t _get_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec) * 1000000000ULL + (uint64_t) now.tv_nsec;
+}
+
+static void _report(
+    const char *const name,
+    const uint32_t parameter,
+    const uint64_t elapsed_ns,
+    const uint64_t spi_words,
+    const uint64_t steps
+)
+{
+    printf(
+        "%-28s %8u %12.1f %14.2f %14.0f\n",
+        name,
+        parameter,
+        (double) elapsed_ns / (double) steps,
+        (double) spi_words / (double) steps,
+        (double) steps * 1e9 / (double) elapsed_ns
+    );
+}
+
+static const AD5940_ClockConfig _clock_cfg = {
+    .ADCRate = ADCRATE_800KHZ,
+    .AdcClkFreq = 16000000.0f,
+    .SysClkFreq = 16000000.0f,
+    .RatioSys2AdcClk = 1.0f,
+};
+
+/**
+ * DAC sequences of a CV scan (3 ramps) or a DPV scan (1 pulse staircase) of `step_number` steps.
+ */
+static int _benchmark_waveform(
+    const char *const name,
+    const BoolFlag pulse,
+    const uint32_t step_number,
+    const uint32_t repeat
+)
+{
+    AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT segments[3];
+    AD5940_ELECTROCHEMICAL_WAVEFORM waveform = {
+        .segments = segments,
+        .segment_number = (pulse == bTRUE) ? 1 : 3,
+    };
+    const float e_step = 0.001f;
+    uint16_t level_number;
+    uint32_t sequence_length;
+
+    memset(segments, 0, sizeof(segments));
+    if(pulse == bTRUE)
+    {
+        segments[0].type = AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_PULSE;
+        segments[0].e_begin = -0.2f;
+        segments[0].e_end = -0.2f + e_step * (float)(step_number - 1);
+        segments[0].e_step = e_step;
+        segments[0].e_offset[1] = 0.05f;
+    }
+    else
+    {
+        // A quarter of the steps up to the first vertex, half down to the second, a quarter back.
+        const float e_amplitude = e_step * (float)(step_number / 4);
+        for(uint8_t i=0; i<3; i++)
+        {
+            segments[i].type = AD5940_ELECTROCHEMICAL_WAVEFORM_SEGMENT_TYPE_RAMP;
+            segments[i].e_step = e_step;
+        }
+        segments[0].e_begin = -0.2f;
+        segments[0].e_end = -0.2f + e_amplitude;
+        segments[1].e_begin = segments[0].e_end;
+        segments[1].e_end = -0.2f - e_amplitude;
+        segments[2].e_begin = segments[1].e_end;
+        segments[2].e_end = -0.2f;
+    }
+
+    if(AD5940_ELECTROCHEMICAL_WAVEFORM_get_level_number(&waveform, &level_number) != AD5940ERR_OK) return 1;
+
+    _spi_words = 0;
+    const uint64_t begin = _get_ns();
+    for(uint32_t r=0; r<repeat; r++)
+    {
+        if(AD5940_ELECTROCHEMICAL_WAVEFORM_write_sequence_commands(&waveform, NULL, NULL, 0, &sequence_length) != AD5940ERR_OK) return 1;
+    }
+    _report(name, level_number, _get_ns() - begin, _spi_words, (uint64_t) repeat * level_number);
+
+    return 0;
+}
+
+static int _benchmark_sequence_commands_config(
+    const uint32_t repeat
+)
+{
+    const DFTCfg_Type dft = {
+        .DftNum = DFTNUM_16,
+        .DftSrc = DFTSRC_SINC3,
+        .HanWinEn = bFALSE,
+    };
+    uint32_t sequence_address;
+
+    _spi_words = 0;
+    const uint64_t begin = _get_ns();
+    for(uint32_t r=0; r<repeat; r++)
+    {
+        AD5940Err error = AD5940_ELECTROCHEMICAL_write_sequence_commands_config(
+            &_clock_cfg,
+            &dft,
+            ADCAVGNUM_16,
+            ADCSINC2OSR_22,
+            ADCSINC3OSR_2,
+            bFALSE,
+            1,
+            DATATYPE_SINC3,
+            NULL,
+            AD5940_ELECTROCHEMICAL_ENERGY_MODE_DEFAULT,
+            NULL,
+            &sequence_address
+        );
+        if(error != AD5940ERR_OK) return 1;
+    }
+    _report("write_sequence_commands_config", 1, _get_ns() - begin, _spi_words, repeat);
+
+    return 0;
+}
+
+static int _benchmark_conversions(
+    const uint32_t repeat
+)
+{
+    static uint32_t adc_data[SAMPLE_NUMBER];
+    static float results[SAMPLE_NUMBER];
+    const fImpPol_Type rtia = {.Magnitude = 10000.0f, .Phase = 0.0f};
+    AD5940_TemperatureCalibration calibration;
+    float sink = 0;
+
+    for(uint32_t i=0; i<SAMPLE_NUMBER; i++) adc_data[i] = 0x8000 + (i * 7) % 0x4000;
+    if(AD5940_get_temperature_calibration(ADCPGA_1, &calibration) != AD5940ERR_OK) return 1;
+
+    _spi_words = 0;
+    uint64_t begin = _get_ns();
+    for(uint32_t r=0; r<repeat; r++)
+    {
+        for(uint32_t i=0; i<SAMPLE_NUMBER; i++)
+        {
+            AD5940_convert_adc_to_current(adc_data[i], &rtia, ADCPGA_1, 1.82f, &results[i]);
+        }
+        sink += results[r % SAMPLE_NUMBER];
+    }
+    _report("convert_adc_to_current", SAMPLE_NUMBER, _get_ns() - begin, _spi_words, (uint64_t) repeat * SAMPLE_NUMBER);
+
+    begin = _get_ns();
+    for(uint32_t r=0; r<repeat; r++)
+    {
+        for(uint32_t i=0; i<SAMPLE_NUMBER; i++)
+        {
+            AD5940_convert_adc_to_temperature(adc_data[i], ADCPGA_1, &results[i]);
+        }
+        sink += results[r % SAMPLE_NUMBER];
+    }
+    _report("convert_adc_to_temperature", SAMPLE_NUMBER, _get_ns() - begin, _spi_words, (uint64_t) repeat * SAMPLE_NUMBER);
+
+    begin = _get_ns();
+    for(uint32_t r=0; r<repeat; r++)
+    {
+        AD5940_convert_adc_array_to_temperature(adc_data, SAMPLE_NUMBER, &calibration, results);
+        sink += results[r % SAMPLE_NUMBER];
+    }
+    _report("convert_adc_array_to_temp", SAMPLE_NUMBER, _get_ns() - begin, _spi_words, (uint64_t) repeat * SAMPLE_NUMBER);
+
+    // Keep the results alive, the compiler would drop the conversions otherwise.
+    return (sink == 12345.0f) ? 1 : 0;
+}
+
+/**
+ * Checks that a reconfiguration after a shutdown writes the AFE again, even with the configuration
+ * written before the shutdown: the shutdown powers every block down behind the recorded configuration.
+ */
+static int _check_reconfigure_after_shutdown(void)
+{
+    const uint32_t AfeCtrlSet = AFECTRL_ADCPWR | AFECTRL_HSTIAPWR | AFECTRL_INAMPPWR;
+    AFERefCfg_Type reference;
+    LPLoopCfg_Type lp_loop;
+    HSLoopCfg_Type hs_loop;
+    DSPCfg_Type dsp;
+
+    memset(&reference, 0, sizeof(reference));
+    memset(&lp_loop, 0, sizeof(lp_loop));
+    memset(&hs_loop, 0, sizeof(hs_loop));
+    memset(&dsp, 0, sizeof(dsp));
+    reference.HpBandgapEn = bTRUE;
+    reference.Hp1V1BuffEn = bTRUE;
+    reference.Hp1V8BuffEn = bTRUE;
+
+    // Start: every block written and recorded.
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_reference(&reference);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_lp_loop(&lp_loop);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_hs_loop(&hs_loop);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(&dsp);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_power(AfeCtrlSet);
+
+    if(AD5940_shutdown_afe_lploop_hsloop_dsp() != AD5940ERR_OK) return 1;
+
+    // Same configuration as before the shutdown.
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_begin();
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_reference(&reference);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_lp_loop(&lp_loop);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_hs_loop(&hs_loop);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_dsp(&dsp);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_power(AfeCtrlSet);
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_commit();
+    const uint32_t written_blocks = AD5940_ELECTROCHEMICAL_RECONFIGURE_get_written_blocks();
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_end();
+
+    const uint32_t expected_blocks = AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_REFERENCE
+                                   | AD5940_ELECTROCHEMICAL_RECONFIGURE_BLOCK_POWER;
+    if((written_blocks & expected_blocks) != expected_blocks
+        || (_registers[REG_AFE_AFECON] & AfeCtrlSet) != AfeCtrlSet)
+    {
+        fprintf(stderr, "reconfigure after shutdown: REF/AFECTRL not written again\n");
+        return 1;
+    }
+
+    // Leave the AFE as the benchmarks expect it.
+    return (AD5940_shutdown_afe_lploop_hsloop_dsp() == AD5940ERR_OK) ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    static uint32_t sequence_generator_buffer[SEQUENCE_GENERATOR_BUFFER_LENGTH];
+    static const uint32_t step_numbers[] = {32, 128, 320};   // Up to 960 of the 1024 commands of 4kB sequencer memory.
+    AD5940_DEVICE device;
+    int result = 0;
+
+    const uint32_t repeat = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 0) : REPEAT_DEFAULT;
+    if(repeat == 0)
+    {
+        fprintf(stderr, "usage: %s [repeat]\n", argv[0]);
+        return 1;
+    }
+
+    _registers[REG_AFECON_ADIID] = 0x4144;   // Answers AD5940_WakeUp.
+    if(AD5940_DEVICE_init(&device, &_stub_port, sequence_generator_buffer, SEQUENCE_GENERATOR_BUFFER_LENGTH) != AD5940ERR_OK) return 1;
+    if(AD5940_DEVICE_select(&device) != AD5940ERR_OK) return 1;
+    if(_check_reconfigure_after_shutdown() != 0) return 1;
+
+    printf("%-28s %8s %12s %14s %14s\n", "benchmark", "steps", "ns/step", "SPI words/step", "steps/s");
+    for(uint8_t i=0; i<sizeof(step_numbers)/sizeof(step_numbers[0]); i++)
+    {
+        result |= _benchmark_waveform("cv_write_sequence_commands", bFALSE, step_numbers[i], repeat);
+    }
+    for(uint8_t i=0; i<sizeof(step_numbers)/sizeof(step_numbers[0]); i++)
+    {
+        // Two levels per DPV step, half the steps for the same SRAM footprint.
+        result |= _benchmark_waveform("dpv_write_sequence_commands", bTRUE, step_numbers[i] / 2, repeat);
+    }
+    result |= _benchmark_sequence_commands_config(repeat);
+
+    printf("\n%-28s %8s %12s %14s %14s\n", "benchmark", "samples", "ns/sample", "SPI words", "samples/s");
+    result |= _benchmark_conversions(repeat);
+
+    if(result != 0) fprintf(stderr, "a benchmark failed\n");
+    return result;
+}
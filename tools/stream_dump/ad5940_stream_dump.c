@@ -0,0 +1,245 @@
+/**
+ * @file ad5940_stream_dump.c
+ * @brief Host decoder of the measurement streams of utils/ad5940_utils_stream.h.
+ *
+ * Usage:
+ *   ad5940_stream_dump <stream>      Prints the run header, then one line per sample as CSV.
+ *
+ * The stream is read in place, the frames are checked and the lost or corrupted frames
+ * and the gaps of the sample index are reported on stderr, packed sample frames are decompressed. Current samples are
+ * converted with the gain of the run header.
+ * Built on a host, refer to cmake/ad5940.cmake.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ad5940.h"
+#include "ad5940_utils.h"
+#include "ad5940_utils_stream.h"
+#include "ad5940_electrochemical_utils_temperature.h"
+
+static uint8_t *_load(
+    const char *const path,
+    uint32_t *const length
+)
+{
+    FILE *file = fopen(path, "rb");
+    if(file == NULL) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if(size <= 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    // malloc returns an address aligned for any type, so the payloads are 4-byte aligned.
+    uint8_t *stream = malloc((size_t) size);
+    if((stream != NULL) && (fread(stream, 1, (size_t) size, file) != (size_t) size))
+    {
+        free(stream);
+        stream = NULL;
+    }
+    fclose(file);
+
+    *length = (uint32_t) size;
+    return stream;
+}
+
+static void _print_run(
+    const AD5940_STREAM_RUN_INFO *const run
+)
+{
+    printf("# technique %u, data type %u, PGA %u, VRef %g V, RTIA %g ohm, %u captures per step\n",
+        (unsigned) run->technique,
+        run->DataType,
+        run->ADCPga,
+        run->VRef,
+        run->rtia.Magnitude,
+        run->sampling_number
+    );
+    printf("# parameters");
+    for(uint8_t i=0; i<run->parameter_number; i++)
+    {
+        printf(" %g", AD5940_STREAM_get_float(run->parameters, i));
+    }
+    printf("\n");
+    if(run->calibration_valid == bTRUE)
+    {
+        printf("# calibration at %u s, LFOSC %g Hz\n", run->calibration.timestamp, run->calibration.LFOSCClkFreq);
+    }
+    printf("index,step,seqid,code,value\n");
+}
+
+static void _print_sample(
+    const AD5940_STREAM_RUN_INFO *const run,
+    const uint32_t index,
+    const uint32_t word
+)
+{
+    const uint32_t step = (run->sampling_number > 0) ? (index / run->sampling_number) : index;
+    float value = 0;
+
+    // Temperature captures are interleaved in the same FIFO, in degrees Celsius, the rest in amperes.
+    if(AD5940_ELECTROCHEMICAL_TEMPERATURE_is_temperature_data(word) == bTRUE)
+    {
+        AD5940_convert_adc_to_temperature(word, run->ADCPga, &value);
+    }
+    else if(run->rtia.Magnitude > 0)
+    {
+        AD5940_convert_adc_to_current(word, &run->rtia, run->ADCPga, run->VRef, &value);
+    }
+    printf("%u,%u,%u,%u,%g\n", index, step, AD5940_ELECTROCHEMICAL_FIFO_SEQID(word), word & 0xFFFF, value);
+}
+
+/**
+ * Reports the samples missing before a sample frame: lost on the device, refer to
+ * AD5940_STREAM_skip_samples, or in lost frames.
+ */
+static int _check_sample_index(
+    uint32_t *const sample_index,
+    const uint32_t first_index,
+    const uint16_t sample_number
+)
+{
+    int gap = 0;
+    if(first_index != *sample_index)
+    {
+        fprintf(stderr, "%u samples missing before sample %u\n", first_index - *sample_index, first_index);
+        gap = 1;
+    }
+    *sample_index = first_index + sample_number;
+    return gap;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc != 2)
+    {
+        fprintf(stderr, "usage: %s <stream>\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t length;
+    uint8_t *stream = _load(argv[1], &length);
+    if(stream == NULL)
+    {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    AD5940_STREAM_FRAME frame;
+    AD5940_STREAM_RUN_INFO run = {0};
+    BoolFlag run_valid = bFALSE;
+    uint32_t offset = 0;
+    uint32_t skipped = 0;
+    uint16_t sequence = 0;
+    uint32_t frame_count = 0;
+    uint32_t sample_index = 0;
+    int result = 0;
+
+    while(offset < length)
+    {
+        AD5940Err error = AD5940_STREAM_read_frame(stream, length, &offset, &frame);
+        if(error == AD5940ERR_BUFF)
+        {
+            fprintf(stderr, "truncated frame at offset %u\n", offset);
+            result = 2;
+            break;
+        }
+        if(error != AD5940ERR_OK)
+        {
+            // Resynchronize on the next sync word.
+            offset++;
+            skipped++;
+            continue;
+        }
+        if(skipped > 0)
+        {
+            fprintf(stderr, "%u bytes skipped before offset %u\n", skipped, offset);
+            skipped = 0;
+            result = 2;
+        }
+        if((frame_count > 0) && (frame.sequence != sequence))
+        {
+            fprintf(stderr, "%u frames lost before frame %u\n", (uint16_t)(frame.sequence - sequence), frame.sequence);
+            result = 2;
+        }
+        sequence = frame.sequence + 1;
+        frame_count++;
+
+        switch (frame.type)
+        {
+        case AD5940_STREAM_FRAME_RUN:
+            if(AD5940_STREAM_get_run(&frame, &run) != AD5940ERR_OK)
+            {
+                fprintf(stderr, "invalid run header in frame %u\n", frame.sequence);
+                result = 2;
+                break;
+            }
+            run_valid = bTRUE;
+            sample_index = 0;
+            _print_run(&run);
+            break;
+
+        case AD5940_STREAM_FRAME_SAMPLES:
+        {
+            uint32_t first_index;
+            const uint8_t *samples;
+            uint16_t sample_number;
+            if(run_valid == bFALSE) break;      // The run header was lost, the samples cannot be converted.
+            if(AD5940_STREAM_get_samples(&frame, &first_index, &samples, &sample_number) != AD5940ERR_OK) break;
+            if(_check_sample_index(&sample_index, first_index, sample_number) != 0) result = 2;
+            for(uint16_t i=0; i<sample_number; i++)
+            {
+                _print_sample(&run, first_index + i, AD5940_STREAM_get_u32(samples, i));
+            }
+            break;
+        }
+
+        case AD5940_STREAM_FRAME_SAMPLES_PACKED:
+        {
+            static uint32_t fifo_data[AD5940_STREAM_PACKED_SAMPLE_NUMBER_MAX];
+            uint32_t first_index;
+            uint16_t sample_number;
+            if(run_valid == bFALSE) break;
+            if(AD5940_STREAM_get_packed_samples(&frame, &first_index, fifo_data, AD5940_STREAM_PACKED_SAMPLE_NUMBER_MAX, &sample_number) != AD5940ERR_OK)
+            {
+                fprintf(stderr, "invalid packed samples in frame %u\n", frame.sequence);
+                result = 2;
+                break;
+            }
+            if(_check_sample_index(&sample_index, first_index, sample_number) != 0) result = 2;
+            for(uint16_t i=0; i<sample_number; i++)
+            {
+                _print_sample(&run, first_index + i, fifo_data[i]);
+            }
+            break;
+        }
+
+        case AD5940_STREAM_FRAME_END:
+        {
+            uint32_t sample_count;
+            AD5940Err status;
+            if(AD5940_STREAM_get_end(&frame, &sample_count, &status) != AD5940ERR_OK) break;
+            printf("# end, %u samples, error %d\n", sample_count, (int) status);
+            break;
+        }
+
+        default:
+            fprintf(stderr, "unknown frame type %u\n", (unsigned) frame.type);
+            break;
+        }
+    }
+    if(skipped > 0)
+    {
+        fprintf(stderr, "%u bytes skipped at the end\n", skipped);
+        result = 2;
+    }
+
+    free(stream);
+    return result;
+}
@@ -0,0 +1,296 @@
+/**
+ * @file ad5940_trace_replay.c
+ * @brief Offline inspection and replay of an AD5940 SPI trace, see main/ad5940_trace.h.
+ *
+ * Usage:
+ *   ad5940_trace_replay <trace>                      Lists the records and the SPI cost per record type.
+ *   ad5940_trace_replay <trace> --irq [fifo_thresh]  Replays the interrupts through AD5940_irq_handler.
+ *   ad5940_trace_replay <trace> --reset              Replays the first reset through AD5940_MAIN_reset.
+ *
+ * The replay answers the reads of `ad5940.c` from the trace and reports the transactions
+ * that differ from the trace, e.g. after a change of the interrupt handler. The delays are
+ * checked against the trace as well, so a reset replay also reports how long the reset pin was held low.
+ * Built on a host with AD5940_DEVICE_PORT_ENABLE, refer to cmake/ad5940.cmake.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ad5940.h"
+#include "ad5940_device.h"
+#include "ad5940_trace.h"
+#include "ad5940_irq_handler.h"
+#include "ad5940_main.h"
+
+#define SEQUENCE_GENERATOR_BUFFER_LENGTH 512
+#define FIFO_BUFFER_LENGTH 1024     // Largest data FIFO (4kB) in words.
+#define RECORD_TYPE_NUMBER (AD5940_TRACE_RECORD_DELAY + 1)
+
+static const char *const _record_names[RECORD_TYPE_NUMBER] = {
+    "?",
+    "write16",
+    "write32",
+    "read16",
+    "read32",
+    "fifo",
+    "raw",
+    "reset",
+    "interrupt",
+    "release",
+    "delay",
+};
+
+/**
+ * SPI bytes of a record: set address (3 bytes) and register transaction,
+ * or command, dummy bytes and data of a FIFO read.
+ */
+static uint32_t _get_spi_bytes(
+    const AD5940_TRACE_RECORD_INFO *const record
+)
+{
+    switch (record->type)
+    {
+    case AD5940_TRACE_RECORD_WRITE_REG16: return 3 + 3;
+    case AD5940_TRACE_RECORD_WRITE_REG32: return 3 + 5;
+    case AD5940_TRACE_RECORD_READ_REG16: return 3 + 4;
+    case AD5940_TRACE_RECORD_READ_REG32: return 3 + 6;
+    case AD5940_TRACE_RECORD_READ_FIFO: return 7 + record->data_length;
+    case AD5940_TRACE_RECORD_RAW: return record->data_length / 2;
+    default: return 0;
+    }
+}
+
+static uint8_t *_load(
+    const char *const path,
+    uint32_t *const length
+)
+{
+    FILE *file = fopen(path, "rb");
+    if(file == NULL) return NULL;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if(size <= 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    uint8_t *trace = malloc((size_t) size);
+    if((trace != NULL) && (fread(trace, 1, (size_t) size, file) != (size_t) size))
+    {
+        free(trace);
+        trace = NULL;
+    }
+    fclose(file);
+
+    *length = (uint32_t) size;
+    return trace;
+}
+
+static int _list(
+    const uint8_t *const trace,
+    const uint32_t length
+)
+{
+    uint32_t offset;
+    AD5940_TRACE_RECORD_INFO record = {0};
+    uint32_t count[RECORD_TYPE_NUMBER] = {0};
+    uint32_t bytes[RECORD_TYPE_NUMBER] = {0};
+
+    if(AD5940_TRACE_read_header(trace, length, &offset) != AD5940ERR_OK)
+    {
+        fprintf(stderr, "not an AD5940 trace up to version %d\n", AD5940_TRACE_VERSION);
+        return 1;
+    }
+
+    AD5940Err error;
+    while((error = AD5940_TRACE_read_record(trace, length, &offset, &record)) == AD5940ERR_OK)
+    {
+        switch (record.type)
+        {
+        case AD5940_TRACE_RECORD_READ_FIFO:
+        case AD5940_TRACE_RECORD_RAW:
+            printf("%10u %-9s %u bytes\n", record.time, _record_names[record.type], record.data_length);
+            break;
+        case AD5940_TRACE_RECORD_RESET:
+        case AD5940_TRACE_RECORD_INTERRUPT:
+        case AD5940_TRACE_RECORD_RESET_RELEASE:
+            printf("%10u %-9s\n", record.time, _record_names[record.type]);
+            break;
+        case AD5940_TRACE_RECORD_DELAY:
+            printf("%10u %-9s %u0 us\n", record.time, _record_names[record.type], record.value);
+            break;
+        default:
+            printf("%10u %-9s 0x%04X 0x%08X\n", record.time, _record_names[record.type], record.address, record.value);
+            break;
+        }
+        count[record.type]++;
+        bytes[record.type] += _get_spi_bytes(&record);
+    }
+    if(error != AD5940ERR_BUFF || offset != length)
+    {
+        fprintf(stderr, "invalid record at offset %u\n", offset);
+    }
+
+    printf("\n%-9s %8s %10s\n", "type", "records", "SPI bytes");
+    for(uint8_t i=1; i<RECORD_TYPE_NUMBER; i++)
+    {
+        printf("%-9s %8u %10u\n", _record_names[i], count[i], bytes[i]);
+    }
+
+    return 0;
+}
+
+static int _replay_irq(
+    const uint8_t *const trace,
+    const uint32_t length,
+    const int32_t new_fifo_thresh
+)
+{
+    AD5940Err error;
+    AD5940_TRACE_REPLAY replay;
+    const AD5940_PORT_OPS *port;
+    AD5940_DEVICE device;
+    AD5940_TRACE_RECORD_INFO record;
+
+    static uint32_t sequence_generator_buffer[SEQUENCE_GENERATOR_BUFFER_LENGTH];
+    static uint32_t fifo_buffer[FIFO_BUFFER_LENGTH];
+    uint16_t fifo_length;
+    uint32_t interrupt_count = 0;
+    uint32_t skip_count = 0;
+
+    error = AD5940_TRACE_REPLAY_init(&replay, trace, length, &port);
+    if(error)
+    {
+        fprintf(stderr, "not an AD5940 trace up to version %d\n", AD5940_TRACE_VERSION);
+        return 1;
+    }
+
+    error = AD5940_DEVICE_init(&device, port, sequence_generator_buffer, SEQUENCE_GENERATOR_BUFFER_LENGTH);
+    if(error) return 1;
+
+    while(AD5940_TRACE_REPLAY_peek(&replay, &record) == AD5940ERR_OK)
+    {
+        // Only the interrupts are replayed, what the application did in between is skipped.
+        if(record.type != AD5940_TRACE_RECORD_INTERRUPT)
+        {
+            AD5940_TRACE_REPLAY_skip(&replay);
+            skip_count++;
+            continue;
+        }
+
+        error = AD5940_DEVICE_select(&device);
+        if(error) return 1;
+        if(AD5940_GetMCUIntFlag() == 0) continue;
+        AD5940_ClrMCUIntFlag();
+
+        error = AD5940_irq_handler(
+            new_fifo_thresh,
+            FIFO_BUFFER_LENGTH,
+            fifo_buffer,
+            &fifo_length
+        );
+        printf("%10u interrupt %u words, error %d\n", record.time, fifo_length, (int) error);
+        for(uint16_t i=0; i<fifo_length; i++)
+        {
+            printf("%10s 0x%08X\n", "", fifo_buffer[i]);
+        }
+        interrupt_count++;
+    }
+
+    printf("\n%u interrupts replayed, %u records skipped, %u mismatches", interrupt_count, skip_count, replay.mismatch_count);
+    if(replay.mismatch_count > 0) printf(", first at offset %u", replay.mismatch_offset);
+    printf("\n");
+
+    return (replay.mismatch_count > 0) ? 2 : 0;
+}
+
+static int _replay_reset(
+    const uint8_t *const trace,
+    const uint32_t length
+)
+{
+    AD5940Err error;
+    AD5940_TRACE_REPLAY replay;
+    const AD5940_PORT_OPS *port;
+    AD5940_DEVICE device;
+    AD5940_TRACE_RECORD_INFO record;
+
+    static uint32_t sequence_generator_buffer[SEQUENCE_GENERATOR_BUFFER_LENGTH];
+    uint32_t skip_count = 0;
+
+    error = AD5940_TRACE_REPLAY_init(&replay, trace, length, &port);
+    if(error)
+    {
+        fprintf(stderr, "not an AD5940 trace up to version %d\n", AD5940_TRACE_VERSION);
+        return 1;
+    }
+
+    error = AD5940_DEVICE_init(&device, port, sequence_generator_buffer, SEQUENCE_GENERATOR_BUFFER_LENGTH);
+    if(error) return 1;
+    error = AD5940_DEVICE_select(&device);
+    if(error) return 1;
+
+    // What the application did before the reset is skipped.
+    while(AD5940_TRACE_REPLAY_peek(&replay, &record) == AD5940ERR_OK)
+    {
+        if(record.type == AD5940_TRACE_RECORD_RESET) break;
+        AD5940_TRACE_REPLAY_skip(&replay);
+        skip_count++;
+    }
+    if(record.type != AD5940_TRACE_RECORD_RESET)
+    {
+        fprintf(stderr, "no reset in the trace\n");
+        return 1;
+    }
+
+    error = AD5940_MAIN_reset();
+    printf("%10u reset held %u0 us, error %d\n", record.time, replay.reset_hold, (int) error);
+
+    printf("\n%u records skipped, %u mismatches", skip_count, replay.mismatch_count);
+    if(replay.mismatch_count > 0) printf(", first at offset %u", replay.mismatch_offset);
+    printf("\n");
+
+    return (replay.mismatch_count > 0) ? 2 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    if((argc < 2)
+        || ((argc > 2) && (strcmp(argv[2], "--irq") != 0) && (strcmp(argv[2], "--reset") != 0))
+        || ((argc > 3) && (strcmp(argv[2], "--reset") == 0)))
+    {
+        fprintf(stderr, "usage: %s <trace> [--irq [fifo_thresh] | --reset]\n", argv[0]);
+        return 1;
+    }
+
+    uint32_t length;
+    uint8_t *trace = _load(argv[1], &length);
+    if(trace == NULL)
+    {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    int result;
+    if((argc > 2) && (strcmp(argv[2], "--reset") == 0))
+    {
+        result = _replay_reset(trace, length);
+    }
+    else if(argc > 2)
+    {
+        // The FIFO threshold is kept unless given, as by the application during a measurement.
+        int32_t new_fifo_thresh = (argc > 3) ? (int32_t) strtol(argv[3], NULL, 0) : -1;
+        result = _replay_irq(trace, length, new_fifo_thresh);
+    }
+    else
+    {
+        result = _list(trace, length);
+    }
+
+    free(trace);
+    return result;
+}
@@ -7,13 +7,17 @@ extern "C"
 
 #include "ad5940_utils_struct.h"
 #include "ad5940_utils_adc.h"
+#include "ad5940_utils_calibration.h"
+#include "ad5940_utils_compress.h"
 #include "ad5940_utils_afe.h"
 #include "ad5940_utils_fifo.h"
 #include "ad5940_utils_gpio.h"
 #include "ad5940_utils_hsdac.h"
 #include "ad5940_utils_lpdac.h"
+#include "ad5940_utils_metrics.h"
 #include "ad5940_utils_power.h"
 #include "ad5940_utils_sequence_generator.h"
+#include "ad5940_utils_stream.h"
 
 #ifdef __cplusplus
 }
@@ -1,5 +1,9 @@
 #include "ad5940_utils_adc.h"
 
+#include <math.h>
+
+#define TEMPERATURE_SENSOR_GAIN 8.13f   // ADC codes per Kelvin at PGA 1. Refer to datasheet page 57.
+
 static const uint32_t dft_table[] = {4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384};
 static const uint32_t sinc2osr_table[] = {22,44,89,178,267,533,640,667,800,889,1067,1333,0};
 static const uint32_t sinc3osr_table[] = {5,4,2,0};
@@ -129,7 +133,6 @@ AD5940Err AD5940_convert_adc_to_temperature(
     float *const temperature
 )
 {
-    #define K 8.13f
     float adcpga_float;
     AD5940Err error = AD5940_map_ADCPGA(
         ADCPGA_Const,
@@ -138,6 +141,73 @@ AD5940Err AD5940_convert_adc_to_temperature(
     if(error != AD5940ERR_OK) return AD5940ERR_PARA;
     *temperature = adc_data & 0xffff;
     *temperature -= 0x8000;	// data from SINC2 is added 0x8000, while data from register TEMPSENSDAT has no 0x8000 offset.
-    *temperature = (*temperature / K / adcpga_float - 273.15f);
+    *temperature = (*temperature / TEMPERATURE_SENSOR_GAIN / adcpga_float - 273.15f);
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_get_temperature_calibration(
+    const uint32_t ADCPGA_Const,
+    AD5940_TemperatureCalibration *const calibration
+)
+{
+    float adcpga_float;
+    AD5940Err error = AD5940_map_ADCPGA(
+        ADCPGA_Const,
+        &adcpga_float
+    );
+    if(error != AD5940ERR_OK) return AD5940ERR_PARA;
+    calibration->slope = 1.0f / (TEMPERATURE_SENSOR_GAIN * adcpga_float);
+    calibration->offset = -0x8000 * calibration->slope - 273.15f;   // data from SINC2 is added 0x8000.
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_calibrate_temperature_one_point(
+    const uint32_t adc_data,
+    const float reference_temperature,
+    const uint32_t ADCPGA_Const,
+    AD5940_TemperatureCalibration *const calibration
+)
+{
+    AD5940Err error = AD5940_get_temperature_calibration(
+        ADCPGA_Const,
+        calibration
+    );
+    if(error != AD5940ERR_OK) return error;
+    calibration->offset = reference_temperature - calibration->slope * (float)(adc_data & 0xFFFF);
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_calibrate_temperature_two_point(
+    const uint32_t adc_data[2],
+    const float reference_temperature[2],
+    AD5940_TemperatureCalibration *const calibration
+)
+{
+    float code_0 = (float)(adc_data[0] & 0xFFFF);
+    float code_1 = (float)(adc_data[1] & 0xFFFF);
+    if(code_0 == code_1) return AD5940ERR_PARA;
+    calibration->slope = (reference_temperature[1] - reference_temperature[0]) / (code_1 - code_0);
+    calibration->offset = reference_temperature[0] - calibration->slope * code_0;
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_convert_adc_array_to_temperature(
+    const uint32_t *const adc_data,
+    const uint32_t length,
+    const AD5940_TemperatureCalibration *const calibration,
+    float *const temperatures
+)
+{
+    const float slope = calibration->slope;
+    const float offset = calibration->offset;
+    for(uint32_t i=0; i<length; i++)
+    {
+#ifdef FP_FAST_FMAF
+        temperatures[i] = fmaf(slope, (float)(adc_data[i] & 0xFFFF), offset);
+#else
+        /* Without a hardware FMA, fmaf is a slow library call */
+        temperatures[i] = slope * (float)(adc_data[i] & 0xFFFF) + offset;
+#endif
+    }
     return AD5940ERR_OK;
 }
@@ -7,6 +7,18 @@ extern "C"
 
 #include "ad5940.h"
 
+/**
+ * Linear map from a temperature sensor ADC code to degrees Celsius:
+ * temperature = slope * (adc_data & 0xFFFF) + offset.
+ * The PGA gain, the sensor gain and the SINC2 offset are all folded into slope and offset.
+ */
+typedef struct
+{
+    float slope;    // Degrees Celsius per ADC code.
+    float offset;   // Degrees Celsius at ADC code 0.
+}
+AD5940_TemperatureCalibration;
+
 /**
  * Calculates the calibration frequency based on various parameters.
  * 
@@ -120,6 +132,76 @@ AD5940Err AD5940_convert_adc_to_temperature(
     float *const temperature
 );
 
+/**
+ * Gets the nominal temperature calibration from the datasheet sensor gain.
+ * It gives the same result as @ref AD5940_convert_adc_to_temperature.
+ * 
+ * @param ADCPGA_Const          ADC PGA gain configuration constant. See @ref ADCPGA_Const.
+ * @param calibration           Pointer to store the calibration.
+ * 
+ * @return AD5940Err Error code indicating the success or failure of the operation.
+ */
+AD5940Err AD5940_get_temperature_calibration(
+    const uint32_t ADCPGA_Const,
+    AD5940_TemperatureCalibration *const calibration
+);
+
+/**
+ * One-point temperature calibration.
+ * Keeps the nominal slope and moves the offset so that adc_data reads reference_temperature.
+ * 
+ * @param adc_data              ADC data measured at the reference temperature.
+ * @param reference_temperature Reference temperature (in degrees Celsius).
+ * @param ADCPGA_Const          ADC PGA gain configuration constant. See @ref ADCPGA_Const.
+ * @param calibration           Pointer to store the calibration.
+ * 
+ * @return AD5940Err Error code indicating the success or failure of the operation.
+ */
+AD5940Err AD5940_calibrate_temperature_one_point(
+    const uint32_t adc_data,
+    const float reference_temperature,
+    const uint32_t ADCPGA_Const,
+    AD5940_TemperatureCalibration *const calibration
+);
+
+/**
+ * Two-point temperature calibration.
+ * Fits both slope and offset through the two reference points.
+ * 
+ * @param adc_data              ADC data measured at the two reference temperatures.
+ * @param reference_temperature The two reference temperatures (in degrees Celsius).
+ * @param calibration           Pointer to store the calibration.
+ * 
+ * @return AD5940Err Error code indicating the success or failure of the operation.
+ */
+AD5940Err AD5940_calibrate_temperature_two_point(
+    const uint32_t adc_data[2],
+    const float reference_temperature[2],
+    AD5940_TemperatureCalibration *const calibration
+);
+
+/**
+ * Converts an array of ADC data to temperature values with a precomputed calibration.
+ * Each sample costs one multiply-add, there is no PGA lookup or division.
+ * adc_data and temperatures must be different buffers, in place conversion is not supported:
+ * the compiler assumes that a uint32_t and a float array do not overlap.
+ * 
+ * @param adc_data              The ADC data retrieved from the FIFO.
+ * @param length                Number of ADC data.
+ * @param calibration           Calibration from @ref AD5940_get_temperature_calibration,
+ *                              @ref AD5940_calibrate_temperature_one_point
+ *                              or @ref AD5940_calibrate_temperature_two_point.
+ * @param temperatures          Array to store the resulting temperature values (in degrees Celsius).
+ * 
+ * @return AD5940Err Error code indicating the success or failure of the operation.
+ */
+AD5940Err AD5940_convert_adc_array_to_temperature(
+    const uint32_t *const adc_data,
+    const uint32_t length,
+    const AD5940_TemperatureCalibration *const calibration,
+    float *const temperatures
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,160 @@
+#include "ad5940_utils_calibration.h"
+
+#include <math.h>
+#include <string.h>
+
+#define RECORD_MAGIC 0xCA1Bu                // Tells a written record from erased storage.
+#define RECORD_HEADER_SIZE 4                // Magic, version and payload length.
+#define RECORD_PAYLOAD_SIZE 44
+#define RECORD_CRC_SIZE 4
+
+static void _put_u32(
+    uint8_t *const buffer,
+    const uint32_t value
+)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t _get_u32(
+    const uint8_t *const buffer
+)
+{
+    return ((uint32_t) buffer[0])
+        | ((uint32_t) buffer[1] << 8)
+        | ((uint32_t) buffer[2] << 16)
+        | ((uint32_t) buffer[3] << 24);
+}
+
+static void _put_float(
+    uint8_t *const buffer,
+    const float value
+)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    _put_u32(buffer, bits);
+}
+
+static float _get_float(
+    const uint8_t *const buffer
+)
+{
+    uint32_t bits = _get_u32(buffer);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint32_t AD5940_crc32(
+    const uint8_t *const data,
+    const uint32_t length
+)
+{
+    // Bitwise, the record and the stream frames are short so a 1 kB table is not worth it.
+    uint32_t crc = 0xFFFFFFFFu;
+    for(uint32_t i=0; i<length; i++)
+    {
+        crc ^= data[i];
+        for(uint8_t bit=0; bit<8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+AD5940Err AD5940_serialize_calibration_record(
+    const AD5940_CalibrationRecord *const record,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+)
+{
+    if(buffer_length < AD5940_CALIBRATION_RECORD_SIZE) return AD5940ERR_BUFF;
+
+    buffer[0] = (uint8_t)(RECORD_MAGIC);
+    buffer[1] = (uint8_t)(RECORD_MAGIC >> 8);
+    buffer[2] = AD5940_CALIBRATION_RECORD_VERSION;
+    buffer[3] = RECORD_PAYLOAD_SIZE;
+
+    uint8_t *payload = buffer + RECORD_HEADER_SIZE;
+    _put_float(payload + 0, record->LFOSCClkFreq);
+    _put_float(payload + 4, record->HsRtia.Magnitude);
+    _put_float(payload + 8, record->HsRtia.Phase);
+    _put_u32(payload + 12, record->HstiaRtiaSel);
+    _put_float(payload + 16, record->LpRtia.Magnitude);
+    _put_float(payload + 20, record->LpRtia.Phase);
+    _put_u32(payload + 24, record->LpTiaRtia);
+    _put_float(payload + 28, record->temperature.slope);
+    _put_float(payload + 32, record->temperature.offset);
+    _put_u32(payload + 36, record->timestamp);
+    _put_float(payload + 40, record->die_temperature);
+
+    _put_u32(
+        buffer + RECORD_HEADER_SIZE + RECORD_PAYLOAD_SIZE,
+        AD5940_crc32(buffer, RECORD_HEADER_SIZE + RECORD_PAYLOAD_SIZE)
+    );
+
+    *length = AD5940_CALIBRATION_RECORD_SIZE;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_deserialize_calibration_record(
+    const uint8_t *const buffer,
+    const uint32_t length,
+    AD5940_CalibrationRecord *const record
+)
+{
+    if(length < AD5940_CALIBRATION_RECORD_SIZE) return AD5940ERR_BUFF;
+
+    if((buffer[0] | (buffer[1] << 8)) != RECORD_MAGIC) return AD5940ERR_PARA;
+    if(buffer[2] != AD5940_CALIBRATION_RECORD_VERSION) return AD5940ERR_PARA;
+    if(buffer[3] != RECORD_PAYLOAD_SIZE) return AD5940ERR_PARA;
+
+    const uint32_t crc = _get_u32(buffer + RECORD_HEADER_SIZE + RECORD_PAYLOAD_SIZE);
+    if(crc != AD5940_crc32(buffer, RECORD_HEADER_SIZE + RECORD_PAYLOAD_SIZE)) return AD5940ERR_PARA;
+
+    const uint8_t *payload = buffer + RECORD_HEADER_SIZE;
+    record->LFOSCClkFreq = _get_float(payload + 0);
+    record->HsRtia.Magnitude = _get_float(payload + 4);
+    record->HsRtia.Phase = _get_float(payload + 8);
+    record->HstiaRtiaSel = _get_u32(payload + 12);
+    record->LpRtia.Magnitude = _get_float(payload + 16);
+    record->LpRtia.Phase = _get_float(payload + 20);
+    record->LpTiaRtia = _get_u32(payload + 24);
+    record->temperature.slope = _get_float(payload + 28);
+    record->temperature.offset = _get_float(payload + 32);
+    record->timestamp = _get_u32(payload + 36);
+    record->die_temperature = _get_float(payload + 40);
+
+    return AD5940ERR_OK;
+}
+
+BoolFlag AD5940_is_calibration_record_valid(
+    const AD5940_CalibrationRecord *const record,
+    const AD5940_CalibrationPolicy *const policy,
+    const uint32_t now,
+    const float die_temperature
+)
+{
+    if(!(record->LFOSCClkFreq > 0)) return bFALSE;
+
+    if(policy->max_age > 0)
+    {
+        // The clock went backwards, e.g. it was reset, so the age is unknown.
+        if(now < record->timestamp) return bFALSE;
+        if((now - record->timestamp) > policy->max_age) return bFALSE;
+    }
+
+    if(policy->max_temperature_drift > 0)
+    {
+        if(fabsf(die_temperature - record->die_temperature) > policy->max_temperature_drift) return bFALSE;
+    }
+
+    return bTRUE;
+}
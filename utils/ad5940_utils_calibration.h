@@ -0,0 +1,119 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_utils_adc.h"
+
+/**
+ * Version of the serialized calibration record.
+ * Bump it whenever the layout of the serialized record changes, older records are then rejected.
+ */
+#define AD5940_CALIBRATION_RECORD_VERSION 1
+
+/**
+ * Size of a serialized calibration record (in bytes): 4 bytes header, 44 bytes payload, 4 bytes CRC32.
+ */
+#define AD5940_CALIBRATION_RECORD_SIZE 52
+
+/**
+ * Calibration results that are slow to measure, kept across power cycles.
+ *
+ * - LFOSCClkFreq: @ref AD5940_LFOSCMeasure, used by the run configurations.
+ * - HsRtia / LpRtia: @ref AD5940_HSRtiaCal and @ref AD5940_LPRtiaCal, only valid for the RTIA they were measured with.
+ * - temperature: @ref AD5940_calibrate_temperature_one_point or @ref AD5940_calibrate_temperature_two_point.
+ */
+typedef struct
+{
+    float LFOSCClkFreq;                         // Measured LFOSC frequency (in Hz).
+    fImpPol_Type HsRtia;                        // HSTIA RTIA calibration result.
+    uint32_t HstiaRtiaSel;                      // HSTIA RTIA the result belongs to. See @ref HSTIARTIA_Const.
+    fImpPol_Type LpRtia;                        // LPTIA RTIA calibration result.
+    uint32_t LpTiaRtia;                         // LPTIA RTIA the result belongs to. See @ref LPTIARTIA_Const.
+    AD5940_TemperatureCalibration temperature;  // Temperature sensor calibration.
+    uint32_t timestamp;                         // Time of the calibration (in seconds), in the time base of the caller.
+    float die_temperature;                      // Die temperature during the calibration (in degrees Celsius).
+}
+AD5940_CalibrationRecord;
+
+/**
+ * When a stored calibration record may still be used instead of calibrating again.
+ */
+typedef struct
+{
+    uint32_t max_age;                   // Maximum age of the record (in seconds), 0 for no limit.
+    float max_temperature_drift;        // Maximum difference to the calibration die temperature (in degrees Celsius), 0 for no limit.
+}
+AD5940_CalibrationPolicy;
+
+/**
+ * Computes the CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) of a buffer.
+ *
+ * @param data                  Data to protect.
+ * @param length                Number of bytes.
+ *
+ * @return uint32_t CRC-32 of the data.
+ */
+uint32_t AD5940_crc32(
+    const uint8_t *const data,
+    const uint32_t length
+);
+
+/**
+ * Serializes a calibration record for non-volatile storage.
+ * The layout is little endian and independent of the compiler, with a version and a CRC-32.
+ *
+ * @param record                Calibration record.
+ * @param buffer                Buffer to store the serialized record.
+ * @param buffer_length         Length of the buffer, at least @ref AD5940_CALIBRATION_RECORD_SIZE.
+ * @param length                Pointer to store the number of bytes written.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation.
+ */
+AD5940Err AD5940_serialize_calibration_record(
+    const AD5940_CalibrationRecord *const record,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+);
+
+/**
+ * Deserializes a calibration record read back from non-volatile storage.
+ *
+ * @param buffer                Serialized record.
+ * @param length                Number of bytes in the buffer.
+ * @param record                Pointer to store the calibration record.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the buffer is too short.
+ *                   - AD5940ERR_PARA if the record is erased, of another version, or corrupted.
+ */
+AD5940Err AD5940_deserialize_calibration_record(
+    const uint8_t *const buffer,
+    const uint32_t length,
+    AD5940_CalibrationRecord *const record
+);
+
+/**
+ * Tells whether a calibration record may be used instead of calibrating again.
+ *
+ * @param record                Calibration record, from @ref AD5940_deserialize_calibration_record.
+ * @param policy                Validity policy.
+ * @param now                   Current time (in seconds), in the time base of record->timestamp.
+ * @param die_temperature       Current die temperature (in degrees Celsius).
+ *
+ * @return BoolFlag bTRUE if the record is recent enough and close enough to the current temperature.
+ */
+BoolFlag AD5940_is_calibration_record_valid(
+    const AD5940_CalibrationRecord *const record,
+    const AD5940_CalibrationPolicy *const policy,
+    const uint32_t now,
+    const float die_temperature
+);
+
+#ifdef __cplusplus
+}
+#endif
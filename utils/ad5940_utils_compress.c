@@ -0,0 +1,236 @@
+#include "ad5940_utils_compress.h"
+
+#define BLOCK_HEADER_SIZE 3                 // Flags and number of words.
+#define BLOCK_FLAG_RAW 0x01u                // Words stored as read, the coded block would not be smaller.
+#define BLOCK_FLAG_RESET 0x02u              // State restarted before the block.
+#define WORD_ESCAPE 0x04u                   // Token flag, the ECC and channel ID follow the token.
+#define VARINT_SIZE_MAX 3                   // 16-bit zigzag code, escape flag and sequence ID.
+
+static uint16_t _get_tag(
+    const uint32_t word
+)
+{
+    return (uint16_t)(((word >> 25) << 7) | ((word >> 16) & 0x7F));
+}
+
+static void _reset(
+    AD5940_COMPRESS_STATE *const state
+)
+{
+    for(uint8_t i=0; i<4; i++)
+    {
+        state->previous_data[i] = 0;
+        state->previous_tag[i] = 0;
+    }
+}
+
+/**
+ * Advances the state over a word, as the decoder does.
+ */
+static void _update(
+    AD5940_COMPRESS_STATE *const state,
+    const uint32_t word
+)
+{
+    const uint8_t seqid = (uint8_t)((word >> 23) & 0x3);
+    state->previous_data[seqid] = (uint16_t)(word & AD5940_COMPRESS_DATA_MASK);
+    state->previous_tag[seqid] = _get_tag(word);
+}
+
+static void _write_raw(
+    AD5940_COMPRESS_STATE *const state,
+    const uint32_t *const fifo_data,
+    const uint32_t word_number,
+    uint8_t *buffer
+)
+{
+    for(uint32_t i=0; i<word_number; i++)
+    {
+        const uint32_t word = (state->keep_ecc == bTRUE) ? fifo_data[i] : (fifo_data[i] & ~AD5940_COMPRESS_ECC_MASK);
+        buffer[0] = (uint8_t)(word);
+        buffer[1] = (uint8_t)(word >> 8);
+        buffer[2] = (uint8_t)(word >> 16);
+        buffer[3] = (uint8_t)(word >> 24);
+        buffer += 4;
+        _update(state, word);
+    }
+}
+
+void AD5940_COMPRESS_init(
+    AD5940_COMPRESS_STATE *const state,
+    const BoolFlag keep_ecc
+)
+{
+    state->keep_ecc = keep_ecc;
+    state->reset = bTRUE;
+    _reset(state);
+}
+
+AD5940Err AD5940_compress_fifo(
+    AD5940_COMPRESS_STATE *const state,
+    const uint32_t *const fifo_data,
+    const uint32_t word_number,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+)
+{
+    if(word_number > AD5940_COMPRESS_WORD_NUMBER_MAX) return AD5940ERR_PARA;
+    if(buffer_length < BLOCK_HEADER_SIZE) return AD5940ERR_BUFF;
+
+    /* Kept to roll back, the coded block is given up as soon as it outgrows the raw one */
+    const AD5940_COMPRESS_STATE previous = *state;
+    const uint32_t raw_length = AD5940_COMPRESS_BOUND(word_number);
+    const uint32_t limit = (raw_length < buffer_length) ? raw_length : buffer_length;
+    uint8_t flags = (state->reset == bTRUE) ? BLOCK_FLAG_RESET : 0;
+    uint32_t offset = BLOCK_HEADER_SIZE;
+
+    for(uint32_t i=0; i<word_number; i++)
+    {
+        const uint32_t word = (state->keep_ecc == bTRUE) ? fifo_data[i] : (fifo_data[i] & ~AD5940_COMPRESS_ECC_MASK);
+        const uint8_t seqid = (uint8_t)((word >> 23) & 0x3);
+        const uint16_t tag = _get_tag(word);
+        const uint16_t delta = (uint16_t)((word & AD5940_COMPRESS_DATA_MASK) - state->previous_data[seqid]);
+
+        /* Zigzag, small negative differences become small codes too */
+        const uint32_t zigzag = (delta & 0x8000) ? (((uint32_t)(uint16_t)~delta << 1) | 1) : ((uint32_t) delta << 1);
+        const BoolFlag escape = (tag != state->previous_tag[seqid]) ? bTRUE : bFALSE;
+        uint32_t token = (zigzag << 3) | ((escape == bTRUE) ? WORD_ESCAPE : 0) | seqid;
+
+        const uint32_t size = ((token < 0x80) ? 1 : ((token < 0x4000) ? 2 : VARINT_SIZE_MAX)) + ((escape == bTRUE) ? 2 : 0);
+        if(offset + size > limit)
+        {
+            offset = limit + 1;
+            break;
+        }
+        while(token >= 0x80)
+        {
+            buffer[offset++] = (uint8_t)(token | 0x80);
+            token >>= 7;
+        }
+        buffer[offset++] = (uint8_t) token;
+        if(escape == bTRUE)
+        {
+            buffer[offset++] = (uint8_t)(tag);
+            buffer[offset++] = (uint8_t)(tag >> 8);
+        }
+        _update(state, word);
+    }
+
+    if(offset > limit)
+    {
+        *state = previous;
+        if(raw_length > buffer_length) return AD5940ERR_BUFF;
+
+        flags |= BLOCK_FLAG_RAW;
+        _write_raw(state, fifo_data, word_number, buffer + BLOCK_HEADER_SIZE);
+        offset = raw_length;
+    }
+
+    buffer[0] = flags;
+    buffer[1] = (uint8_t)(word_number);
+    buffer[2] = (uint8_t)(word_number >> 8);
+    state->reset = bFALSE;
+    *length = offset;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_decompress_fifo(
+    AD5940_COMPRESS_STATE *const state,
+    const uint8_t *const buffer,
+    const uint32_t length,
+    uint32_t *const fifo_data,
+    const uint32_t fifo_max_length,
+    uint32_t *const word_number
+)
+{
+    if(length < BLOCK_HEADER_SIZE) return AD5940ERR_PARA;
+
+    const uint8_t flags = buffer[0];
+    const uint32_t number = (uint32_t) buffer[1] | ((uint32_t) buffer[2] << 8);
+    if(flags & ~(BLOCK_FLAG_RAW | BLOCK_FLAG_RESET)) return AD5940ERR_PARA;
+    if(number > fifo_max_length) return AD5940ERR_BUFF;
+
+    /* Without a reset, the block continues a stream the state must have decoded so far */
+    if((flags & BLOCK_FLAG_RESET) == 0 && (state->reset == bTRUE)) return AD5940ERR_PARA;
+
+    const AD5940_COMPRESS_STATE previous = *state;
+    if(flags & BLOCK_FLAG_RESET) _reset(state);
+
+    uint32_t offset = BLOCK_HEADER_SIZE;
+    if(flags & BLOCK_FLAG_RAW)
+    {
+        if(length != AD5940_COMPRESS_BOUND(number))
+        {
+            *state = previous;
+            return AD5940ERR_PARA;
+        }
+        for(uint32_t i=0; i<number; i++)
+        {
+            const uint8_t *word = buffer + offset + 4 * i;
+            fifo_data[i] = ((uint32_t) word[0])
+                | ((uint32_t) word[1] << 8)
+                | ((uint32_t) word[2] << 16)
+                | ((uint32_t) word[3] << 24);
+            _update(state, fifo_data[i]);
+        }
+        offset = length;
+    }
+    else
+    {
+        for(uint32_t i=0; i<number; i++)
+        {
+            uint32_t token = 0;
+            uint8_t shift = 0;
+            uint8_t byte = 0;
+            do
+            {
+                if((offset >= length) || (shift >= 7 * VARINT_SIZE_MAX)) break;
+                byte = buffer[offset++];
+                token |= (uint32_t)(byte & 0x7F) << shift;
+                shift += 7;
+            }
+            while(byte & 0x80);
+            if((byte & 0x80) || (shift == 0) || ((token >> 3) > 0xFFFF))
+            {
+                *state = previous;
+                return AD5940ERR_PARA;
+            }
+
+            const uint8_t seqid = (uint8_t)(token & 0x3);
+            const uint32_t zigzag = token >> 3;
+            const uint16_t delta = (zigzag & 1) ? (uint16_t)~(uint16_t)(zigzag >> 1) : (uint16_t)(zigzag >> 1);
+            const uint16_t data = (uint16_t)(state->previous_data[seqid] + delta);
+
+            uint16_t tag = state->previous_tag[seqid];
+            if(token & WORD_ESCAPE)
+            {
+                if((offset + 2 > length) || (buffer[offset + 1] >= 0x40))
+                {
+                    *state = previous;
+                    return AD5940ERR_PARA;
+                }
+                tag = (uint16_t)(buffer[offset] | (buffer[offset + 1] << 8));
+                offset += 2;
+            }
+
+            fifo_data[i] = ((uint32_t)(tag >> 7) << 25)
+                | ((uint32_t) seqid << 23)
+                | ((uint32_t)(tag & 0x7F) << 16)
+                | data;
+            _update(state, fifo_data[i]);
+        }
+    }
+
+    if(offset != length)
+    {
+        *state = previous;
+        return AD5940ERR_PARA;
+    }
+
+    state->reset = bFALSE;
+    *word_number = number;
+
+    return AD5940ERR_OK;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+
+/**
+ * Largest size of a compressed block of n FIFO words (in bytes): the block header, then at most
+ * the FIFO words themselves, as a block that would grow is stored raw.
+ */
+#define AD5940_COMPRESS_BOUND(n) (3 + 4 * (uint32_t)(n))
+
+/**
+ * Largest number of FIFO words in one compressed block.
+ */
+#define AD5940_COMPRESS_WORD_NUMBER_MAX 0xFFFF
+
+/**
+ * Bits of a FIFO word, refer to datasheet page 108:
+ * ECC [31:25], sequence ID [24:23], channel ID [22:16], data [15:0].
+ */
+#define AD5940_COMPRESS_ECC_MASK 0xFE000000u
+#define AD5940_COMPRESS_DATA_MASK 0x0000FFFFu
+
+/**
+ * Compressor or decompressor state of a stream of FIFO blocks, constant size.
+ *
+ * Each FIFO word is coded as the difference of its data to the previous data of the same
+ * sequence ID, so the temperature captures interleaved with the current captures do not
+ * break the runs of small differences. The difference is zigzag coded with the sequence ID
+ * and stored as a varint: differences up to +-7 LSB take 1 byte, up to +-1023 LSB 2 bytes.
+ * The channel ID and the ECC are only stored when they change for the sequence ID.
+ */
+typedef struct
+{
+    BoolFlag keep_ecc;                  // bFALSE to strip the ECC bits, they are read back as zero.
+    BoolFlag reset;                     // bTRUE until the first block after init, which restarts the decoder.
+    uint16_t previous_data[4];          // Last data per sequence ID.
+    uint16_t previous_tag[4];           // Last ECC and channel ID per sequence ID.
+}
+AD5940_COMPRESS_STATE;
+
+/**
+ * Starts a stream of compressed blocks. The decoder state only needs this init,
+ * the first block restarts it.
+ *
+ * @param state                 Compressor or decompressor state.
+ * @param keep_ecc              bTRUE to keep the ECC bits of the FIFO words.
+ */
+void AD5940_COMPRESS_init(
+    AD5940_COMPRESS_STATE *const state,
+    const BoolFlag keep_ecc
+);
+
+/**
+ * Compresses a block of FIFO words, e.g. right after @ref AD5940_irq_handler.
+ * The blocks of a stream must be decompressed in order, call @ref AD5940_COMPRESS_init
+ * again to start a block that can be decompressed on its own.
+ *
+ * @param state                 Compressor state.
+ * @param fifo_data             FIFO words.
+ * @param word_number           Number of FIFO words, up to @ref AD5940_COMPRESS_WORD_NUMBER_MAX.
+ * @param buffer                Buffer to store the block. It may not overlap fifo_data.
+ * @param buffer_length         Length of the buffer, @ref AD5940_COMPRESS_BOUND always fits.
+ * @param length                Pointer to store the number of bytes written.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the block does not fit in the buffer, the state is unchanged.
+ *                   - AD5940ERR_PARA if there are too many FIFO words.
+ */
+AD5940Err AD5940_compress_fifo(
+    AD5940_COMPRESS_STATE *const state,
+    const uint32_t *const fifo_data,
+    const uint32_t word_number,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+);
+
+/**
+ * Decompresses a block of FIFO words.
+ *
+ * @param state                 Decompressor state.
+ * @param buffer                Compressed block.
+ * @param length                Number of bytes of the block.
+ * @param fifo_data             Buffer to store the FIFO words.
+ * @param fifo_max_length       Length of the FIFO buffer (in words).
+ * @param word_number           Pointer to store the number of FIFO words.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the words do not fit in the FIFO buffer.
+ *                   - AD5940ERR_PARA if the block is corrupted, or continues a stream the state did not decode.
+ */
+AD5940Err AD5940_decompress_fifo(
+    AD5940_COMPRESS_STATE *const state,
+    const uint8_t *const buffer,
+    const uint32_t length,
+    uint32_t *const fifo_data,
+    const uint32_t fifo_max_length,
+    uint32_t *const word_number
+);
+
+#ifdef __cplusplus
+}
+#endif
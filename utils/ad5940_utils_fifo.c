@@ -1,5 +1,7 @@
 #include "ad5940_utils_fifo.h"
 
+#include <string.h>
+
 void AD5940_reset_fifocon(void)
 {
     uint32_t fifocon = 0;
@@ -7,3 +9,95 @@ void AD5940_reset_fifocon(void)
     AD5940_WriteReg(REG_AFE_FIFOCON, 0);        /* Disable FIFO before changing memory configuration */
     AD5940_WriteReg(REG_AFE_FIFOCON, fifocon);  /* restore FIFO configuration */
 }
+
+#define SEQ_2KB_LENGTH 512      // Sequence commands (or FIFO words) in 2kB.
+
+AD5940Err AD5940_get_sram_partition(
+    const AD5940_SRAM_PARTITION partition,
+    const uint32_t sequence_length,
+    const uint32_t FifoThresh,
+    uint32_t *const SeqMemSize,
+    uint32_t *const FIFOSize
+)
+{
+    uint32_t sequence_capacity;
+    uint32_t fifo_capacity;
+
+    switch (partition)
+    {
+    case AD5940_SRAM_PARTITION_AUTO:
+        if(sequence_length > SEQ_2KB_LENGTH)
+        {
+            *SeqMemSize = SEQMEMSIZE_4KB;
+            *FIFOSize = FIFOSIZE_2KB;
+            sequence_capacity = AD5940_SRAM_SEQUENCE_LENGTH_MAX;
+            fifo_capacity = SEQ_2KB_LENGTH;
+        }
+        else
+        {
+            *SeqMemSize = SEQMEMSIZE_2KB;
+            *FIFOSize = FIFOSIZE_4KB;
+            sequence_capacity = SEQ_2KB_LENGTH;
+            fifo_capacity = 2 * SEQ_2KB_LENGTH;
+        }
+        break;
+
+    case AD5940_SRAM_PARTITION_SEQ2K_FIFO4K:
+        *SeqMemSize = SEQMEMSIZE_2KB;
+        *FIFOSize = FIFOSIZE_4KB;
+        sequence_capacity = SEQ_2KB_LENGTH;
+        fifo_capacity = 2 * SEQ_2KB_LENGTH;
+        break;
+
+    case AD5940_SRAM_PARTITION_SEQ4K_FIFO2K:
+        *SeqMemSize = SEQMEMSIZE_4KB;
+        *FIFOSize = FIFOSIZE_2KB;
+        sequence_capacity = AD5940_SRAM_SEQUENCE_LENGTH_MAX;
+        fifo_capacity = SEQ_2KB_LENGTH;
+        break;
+
+    default:
+        return AD5940ERR_PARA;
+    }
+
+    if(sequence_length > sequence_capacity) return AD5940ERR_SEQLEN;
+    if(FifoThresh > fifo_capacity) return AD5940ERR_PARA;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_configure_sram(
+    const AD5940_SRAM_PARTITION partition,
+    const uint32_t sequence_length,
+    const uint32_t FifoThresh,
+    const SEQCfg_Type *const seq_cfg
+)
+{
+    AD5940Err error = AD5940ERR_OK;
+
+    uint32_t SeqMemSize;
+    uint32_t FIFOSize;
+    error = AD5940_get_sram_partition(
+        partition,
+        sequence_length,
+        FifoThresh,
+        &SeqMemSize,
+        &FIFOSize
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    SEQCfg_Type sram_seq_cfg;
+    memcpy(&sram_seq_cfg, seq_cfg, sizeof(SEQCfg_Type));
+    sram_seq_cfg.SeqMemSize = SeqMemSize;  /* SRAM used for sequencer, others for data FIFO */
+    sram_seq_cfg.SeqEnable = bFALSE;
+    AD5940_SEQCfg(&sram_seq_cfg);
+
+    FIFOCfg_Type fifo_cfg;
+    memset(&fifo_cfg, 0, sizeof(FIFOCfg_Type));
+    fifo_cfg.FIFOEn = bFALSE;
+    fifo_cfg.FIFOMode = FIFOMODE_FIFO;
+    fifo_cfg.FIFOSize = FIFOSize;
+    AD5940_FIFOCfg(&fifo_cfg);
+
+    return AD5940ERR_OK;
+}
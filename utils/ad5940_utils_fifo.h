@@ -13,6 +13,74 @@ extern "C"
  */
 void AD5940_reset_fifocon(void);
 
+/**
+ * FIFO error interrupt sources, enabled next to the FIFO threshold by the techniques.
+ * An overflow then raises the interrupt GPIO instead of stopping the sequencer silently,
+ * and leaves its flag for @ref AD5940_irq_handler_monitor.
+ */
+#define AD5940_FIFO_ERROR_INTSRC (AFEINTSRC_DATAFIFOOF | AFEINTSRC_DATAFIFOUF)
+
+/**
+ * Number of sequence commands that fit in the largest sequencer memory (4kB).
+ */
+#define AD5940_SRAM_SEQUENCE_LENGTH_MAX 1024
+
+/**
+ * Split of the 6kB SRAM between the sequencer commands and the data FIFO.
+ * Refer to datasheet page 105.
+ */
+typedef enum
+{
+    AD5940_SRAM_PARTITION_AUTO = 0,         /**< Smallest sequencer memory that holds the program, the data FIFO gets the rest. */
+    AD5940_SRAM_PARTITION_SEQ2K_FIFO4K,     /**< 512 sequence commands, 1024 FIFO words. */
+    AD5940_SRAM_PARTITION_SEQ4K_FIFO2K,     /**< 1024 sequence commands, 512 FIFO words. */
+}
+AD5940_SRAM_PARTITION;
+
+/**
+ * Gets the sequencer memory and data FIFO sizes of a partition, without any SPI access.
+ * Also usable as a dry run to check that a program and a FIFO burst fit before uploading anything.
+ * 
+ * @param partition         Requested partition.
+ * @param sequence_length   Number of sequence commands of the program, i.e. the end of the last sequence in SRAM.
+ * @param FifoThresh        Largest number of FIFO words expected before the MCU reads the FIFO.
+ * @param SeqMemSize        Pointer to store the sequencer memory size. See @ref SEQMEMSIZE_Const.
+ * @param FIFOSize          Pointer to store the data FIFO size. See @ref FIFOSIZE_Const.
+ * 
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_SEQLEN if the program does not fit the sequencer memory.
+ *                   - AD5940ERR_PARA if the burst does not fit the data FIFO.
+ */
+AD5940Err AD5940_get_sram_partition(
+    const AD5940_SRAM_PARTITION partition,
+    const uint32_t sequence_length,
+    const uint32_t FifoThresh,
+    uint32_t *const SeqMemSize,
+    uint32_t *const FIFOSize
+);
+
+/**
+ * Splits SRAM between the written sequences and the data FIFO, right before a run.
+ * The sequences are written with 4kB of sequencer memory, this function then gives the SRAM
+ * not used by the sequences to the data FIFO, refer to @ref AD5940_get_sram_partition.
+ * The sequencer memory starts at address 0, so the sequences written below `sequence_length` are kept.
+ * The sequencer and the data FIFO are left disabled.
+ * 
+ * @param partition         Requested partition.
+ * @param sequence_length   End of the last sequence in SRAM (in sequence commands).
+ * @param FifoThresh        Largest number of FIFO words expected before the MCU reads the FIFO.
+ * @param seq_cfg           Sequencer configuration of the technique, its SeqMemSize and SeqEnable are ignored.
+ * 
+ * @return AD5940Err Error code indicating the success or failure of the operation,
+ *                   nothing is written on failure.
+ */
+AD5940Err AD5940_configure_sram(
+    const AD5940_SRAM_PARTITION partition,
+    const uint32_t sequence_length,
+    const uint32_t FifoThresh,
+    const SEQCfg_Type *const seq_cfg
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,149 @@
+/* clock_gettime is POSIX, hidden by a strict -std=c99 without a feature test macro */
+#if defined(__linux__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "ad5940_utils_metrics.h"
+
+#include <string.h>
+
+#if defined(__linux__)
+#include <time.h>
+#endif
+
+static AD5940_METRICS *_metrics = NULL;
+
+static uint8_t _get_bin(
+    uint32_t duration
+)
+{
+    // Number of significant bits, so bin i holds [2^(i-1), 2^i).
+    uint8_t bin = 0;
+    while(duration != 0)
+    {
+        duration >>= 1;
+        bin++;
+    }
+    return (bin < AD5940_METRICS_HISTOGRAM_BIN_NUMBER) ? bin : (AD5940_METRICS_HISTOGRAM_BIN_NUMBER - 1);
+}
+
+void AD5940_METRICS_init(
+    AD5940_METRICS *const metrics,
+    uint32_t (*get_time)(void)
+)
+{
+    memset(metrics, 0, sizeof(AD5940_METRICS));
+    metrics->get_time = get_time;
+    for(uint8_t i=0; i<AD5940_METRICS_PHASE_NUMBER; i++)
+    {
+        metrics->latency[i].min = UINT32_MAX;
+    }
+}
+
+void AD5940_METRICS_bind(
+    AD5940_METRICS *const metrics
+)
+{
+    _metrics = metrics;
+}
+
+uint32_t AD5940_METRICS_get_time(void)
+{
+    if((_metrics == NULL) || (_metrics->get_time == NULL)) return 0;
+    return _metrics->get_time();
+}
+
+void AD5940_METRICS_record(
+    const AD5940_METRICS_PHASE phase,
+    const uint32_t begin
+)
+{
+    if((_metrics == NULL) || (_metrics->get_time == NULL)) return;
+    if(phase >= AD5940_METRICS_PHASE_NUMBER) return;
+
+    const uint32_t duration = _metrics->get_time() - begin;     /* Unsigned, right across one wrap around */
+    AD5940_METRICS_LATENCY *const latency = &_metrics->latency[phase];
+
+    latency->count++;
+    latency->total += duration;
+    if(duration < latency->min) latency->min = duration;
+    if(duration > latency->max) latency->max = duration;
+    latency->histogram[_get_bin(duration)]++;
+}
+
+void AD5940_METRICS_record_wakeup(
+    const uint32_t try_number,
+    const uint32_t try_max
+)
+{
+    if(_metrics == NULL) return;
+
+    _metrics->wakeup_count++;
+    _metrics->wakeup_try_count += try_number;
+    if(try_number > _metrics->wakeup_try_max) _metrics->wakeup_try_max = try_number;
+    if(try_number > try_max) _metrics->wakeup_failure_count++;
+}
+
+void AD5940_METRICS_record_irq(
+    const uint32_t fifo_word_number,
+    const AD5940Err error
+)
+{
+    if(_metrics == NULL) return;
+
+    _metrics->irq_count++;
+    _metrics->fifo_word_count += fifo_word_number;
+    if(error != AD5940ERR_OK) _metrics->irq_error_count++;
+}
+
+uint32_t AD5940_METRICS_get_percentile(
+    const AD5940_METRICS_LATENCY *const latency,
+    const uint8_t percent
+)
+{
+    if(latency->count == 0) return 0;
+
+    const uint64_t rank = ((uint64_t) latency->count * ((percent < 100) ? percent : 100) + 99) / 100;
+    uint64_t cumulated = 0;
+    uint32_t bound = latency->max;
+    for(uint8_t i=0; i<AD5940_METRICS_HISTOGRAM_BIN_NUMBER; i++)
+    {
+        cumulated += latency->histogram[i];
+        if((cumulated >= rank) && (cumulated > 0))
+        {
+            bound = (i == 0) ? 0 : (uint32_t)((1ull << i) - 1);
+            break;
+        }
+    }
+
+    return (bound < latency->max) ? bound : latency->max;
+}
+
+#if defined(__linux__)
+uint32_t AD5940_METRICS_get_time_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t) now.tv_sec * 1000000u + (uint64_t) now.tv_nsec / 1000u);
+}
+#endif
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+#define DWT_CTRL (*(volatile uint32_t *)0xE0001000u)
+#define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004u)
+#define DEMCR (*(volatile uint32_t *)0xE000EDFCu)
+#define DEMCR_TRCENA (1u << 24)
+#define DWT_CTRL_CYCCNTENA (1u << 0)
+
+void AD5940_METRICS_init_dwt(void)
+{
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+uint32_t AD5940_METRICS_get_time_dwt(void)
+{
+    return DWT_CYCCNT;
+}
+#endif
@@ -0,0 +1,182 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+
+/**
+ * Latency and throughput counters of the interrupt path and of the `*_start` functions.
+ *
+ * The hooks are compiled out unless AD5940_METRICS_ENABLE is defined. Once enabled, they record
+ * into the metrics bound by @ref AD5940_METRICS_bind, and do nothing while none is bound.
+ * The times are in ticks of the time source of the metrics: @ref AD5940_METRICS_get_time_us
+ * on a Linux host, @ref AD5940_METRICS_get_time_dwt (CPU cycles) on a Cortex-M3/M4/M7/M33,
+ * or any free running counter of the platform.
+ */
+
+/**
+ * Number of bins of a latency histogram. Bin 0 counts the zero durations,
+ * bin i the durations in [2^(i-1), 2^i) ticks, the last bin everything longer.
+ */
+#define AD5940_METRICS_HISTOGRAM_BIN_NUMBER 24
+
+/**
+ * Measured phases. The IRQ phases split @ref AD5940_irq_handler, the START phases split
+ * the incremental start of the waveform techniques, one upload step at a time.
+ */
+typedef enum
+{
+    AD5940_METRICS_PHASE_IRQ = 0,               // Whole AD5940_irq_handler.
+    AD5940_METRICS_PHASE_IRQ_WAKEUP,            // AD5940_WakeUp, see wakeup_try_count for the reads it took.
+    AD5940_METRICS_PHASE_IRQ_FIFO_COUNT,        // AD5940_FIFOGetCnt.
+    AD5940_METRICS_PHASE_IRQ_FIFO_READ,         // AD5940_FIFORd, see fifo_word_count.
+    AD5940_METRICS_PHASE_IRQ_EPILOGUE,          // Flag clear, then FIFO threshold or shutdown.
+    AD5940_METRICS_PHASE_START,                 // Whole *_start or *_reconfigure of a technique.
+    AD5940_METRICS_PHASE_START_CONFIG,          // Path configuration, ADC and temperature sequences.
+    AD5940_METRICS_PHASE_START_UPLOAD,          // One upload step of the DAC sequences.
+    AD5940_METRICS_PHASE_START_RUN,             // SRAM partition, interrupt and wakeup timer.
+    AD5940_METRICS_PHASE_NUMBER,
+}
+AD5940_METRICS_PHASE;
+
+typedef struct
+{
+    uint32_t count;                                         // Number of measurements.
+    uint32_t total;                                         // Sum of the durations, wraps around.
+    uint32_t min;                                           // Shortest duration, UINT32_MAX before the first one.
+    uint32_t max;                                           // Longest duration.
+    uint32_t histogram[AD5940_METRICS_HISTOGRAM_BIN_NUMBER];    // Durations by power of two.
+}
+AD5940_METRICS_LATENCY;
+
+typedef struct
+{
+    uint32_t (*get_time)(void);                             // Free running tick counter, wraps around.
+    AD5940_METRICS_LATENCY latency[AD5940_METRICS_PHASE_NUMBER];    // Durations of each phase.
+
+    uint32_t irq_count;                                     // Number of interrupts served.
+    uint32_t irq_error_count;                               // Interrupts that returned an error.
+    uint32_t fifo_word_count;                               // FIFO words read, wraps around.
+    uint32_t wakeup_count;                                  // Wakeups in the interrupt path.
+    uint32_t wakeup_try_count;                              // Register reads they took, 1 per wakeup without retry.
+    uint32_t wakeup_try_max;                                // Most reads taken by one wakeup.
+    uint32_t wakeup_failure_count;                          // Wakeups that failed.
+}
+AD5940_METRICS;
+
+/**
+ * Clears the metrics.
+ *
+ * @param metrics               Metrics to clear.
+ * @param get_time              Free running tick counter, e.g. @ref AD5940_METRICS_get_time_us.
+ */
+void AD5940_METRICS_init(
+    AD5940_METRICS *const metrics,
+    uint32_t (*get_time)(void)
+);
+
+/**
+ * Selects the metrics recorded by the hooks. With several devices, attach them with
+ * `AD5940_DEVICE_enable_metrics` instead, selecting a device binds its metrics.
+ *
+ * @param metrics               Initialized metrics, or NULL to stop recording.
+ */
+void AD5940_METRICS_bind(
+    AD5940_METRICS *const metrics
+);
+
+/**
+ * Reads the time source of the bound metrics.
+ *
+ * @return uint32_t Ticks, or 0 while no metrics is bound.
+ */
+uint32_t AD5940_METRICS_get_time(void);
+
+/**
+ * Adds the duration of a phase to the bound metrics.
+ *
+ * @param phase                 Measured phase.
+ * @param begin                 Time at the start of the phase, from @ref AD5940_METRICS_get_time.
+ */
+void AD5940_METRICS_record(
+    const AD5940_METRICS_PHASE phase,
+    const uint32_t begin
+);
+
+/**
+ * Adds a wakeup to the bound metrics.
+ *
+ * @param try_number            Value returned by AD5940_WakeUp.
+ * @param try_max               Most reads allowed to AD5940_WakeUp, more means it failed.
+ */
+void AD5940_METRICS_record_wakeup(
+    const uint32_t try_number,
+    const uint32_t try_max
+);
+
+/**
+ * Adds a served interrupt to the bound metrics.
+ *
+ * @param fifo_word_number      FIFO words read by the interrupt.
+ * @param error                 Error returned by the interrupt.
+ */
+void AD5940_METRICS_record_irq(
+    const uint32_t fifo_word_number,
+    const AD5940Err error
+);
+
+/**
+ * Estimates a percentile of a latency from its histogram.
+ *
+ * @param latency               Latency of a phase.
+ * @param percent               Percentile, 0 to 100, e.g. 99.
+ *
+ * @return uint32_t Upper bound of the histogram bin holding the percentile (in ticks),
+ *                  capped by the longest duration. 0 without any measurement.
+ */
+uint32_t AD5940_METRICS_get_percentile(
+    const AD5940_METRICS_LATENCY *const latency,
+    const uint8_t percent
+);
+
+#if defined(__linux__)
+/**
+ * Time source of a Linux host: the monotonic clock in microseconds.
+ */
+uint32_t AD5940_METRICS_get_time_us(void);
+#endif
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+/**
+ * Starts the cycle counter of the Data Watchpoint and Trace unit, once before recording.
+ * Not available on Cortex-M0/M0+/M23.
+ */
+void AD5940_METRICS_init_dwt(void);
+
+/**
+ * Time source of a Cortex-M: the DWT cycle counter, in CPU cycles.
+ */
+uint32_t AD5940_METRICS_get_time_dwt(void);
+#endif
+
+/**
+ * Hooks placed in the interrupt path and the `*_start` functions, compiled out by default.
+ */
+#ifdef AD5940_METRICS_ENABLE
+#define AD5940_METRICS_BEGIN(name) const uint32_t name = AD5940_METRICS_get_time()
+#define AD5940_METRICS_END(phase, name) AD5940_METRICS_record(phase, name)
+#define AD5940_METRICS_WAKEUP(try_number, try_max) AD5940_METRICS_record_wakeup(try_number, try_max)
+#define AD5940_METRICS_IRQ(fifo_word_number, error) AD5940_METRICS_record_irq(fifo_word_number, error)
+#else
+#define AD5940_METRICS_BEGIN(name)
+#define AD5940_METRICS_END(phase, name)
+#define AD5940_METRICS_WAKEUP(try_number, try_max)
+#define AD5940_METRICS_IRQ(fifo_word_number, error)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,7 @@
 #include "ad5940_utils_power.h"
 
+#include "ad5940_electrochemical_utils_reconfigure.h"
+
 AD5940Err AD5940_set_active_power(
     const uint32_t AFEPWR_Const,
     const uint32_t CLKSEL,
@@ -42,6 +44,9 @@ AD5940Err AD5940_set_active_power(
  */
 AD5940Err AD5940_shutdown_afe_lploop_hsloop_dsp(void)
 {
+    /* The blocks are powered down, the next start writes every block and sequence again */
+    AD5940_ELECTROCHEMICAL_RECONFIGURE_invalidate();
+
     /* Wakeup AFE by read register, read 10 times at most */
     if(AD5940_WakeUp(10) > 10) return AD5940ERR_WAKEUP;  /* Wakeup Failed */
 
@@ -0,0 +1,373 @@
+#include "ad5940_utils_stream.h"
+
+#include <string.h>
+
+#define STREAM_SYNC_0 0xADu                 // Sync word, tells a frame start from the middle of a frame.
+#define STREAM_SYNC_1 0x59u
+#define RUN_FIXED_SIZE 36                   // Run header fields before the parameters.
+#define SAMPLES_FIXED_SIZE 4                // Index of the first sample.
+#define PACKED_FIXED_SIZE 8                 // Index of the first sample and block length.
+#define END_SIZE 8                          // Sample count and status.
+
+static void _put_u32(
+    uint8_t *const buffer,
+    const uint32_t value
+)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+    buffer[2] = (uint8_t)(value >> 16);
+    buffer[3] = (uint8_t)(value >> 24);
+}
+
+static void _put_float(
+    uint8_t *const buffer,
+    const float value
+)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    _put_u32(buffer, bits);
+}
+
+/**
+ * Writes the header and the CRC around a payload already in place after the header.
+ */
+static AD5940Err _close_frame(
+    AD5940_STREAM_ENCODER *const encoder,
+    const AD5940_STREAM_FRAME_TYPE type,
+    const uint32_t payload_length,
+    uint8_t *const buffer,
+    uint32_t *const length
+)
+{
+    buffer[0] = STREAM_SYNC_0;
+    buffer[1] = STREAM_SYNC_1;
+    buffer[2] = AD5940_STREAM_VERSION;
+    buffer[3] = (uint8_t) type;
+    buffer[4] = (uint8_t)(payload_length);
+    buffer[5] = (uint8_t)(payload_length >> 8);
+    buffer[6] = (uint8_t)(encoder->sequence);
+    buffer[7] = (uint8_t)(encoder->sequence >> 8);
+
+    _put_u32(
+        buffer + AD5940_STREAM_HEADER_SIZE + payload_length,
+        AD5940_crc32(buffer, AD5940_STREAM_HEADER_SIZE + payload_length)
+    );
+
+    encoder->sequence++;
+    *length = AD5940_STREAM_HEADER_SIZE + payload_length + AD5940_STREAM_CRC_SIZE;
+
+    return AD5940ERR_OK;
+}
+
+void AD5940_STREAM_ENCODER_init(
+    AD5940_STREAM_ENCODER *const encoder
+)
+{
+    encoder->sequence = 0;
+    encoder->sample_index = 0;
+}
+
+AD5940Err AD5940_STREAM_write_run(
+    AD5940_STREAM_ENCODER *const encoder,
+    const AD5940_STREAM_RUN *const run,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+)
+{
+    AD5940Err error;
+
+    if(run->parameter_number > AD5940_STREAM_PARAMETER_NUMBER_MAX) return AD5940ERR_PARA;
+
+    const uint32_t calibration_length = (run->calibration != NULL) ? AD5940_CALIBRATION_RECORD_SIZE : 0;
+    const uint32_t payload_length = RUN_FIXED_SIZE + 4 * (uint32_t) run->parameter_number + calibration_length;
+    if(buffer_length < AD5940_STREAM_HEADER_SIZE + payload_length + AD5940_STREAM_CRC_SIZE) return AD5940ERR_BUFF;
+
+    uint8_t *payload = buffer + AD5940_STREAM_HEADER_SIZE;
+    _put_u32(payload + 0, (uint32_t) run->technique);
+    _put_u32(payload + 4, run->DataType);
+    _put_u32(payload + 8, run->ADCPga);
+    _put_float(payload + 12, run->VRef);
+    _put_float(payload + 16, run->rtia.Magnitude);
+    _put_float(payload + 20, run->rtia.Phase);
+    _put_u32(payload + 24, run->sampling_number);
+    _put_u32(payload + 28, run->parameter_number);
+    _put_u32(payload + 32, calibration_length);
+
+    payload += RUN_FIXED_SIZE;
+    for(uint8_t i=0; i<run->parameter_number; i++)
+    {
+        _put_float(payload, run->parameters[i]);
+        payload += 4;
+    }
+
+    if(run->calibration != NULL)
+    {
+        uint32_t record_length;
+        error = AD5940_serialize_calibration_record(run->calibration, payload, calibration_length, &record_length);
+        if(error != AD5940ERR_OK) return error;
+    }
+
+    encoder->sample_index = 0;
+
+    return _close_frame(encoder, AD5940_STREAM_FRAME_RUN, payload_length, buffer, length);
+}
+
+AD5940Err AD5940_STREAM_write_samples(
+    AD5940_STREAM_ENCODER *const encoder,
+    const uint32_t *const fifo_data,
+    const uint16_t sample_number,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+)
+{
+    if(sample_number > AD5940_STREAM_SAMPLE_NUMBER_MAX) return AD5940ERR_PARA;
+
+    const uint32_t payload_length = SAMPLES_FIXED_SIZE + 4 * (uint32_t) sample_number;
+    if(buffer_length < AD5940_STREAM_HEADER_SIZE + payload_length + AD5940_STREAM_CRC_SIZE) return AD5940ERR_BUFF;
+
+    uint8_t *payload = buffer + AD5940_STREAM_HEADER_SIZE;
+    _put_u32(payload, encoder->sample_index);
+    payload += SAMPLES_FIXED_SIZE;
+    for(uint16_t i=0; i<sample_number; i++)
+    {
+        _put_u32(payload, fifo_data[i]);
+        payload += 4;
+    }
+
+    encoder->sample_index += sample_number;
+
+    return _close_frame(encoder, AD5940_STREAM_FRAME_SAMPLES, payload_length, buffer, length);
+}
+
+AD5940Err AD5940_STREAM_write_packed_samples(
+    AD5940_STREAM_ENCODER *const encoder,
+    const uint32_t *const fifo_data,
+    const uint16_t sample_number,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+)
+{
+    AD5940Err error;
+    AD5940_COMPRESS_STATE state;
+    uint32_t block_length;
+
+    if(sample_number > AD5940_STREAM_PACKED_SAMPLE_NUMBER_MAX) return AD5940ERR_PARA;
+    if(buffer_length < AD5940_STREAM_HEADER_SIZE + PACKED_FIXED_SIZE + AD5940_STREAM_CRC_SIZE + 3 + AD5940_COMPRESS_BOUND(0)) return AD5940ERR_BUFF;
+
+    /* The block is compressed in place, the room for the padding and the CRC is kept */
+    uint8_t *payload = buffer + AD5940_STREAM_HEADER_SIZE;
+    AD5940_COMPRESS_init(&state, bFALSE);
+    error = AD5940_compress_fifo(
+        &state,
+        fifo_data,
+        sample_number,
+        payload + PACKED_FIXED_SIZE,
+        buffer_length - (AD5940_STREAM_HEADER_SIZE + PACKED_FIXED_SIZE + AD5940_STREAM_CRC_SIZE + 3),
+        &block_length
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    _put_u32(payload + 0, encoder->sample_index);
+    _put_u32(payload + 4, block_length);
+
+    uint32_t payload_length = PACKED_FIXED_SIZE + block_length;
+    while((payload_length % 4) != 0)
+    {
+        payload[payload_length++] = 0;
+    }
+
+    encoder->sample_index += sample_number;
+
+    return _close_frame(encoder, AD5940_STREAM_FRAME_SAMPLES_PACKED, payload_length, buffer, length);
+}
+
+void AD5940_STREAM_skip_samples(
+    AD5940_STREAM_ENCODER *const encoder,
+    const uint32_t sample_number
+)
+{
+    encoder->sample_index += sample_number;
+}
+
+AD5940Err AD5940_STREAM_write_end(
+    AD5940_STREAM_ENCODER *const encoder,
+    const AD5940Err status,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+)
+{
+    if(buffer_length < AD5940_STREAM_HEADER_SIZE + END_SIZE + AD5940_STREAM_CRC_SIZE) return AD5940ERR_BUFF;
+
+    uint8_t *payload = buffer + AD5940_STREAM_HEADER_SIZE;
+    _put_u32(payload + 0, encoder->sample_index);
+    _put_u32(payload + 4, (uint32_t) status);
+
+    return _close_frame(encoder, AD5940_STREAM_FRAME_END, END_SIZE, buffer, length);
+}
+
+AD5940Err AD5940_STREAM_read_frame(
+    const uint8_t *const stream,
+    const uint32_t length,
+    uint32_t *const offset,
+    AD5940_STREAM_FRAME *const frame
+)
+{
+    if((*offset + AD5940_STREAM_HEADER_SIZE) > length) return AD5940ERR_BUFF;
+
+    const uint8_t *header = stream + *offset;
+    if((header[0] != STREAM_SYNC_0) || (header[1] != STREAM_SYNC_1)) return AD5940ERR_PARA;
+    if(header[2] != AD5940_STREAM_VERSION) return AD5940ERR_PARA;
+
+    const uint16_t payload_length = (uint16_t)(header[4] | (header[5] << 8));
+    if((payload_length % 4) != 0) return AD5940ERR_PARA;
+    const uint32_t frame_length = AD5940_STREAM_HEADER_SIZE + payload_length + AD5940_STREAM_CRC_SIZE;
+    if((*offset + frame_length) > length) return AD5940ERR_BUFF;
+
+    const uint32_t crc = AD5940_STREAM_get_u32(header + AD5940_STREAM_HEADER_SIZE + payload_length, 0);
+    if(crc != AD5940_crc32(header, AD5940_STREAM_HEADER_SIZE + payload_length)) return AD5940ERR_PARA;
+
+    frame->type = (AD5940_STREAM_FRAME_TYPE) header[3];
+    frame->sequence = (uint16_t)(header[6] | (header[7] << 8));
+    frame->payload = header + AD5940_STREAM_HEADER_SIZE;
+    frame->payload_length = payload_length;
+
+    *offset += frame_length;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_STREAM_get_run(
+    const AD5940_STREAM_FRAME *const frame,
+    AD5940_STREAM_RUN_INFO *const run
+)
+{
+    if(frame->type != AD5940_STREAM_FRAME_RUN) return AD5940ERR_PARA;
+    if(frame->payload_length < RUN_FIXED_SIZE) return AD5940ERR_PARA;
+
+    const uint8_t *payload = frame->payload;
+    const uint32_t parameter_number = AD5940_STREAM_get_u32(payload, 7);
+    const uint32_t calibration_length = AD5940_STREAM_get_u32(payload, 8);
+    if(parameter_number > AD5940_STREAM_PARAMETER_NUMBER_MAX) return AD5940ERR_PARA;
+    if((calibration_length != 0) && (calibration_length != AD5940_CALIBRATION_RECORD_SIZE)) return AD5940ERR_PARA;
+    if(frame->payload_length != RUN_FIXED_SIZE + 4 * parameter_number + calibration_length) return AD5940ERR_PARA;
+
+    run->technique = (AD5940_STREAM_TECHNIQUE) AD5940_STREAM_get_u32(payload, 0);
+    run->DataType = AD5940_STREAM_get_u32(payload, 1);
+    run->ADCPga = AD5940_STREAM_get_u32(payload, 2);
+    run->VRef = AD5940_STREAM_get_float(payload, 3);
+    run->rtia.Magnitude = AD5940_STREAM_get_float(payload, 4);
+    run->rtia.Phase = AD5940_STREAM_get_float(payload, 5);
+    run->sampling_number = AD5940_STREAM_get_u32(payload, 6);
+    run->parameters = payload + RUN_FIXED_SIZE;
+    run->parameter_number = (uint8_t) parameter_number;
+
+    run->calibration_valid = bFALSE;
+    if(calibration_length != 0)
+    {
+        AD5940Err error = AD5940_deserialize_calibration_record(
+            payload + RUN_FIXED_SIZE + 4 * parameter_number,
+            calibration_length,
+            &run->calibration
+        );
+        if(error != AD5940ERR_OK) return AD5940ERR_PARA;
+        run->calibration_valid = bTRUE;
+    }
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_STREAM_get_samples(
+    const AD5940_STREAM_FRAME *const frame,
+    uint32_t *const first_index,
+    const uint8_t **const samples,
+    uint16_t *const sample_number
+)
+{
+    if(frame->type != AD5940_STREAM_FRAME_SAMPLES) return AD5940ERR_PARA;
+    if(frame->payload_length < SAMPLES_FIXED_SIZE) return AD5940ERR_PARA;
+
+    *first_index = AD5940_STREAM_get_u32(frame->payload, 0);
+    *samples = frame->payload + SAMPLES_FIXED_SIZE;
+    *sample_number = (uint16_t)((frame->payload_length - SAMPLES_FIXED_SIZE) / 4);
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_STREAM_get_packed_samples(
+    const AD5940_STREAM_FRAME *const frame,
+    uint32_t *const first_index,
+    uint32_t *const fifo_data,
+    const uint32_t fifo_max_length,
+    uint16_t *const sample_number
+)
+{
+    AD5940Err error;
+    AD5940_COMPRESS_STATE state;
+    uint32_t word_number;
+
+    if(frame->type != AD5940_STREAM_FRAME_SAMPLES_PACKED) return AD5940ERR_PARA;
+    if(frame->payload_length < PACKED_FIXED_SIZE) return AD5940ERR_PARA;
+
+    const uint32_t block_length = AD5940_STREAM_get_u32(frame->payload, 1);
+    if(block_length > (uint32_t)(frame->payload_length - PACKED_FIXED_SIZE)) return AD5940ERR_PARA;
+
+    AD5940_COMPRESS_init(&state, bFALSE);
+    error = AD5940_decompress_fifo(
+        &state,
+        frame->payload + PACKED_FIXED_SIZE,
+        block_length,
+        fifo_data,
+        fifo_max_length,
+        &word_number
+    );
+    if(error != AD5940ERR_OK) return error;
+
+    *first_index = AD5940_STREAM_get_u32(frame->payload, 0);
+    *sample_number = (uint16_t) word_number;
+
+    return AD5940ERR_OK;
+}
+
+AD5940Err AD5940_STREAM_get_end(
+    const AD5940_STREAM_FRAME *const frame,
+    uint32_t *const sample_count,
+    AD5940Err *const status
+)
+{
+    if(frame->type != AD5940_STREAM_FRAME_END) return AD5940ERR_PARA;
+    if(frame->payload_length != END_SIZE) return AD5940ERR_PARA;
+
+    *sample_count = AD5940_STREAM_get_u32(frame->payload, 0);
+    *status = (AD5940Err) AD5940_STREAM_get_u32(frame->payload, 1);
+
+    return AD5940ERR_OK;
+}
+
+uint32_t AD5940_STREAM_get_u32(
+    const uint8_t *const data,
+    const uint32_t index
+)
+{
+    const uint8_t *word = data + 4 * index;
+    return ((uint32_t) word[0])
+        | ((uint32_t) word[1] << 8)
+        | ((uint32_t) word[2] << 16)
+        | ((uint32_t) word[3] << 24);
+}
+
+float AD5940_STREAM_get_float(
+    const uint8_t *const data,
+    const uint32_t index
+)
+{
+    uint32_t bits = AD5940_STREAM_get_u32(data, index);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
@@ -0,0 +1,359 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "ad5940.h"
+#include "ad5940_utils_calibration.h"
+#include "ad5940_utils_compress.h"
+
+/**
+ * Version of the stream format.
+ * Bump it whenever the layout of a frame changes, frames of other versions are then rejected.
+ */
+#define AD5940_STREAM_VERSION 1
+
+/**
+ * Size of the frame header (in bytes): sync word, version, type, payload length and sequence counter.
+ */
+#define AD5940_STREAM_HEADER_SIZE 8
+
+/**
+ * Size of the CRC-32 closing every frame (in bytes), refer to @ref AD5940_crc32.
+ */
+#define AD5940_STREAM_CRC_SIZE 4
+
+/**
+ * Largest payload of a frame (in bytes), a multiple of 4.
+ */
+#define AD5940_STREAM_PAYLOAD_MAX 0xFFFC
+
+/**
+ * Largest number of FIFO words in one sample frame.
+ */
+#define AD5940_STREAM_SAMPLE_NUMBER_MAX ((AD5940_STREAM_PAYLOAD_MAX - 4) / 4)
+
+/**
+ * Largest number of FIFO words in one packed sample frame, whatever they compress to.
+ */
+#define AD5940_STREAM_PACKED_SAMPLE_NUMBER_MAX ((AD5940_STREAM_PAYLOAD_MAX - 8 - AD5940_COMPRESS_BOUND(0)) / 4)
+
+/**
+ * Largest number of technique parameters in a run header.
+ */
+#define AD5940_STREAM_PARAMETER_NUMBER_MAX 32
+
+/**
+ * Frame types.
+ *
+ * A stream is a run header followed by sample frames and closed by an end frame.
+ * Every frame is a multiple of 4 bytes and every field is little endian and 4-byte aligned,
+ * so a stream stored from an aligned address can be mapped and read in place.
+ */
+typedef enum
+{
+    AD5940_STREAM_FRAME_RUN = 1,        /**< Technique, conversion settings, technique parameters and calibration. */
+    AD5940_STREAM_FRAME_SAMPLES,        /**< Index of the first sample, then the FIFO words as read. */
+    AD5940_STREAM_FRAME_END,            /**< Number of samples of the run and final error code. */
+    AD5940_STREAM_FRAME_SAMPLES_PACKED, /**< Index of the first sample, block length, then the FIFO words compressed. */
+}
+AD5940_STREAM_FRAME_TYPE;
+
+/**
+ * Techniques tagged in the run header.
+ */
+typedef enum
+{
+    AD5940_STREAM_TECHNIQUE_NONE = 0,
+    AD5940_STREAM_TECHNIQUE_CA,
+    AD5940_STREAM_TECHNIQUE_CV,
+    AD5940_STREAM_TECHNIQUE_DPV,
+    AD5940_STREAM_TECHNIQUE_EIS,
+    AD5940_STREAM_TECHNIQUE_LSV,
+    AD5940_STREAM_TECHNIQUE_NPV,
+    AD5940_STREAM_TECHNIQUE_SWV,
+    AD5940_STREAM_TECHNIQUE_TEMPERATURE,
+}
+AD5940_STREAM_TECHNIQUE;
+
+/**
+ * Description of a run, written once at the start of a stream.
+ * The host needs it to turn the FIFO words into currents and potentials.
+ */
+typedef struct
+{
+    AD5940_STREAM_TECHNIQUE technique;          // Technique of the run.
+    uint32_t DataType;                          // Data type of the FIFO words. See @ref DATATYPE_Const.
+    uint32_t ADCPga;                            // ADC PGA gain. See @ref ADCPGA_Const.
+    float VRef;                                 // ADC reference voltage (in volts).
+    fImpPol_Type rtia;                          // RTIA calibration result of the TIA.
+    uint32_t sampling_number;                   // ADC captures per step, the step index of a current sample is its index divided by it.
+    const float *parameters;                    // Technique parameters, e.g. the fields of the parameter struct in order.
+    uint8_t parameter_number;                   // Number of technique parameters, up to @ref AD5940_STREAM_PARAMETER_NUMBER_MAX.
+    const AD5940_CalibrationRecord *calibration;    // Calibration of the run, or NULL.
+}
+AD5940_STREAM_RUN;
+
+/**
+ * Encoder state, one per stream.
+ */
+typedef struct
+{
+    uint16_t sequence;                          // Sequence counter of the next frame.
+    uint32_t sample_index;                      // Index of the next sample since the run header, lost samples included.
+}
+AD5940_STREAM_ENCODER;
+
+/**
+ * Frame found by @ref AD5940_STREAM_read_frame, pointing into the stream.
+ */
+typedef struct
+{
+    AD5940_STREAM_FRAME_TYPE type;              // Frame type.
+    uint16_t sequence;                          // Sequence counter, a gap tells lost frames.
+    const uint8_t *payload;                     // Payload, in the stream.
+    uint16_t payload_length;                    // Number of payload bytes.
+}
+AD5940_STREAM_FRAME;
+
+/**
+ * Run header decoded by @ref AD5940_STREAM_get_run, the parameters point into the stream.
+ */
+typedef struct
+{
+    AD5940_STREAM_TECHNIQUE technique;
+    uint32_t DataType;
+    uint32_t ADCPga;
+    float VRef;
+    fImpPol_Type rtia;
+    uint32_t sampling_number;
+    const uint8_t *parameters;                  // Technique parameters, read them with @ref AD5940_STREAM_get_float.
+    uint8_t parameter_number;
+    BoolFlag calibration_valid;                 // bTRUE when the run header holds a calibration record.
+    AD5940_CalibrationRecord calibration;       // Calibration of the run, if calibration_valid.
+}
+AD5940_STREAM_RUN_INFO;
+
+/**
+ * Starts a stream, the frame sequence counter and the sample index restart from zero.
+ *
+ * @param encoder               Encoder state.
+ */
+void AD5940_STREAM_ENCODER_init(
+    AD5940_STREAM_ENCODER *const encoder
+);
+
+/**
+ * Writes the run header frame.
+ *
+ * @param encoder               Encoder state.
+ * @param run                   Description of the run.
+ * @param buffer                Buffer to store the frame.
+ * @param buffer_length         Length of the buffer.
+ * @param length                Pointer to store the number of bytes written.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the frame does not fit in the buffer.
+ *                   - AD5940ERR_PARA if there are too many parameters.
+ */
+AD5940Err AD5940_STREAM_write_run(
+    AD5940_STREAM_ENCODER *const encoder,
+    const AD5940_STREAM_RUN *const run,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+);
+
+/**
+ * Writes a sample frame, e.g. with the FIFO words returned by @ref AD5940_irq_handler.
+ * The frame takes 12 bytes plus 4 bytes per FIFO word.
+ *
+ * @param encoder               Encoder state.
+ * @param fifo_data             FIFO words.
+ * @param sample_number         Number of FIFO words, up to @ref AD5940_STREAM_SAMPLE_NUMBER_MAX.
+ * @param buffer                Buffer to store the frame. It may not overlap fifo_data.
+ * @param buffer_length         Length of the buffer.
+ * @param length                Pointer to store the number of bytes written.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the frame does not fit in the buffer.
+ *                   - AD5940ERR_PARA if there are too many FIFO words.
+ */
+AD5940Err AD5940_STREAM_write_samples(
+    AD5940_STREAM_ENCODER *const encoder,
+    const uint32_t *const fifo_data,
+    const uint16_t sample_number,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+);
+
+/**
+ * Writes a packed sample frame, the FIFO words compressed by @ref AD5940_compress_fifo
+ * without their ECC bits. The frame takes at most 24 bytes plus 4 bytes per FIFO word,
+ * and typically 1 to 2 bytes per FIFO word for slowly varying signals. Each frame is
+ * compressed on its own, so a lost frame does not prevent decoding the next ones.
+ *
+ * @param encoder               Encoder state.
+ * @param fifo_data             FIFO words.
+ * @param sample_number         Number of FIFO words, up to @ref AD5940_STREAM_PACKED_SAMPLE_NUMBER_MAX.
+ * @param buffer                Buffer to store the frame. It may not overlap fifo_data.
+ * @param buffer_length         Length of the buffer.
+ * @param length                Pointer to store the number of bytes written.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the frame does not fit in the buffer.
+ *                   - AD5940ERR_PARA if there are too many FIFO words.
+ */
+AD5940Err AD5940_STREAM_write_packed_samples(
+    AD5940_STREAM_ENCODER *const encoder,
+    const uint32_t *const fifo_data,
+    const uint16_t sample_number,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+);
+
+/**
+ * Skips the index of samples lost before reaching the MCU, e.g. the `lost_sample_number`
+ * of @ref AD5940_irq_handler_monitor, after writing the samples read by the same interrupt.
+ * The next sample frame starts after the gap, which the host sees as a jump of the sample index.
+ *
+ * @param encoder               Encoder state.
+ * @param sample_number         Number of lost samples.
+ */
+void AD5940_STREAM_skip_samples(
+    AD5940_STREAM_ENCODER *const encoder,
+    const uint32_t sample_number
+);
+
+/**
+ * Writes the end frame.
+ *
+ * @param encoder               Encoder state.
+ * @param status                Final error code of the run.
+ * @param buffer                Buffer to store the frame.
+ * @param buffer_length         Length of the buffer.
+ * @param length                Pointer to store the number of bytes written.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the frame does not fit in the buffer.
+ */
+AD5940Err AD5940_STREAM_write_end(
+    AD5940_STREAM_ENCODER *const encoder,
+    const AD5940Err status,
+    uint8_t *const buffer,
+    const uint32_t buffer_length,
+    uint32_t *const length
+);
+
+/**
+ * Finds the frame at an offset of a stream and checks it, without copying the payload.
+ *
+ * @param stream                Stream, e.g. a mapped file.
+ * @param length                Number of bytes of the stream.
+ * @param offset                Offset of the frame, advanced to the next frame on success.
+ * @param frame                 Pointer to store the frame.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF at the end of the stream, or if the last frame is truncated.
+ *                   - AD5940ERR_PARA if there is no valid frame at the offset: skip a byte
+ *                     and read again to find the next frame.
+ */
+AD5940Err AD5940_STREAM_read_frame(
+    const uint8_t *const stream,
+    const uint32_t length,
+    uint32_t *const offset,
+    AD5940_STREAM_FRAME *const frame
+);
+
+/**
+ * Decodes a run header frame.
+ *
+ * @param frame                 Run header frame.
+ * @param run                   Pointer to store the run description.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_PARA if the frame is not a valid run header.
+ */
+AD5940Err AD5940_STREAM_get_run(
+    const AD5940_STREAM_FRAME *const frame,
+    AD5940_STREAM_RUN_INFO *const run
+);
+
+/**
+ * Locates the FIFO words of a sample frame.
+ *
+ * @param frame                 Sample frame.
+ * @param first_index           Pointer to store the index of the first sample since the run header.
+ * @param samples               Pointer to store the FIFO words in the stream, read them with @ref AD5940_STREAM_get_u32.
+ * @param sample_number         Pointer to store the number of FIFO words.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_PARA if the frame is not a sample frame.
+ */
+AD5940Err AD5940_STREAM_get_samples(
+    const AD5940_STREAM_FRAME *const frame,
+    uint32_t *const first_index,
+    const uint8_t **const samples,
+    uint16_t *const sample_number
+);
+
+/**
+ * Decompresses the FIFO words of a packed sample frame.
+ *
+ * @param frame                 Packed sample frame.
+ * @param first_index           Pointer to store the index of the first sample since the run header.
+ * @param fifo_data             Buffer to store the FIFO words, the ECC bits are zero.
+ * @param fifo_max_length       Length of the FIFO buffer (in words).
+ * @param sample_number         Pointer to store the number of FIFO words.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_BUFF if the words do not fit in the FIFO buffer.
+ *                   - AD5940ERR_PARA if the frame is not a valid packed sample frame.
+ */
+AD5940Err AD5940_STREAM_get_packed_samples(
+    const AD5940_STREAM_FRAME *const frame,
+    uint32_t *const first_index,
+    uint32_t *const fifo_data,
+    const uint32_t fifo_max_length,
+    uint16_t *const sample_number
+);
+
+/**
+ * Decodes an end frame.
+ *
+ * @param frame                 End frame.
+ * @param sample_count          Pointer to store the number of samples of the run.
+ * @param status                Pointer to store the final error code of the run.
+ *
+ * @return AD5940Err Error code indicating the success or failure of the operation:
+ *                   - AD5940ERR_PARA if the frame is not an end frame.
+ */
+AD5940Err AD5940_STREAM_get_end(
+    const AD5940_STREAM_FRAME *const frame,
+    uint32_t *const sample_count,
+    AD5940Err *const status
+);
+
+/**
+ * Reads the i-th little endian 32-bit word of a payload, whatever the host byte order.
+ */
+uint32_t AD5940_STREAM_get_u32(
+    const uint8_t *const data,
+    const uint32_t index
+);
+
+/**
+ * Reads the i-th little endian float of a payload, whatever the host byte order.
+ */
+float AD5940_STREAM_get_float(
+    const uint8_t *const data,
+    const uint32_t index
+);
+
+#ifdef __cplusplus
+}
+#endif